@@ -1,8 +1,77 @@
 #include "FileData.h"
 #include "SystemData.h"
+#include "ThreadPool.h"
+#include "Util.h"
 
 namespace fs = boost::filesystem;
 
+// folders smaller than this aren't worth handing to the thread pool
+#define PARALLEL_SORT_MIN_FILES 4096
+
+// Seconds since the epoch for an ISO time as written by MetaDataList::setTime(), 0 if never played.
+// Much cheaper than MetaDataList::getTime(), which goes through a stringstream and time facet.
+static time_t parseLastPlayed(const std::string& str)
+{
+	int year, month, day, hour, minute, second;
+	if(str.size() >= 15 && sscanf(str.c_str(), "%4d%2d%2dT%2d%2d%2d", &year, &month, &day, &hour, &minute, &second) == 6)
+	{
+		try
+		{
+			boost::posix_time::ptime time(boost::gregorian::date(year, month, day), boost::posix_time::time_duration(hour, minute, second));
+			return (time_t)(time - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_seconds();
+		} catch(std::exception&)
+		{
+			// invalid date, treat as never played
+		}
+	}
+
+	return 0;
+}
+
+// Stable sorts one run per thread, then merges neighbouring runs until one is left.
+// Every merge within a round touches its own range, so those run in parallel too.
+template<typename Compare>
+static void parallelStableSort(std::vector<FileData*>& files, Compare& compare)
+{
+	ThreadPool* pool = ThreadPool::getInstance();
+	const size_t runs = pool->getThreadCount() + 1;
+
+	std::vector<size_t> bounds;
+	for(size_t i = 0; i <= runs; i++)
+		bounds.push_back(files.size() * i / runs);
+
+	std::vector< std::function<void()> > jobs;
+	for(size_t i = 0; i < runs; i++)
+	{
+		auto first = files.begin() + bounds[i];
+		auto last = files.begin() + bounds[i + 1];
+		jobs.push_back([first, last, &compare] { std::stable_sort(first, last, compare); });
+	}
+	pool->run(jobs);
+
+	while(bounds.size() > 2)
+	{
+		std::vector<size_t> merged;
+		jobs.clear();
+		for(size_t i = 0; i + 2 < bounds.size(); i += 2)
+		{
+			auto first = files.begin() + bounds[i];
+			auto middle = files.begin() + bounds[i + 1];
+			auto last = files.begin() + bounds[i + 2];
+			jobs.push_back([first, middle, last, &compare] { std::inplace_merge(first, middle, last, compare); });
+			merged.push_back(bounds[i]);
+		}
+
+		// an odd run out waits for the next round
+		if((bounds.size() - 1) % 2 == 1)
+			merged.push_back(bounds[bounds.size() - 2]);
+		merged.push_back(bounds.back());
+
+		pool->run(jobs);
+		bounds.swap(merged);
+	}
+}
+
 std::string removeParenthesis(const std::string& str)
 {
 	// remove anything in parenthesis or brackets
@@ -42,13 +111,37 @@ std::string removeParenthesis(const std::string& str)
 	return ret;
 }
 
+FileCounts& FileCounts::operator+=(const FileCounts& other)
+{
+	games += other.games;
+	folders += other.folders;
+	videos += other.videos;
+	thumbnails += other.thumbnails;
+	marquees += other.marquees;
+	playCount += other.playCount;
+	return *this;
+}
+
+FileCounts& FileCounts::operator-=(const FileCounts& other)
+{
+	games -= other.games;
+	folders -= other.folders;
+	videos -= other.videos;
+	thumbnails -= other.thumbnails;
+	marquees -= other.marquees;
+	playCount -= other.playCount;
+	return *this;
+}
 
 FileData::FileData(FileType type, const fs::path& path, SystemData* system)
-	: mType(type), mPath(path), mSystem(system), mParent(NULL), metadata(type == GAME ? GAME_METADATA : FOLDER_METADATA) // metadata is REALLY set in the constructor!
+	: mType(type), mPath(path), mSystem(system), mParent(NULL), mSortKeysValid(false), metadata(type == GAME ? GAME_METADATA : FOLDER_METADATA) // metadata is REALLY set in the constructor!
 {
 	// metadata needs at least a name field (since that's what getName() will return)
 	if(metadata.get("name").empty())
 		metadata.set("name", getDisplayName());
+
+	mOwnCounts = getOwnCounts();
+	metadata.setChangedCallback([this] { onMetaDataChanged(); });
 }
 
 FileData::~FileData()
@@ -62,7 +155,7 @@ FileData::~FileData()
 std::string FileData::getDisplayName() const
 {
 	std::string stem = mPath.stem().generic_string();
-	if(mSystem && mSystem->hasPlatformId(PlatformIds::ARCADE) || mSystem->hasPlatformId(PlatformIds::NEOGEO))
+	if(mSystem && (mSystem->hasPlatformId(PlatformIds::ARCADE) || mSystem->hasPlatformId(PlatformIds::NEOGEO)))
 		stem = PlatformIds::getCleanMameName(stem.c_str());
 
 	return stem;
@@ -127,6 +220,44 @@ std::vector<FileData*> FileData::getFilesRecursive(unsigned int typeMask) const
 	return out;
 }
 
+FileCounts FileData::getOwnCounts() const
+{
+	FileCounts counts;
+	if(mType == GAME)
+	{
+		counts.games = 1;
+		counts.playCount = metadata.getType() == GAME_METADATA ? metadata.getInt("playcount") : 0;
+	}else{
+		counts.folders = 1;
+	}
+
+	counts.videos = getVideoPath().empty() ? 0 : 1;
+	counts.thumbnails = getThumbnailPath().empty() ? 0 : 1;
+	counts.marquees = getMarqueePath().empty() ? 0 : 1;
+	return counts;
+}
+
+void FileData::onMetaDataChanged()
+{
+	FileCounts counts = getOwnCounts();
+	if(mParent)
+		mParent->updateCounts(mOwnCounts, counts);
+	mOwnCounts = counts;
+	mSortKeysValid = false;
+
+	if(mSystem)
+		mSystem->onFileChanged(this, FILE_METADATA_CHANGED);
+}
+
+void FileData::updateCounts(const FileCounts& removed, const FileCounts& added)
+{
+	for(FileData* folder = this; folder != NULL; folder = folder->mParent)
+	{
+		folder->mCounts -= removed;
+		folder->mCounts += added;
+	}
+}
+
 void FileData::addChild(FileData* file)
 {
 	assert(mType == FOLDER);
@@ -138,6 +269,13 @@ void FileData::addChild(FileData* file)
 		mChildrenByFilename[key] = file;
 		mChildren.push_back(file);
 		file->mParent = this;
+
+		FileCounts added = file->mCounts;
+		added += file->mOwnCounts;
+		updateCounts(FileCounts(), added);
+
+		if(mSystem)
+			mSystem->onFileChanged(file, FILE_ADDED);
 	}
 }
 
@@ -146,11 +284,20 @@ void FileData::removeChild(FileData* file)
 	assert(mType == FOLDER);
 	assert(file->getParent() == this);
 	mChildrenByFilename.erase(file->getPath().filename().string());
-	for(auto it = mChildren.begin(); it != mChildren.end(); it++)
+
+	// searched from the back, so emptying a folder from its last child on isn't quadratic
+	for(auto it = mChildren.rbegin(); it != mChildren.rend(); it++)
 	{
 		if(*it == file)
 		{
-			mChildren.erase(it);
+			mChildren.erase(std::next(it).base());
+
+			FileCounts removed = file->mCounts;
+			removed += file->mOwnCounts;
+			updateCounts(removed, FileCounts());
+
+			if(mSystem)
+				mSystem->onFileChanged(file, FILE_REMOVED);
 			return;
 		}
 	}
@@ -162,19 +309,54 @@ void FileData::removeChild(FileData* file)
 
 void FileData::sort(ComparisonFunction& comparator, bool ascending)
 {
-	std::sort(mChildren.begin(), mChildren.end(), comparator);
+	// the comparator may run on several threads below, so build any stale keys now
+	for(auto it = mChildren.begin(); it != mChildren.end(); it++)
+		(*it)->getSortKeys();
+
+	// only the comparator's key is reversed for descending sorts, ties stay in name order
+	auto compare = [&comparator, ascending](const FileData* a, const FileData* b) -> bool {
+		if(comparator(a, b))
+			return ascending;
+		if(comparator(b, a))
+			return !ascending;
+		return a->getSortKeys().name < b->getSortKeys().name;
+	};
+
+	if(mChildren.size() < PARALLEL_SORT_MIN_FILES)
+		std::stable_sort(mChildren.begin(), mChildren.end(), compare);
+	else
+		parallelStableSort(mChildren, compare);
 
 	for(auto it = mChildren.begin(); it != mChildren.end(); it++)
 	{
 		if((*it)->getChildren().size() > 0)
 			(*it)->sort(comparator, ascending);
 	}
-
-	if(!ascending)
-		std::reverse(mChildren.begin(), mChildren.end());
 }
 
 void FileData::sort(const SortType& type)
 {
 	sort(*type.comparisonFunction, type.ascending);
 }
+
+const FileSortKeys& FileData::getSortKeys() const
+{
+	if(!mSortKeysValid)
+	{
+		mSortKeys = FileSortKeys();
+		mSortKeys.name = strToUpper(getName());
+
+		// only games have rating/playcount/lastplayed metadata
+		if(metadata.getType() == GAME_METADATA)
+		{
+			mSortKeys.rating = metadata.getFloat("rating");
+			mSortKeys.playCount = metadata.getInt("playcount");
+
+			mSortKeys.lastPlayed = parseLastPlayed(metadata.get("lastplayed"));
+		}
+
+		mSortKeysValid = true;
+	}
+
+	return mSortKeys;
+}
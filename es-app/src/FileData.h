@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <string>
 #include <vector>
+#include <ctime>
 #include <boost/filesystem.hpp>
 #include "MetaData.h"
 
@@ -22,6 +23,33 @@ enum FileChangeType
 	FILE_SORTED
 };
 
+// Totals over the files below a folder, see FileData::getCounts().
+struct FileCounts
+{
+	unsigned int games;
+	unsigned int folders;
+	unsigned int videos; // files with a video
+	unsigned int thumbnails; // files with a thumbnail or image
+	unsigned int marquees; // files with a marquee
+	unsigned int playCount; // sum of all the games' play counts
+
+	FileCounts() : games(0), folders(0), videos(0), thumbnails(0), marquees(0), playCount(0) {}
+
+	FileCounts& operator+=(const FileCounts& other);
+	FileCounts& operator-=(const FileCounts& other);
+};
+
+// Normalized values the sorts compare, see FileData::getSortKeys().
+struct FileSortKeys
+{
+	std::string name; // upper cased, compared bytewise
+	float rating;
+	int playCount;
+	time_t lastPlayed; // 0 if never played
+
+	FileSortKeys() : rating(0), playCount(0), lastPlayed(0) {}
+};
+
 // Used for loading/saving gamelist.xml.
 const char* fileTypeToString(FileType type);
 FileType stringToFileType(const char* str);
@@ -50,6 +78,10 @@ public:
 
 	std::vector<FileData*> getFilesRecursive(unsigned int typeMask) const;
 
+	// Totals for everything below this folder (not including itself). These are kept up to
+	// date as files are added, removed or have their metadata changed, so reading them is O(1).
+	inline const FileCounts& getCounts() const { return mCounts; }
+
 	void addChild(FileData* file); // Error if mType != FOLDER
 	void removeChild(FileData* file); //Error if mType != FOLDER
 
@@ -70,16 +102,30 @@ public:
 			: comparisonFunction(sortFunction), ascending(sortAscending), description(sortDescription) {}
 	};
 
+	// Stable sort of our children and all folders below us. Files the comparator considers equal
+	// are ordered by name, and keep their current order if those are equal too.
 	void sort(ComparisonFunction& comparator, bool ascending = true);
 	void sort(const SortType& type);
 
+	// Parsed once and cached until the metadata changes again, so comparators don't have to.
+	// Building stale keys isn't thread safe, sort() does that before sorting on several threads.
+	const FileSortKeys& getSortKeys() const;
+
 	MetaDataList metadata;
 
 private:
+	FileCounts getOwnCounts() const;
+	void onMetaDataChanged();
+	void updateCounts(const FileCounts& removed, const FileCounts& added); // applies to us and all our parents
+
 	FileType mType;
 	boost::filesystem::path mPath;
 	SystemData* mSystem;
 	FileData* mParent;
 	std::unordered_map<std::string,FileData*> mChildrenByFilename;
 	std::vector<FileData*> mChildren;
+	FileCounts mOwnCounts; // what this file itself adds to its parents' counts
+	FileCounts mCounts;
+	mutable FileSortKeys mSortKeys;
+	mutable bool mSortKeysValid;
 };
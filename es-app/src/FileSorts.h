@@ -11,4 +11,8 @@ namespace FileSorts
 	bool compareLastPlayed(const FileData* file1, const FileData* file2);
 
 	extern const std::vector<FileData::SortType> SortTypes;
+
+	// Times every sort type on count made up games, old comparators against cached sort keys,
+	// and prints the results. In FileSortsBenchmark.cpp.
+	void benchmark(unsigned int count);
 };
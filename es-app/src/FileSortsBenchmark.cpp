@@ -0,0 +1,120 @@
+#include "FileSorts.h"
+#include "ThreadPool.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// --benchmark-sort, kept out of FileSorts.cpp so the old comparators it measures against don't sit with the real ones
+
+namespace FileSorts
+{
+	// The comparators as they were before sort keys, reading the metadata on every comparison.
+	namespace Uncached
+	{
+		bool compareFileName(const FileData* file1, const FileData* file2)
+		{
+			std::string name1 = file1->getName();
+			std::string name2 = file2->getName();
+
+			unsigned int count = name1.length() > name2.length() ? name2.length() : name1.length();
+			for(unsigned int i = 0; i < count; i++)
+			{
+				if(toupper(name1[i]) != toupper(name2[i]))
+					return toupper(name1[i]) < toupper(name2[i]);
+			}
+
+			return name1.length() < name2.length();
+		}
+
+		bool compareRating(const FileData* file1, const FileData* file2)
+		{
+			return file1->metadata.getFloat("rating") < file2->metadata.getFloat("rating");
+		}
+
+		bool compareTimesPlayed(const FileData* file1, const FileData* file2)
+		{
+			return file1->metadata.getInt("playcount") < file2->metadata.getInt("playcount");
+		}
+
+		bool compareLastPlayed(const FileData* file1, const FileData* file2)
+		{
+			return file1->metadata.getTime("lastplayed") < file2->metadata.getTime("lastplayed");
+		}
+
+		FileData::ComparisonFunction* get(FileData::ComparisonFunction* cached)
+		{
+			if(cached == &FileSorts::compareRating)
+				return &compareRating;
+			if(cached == &FileSorts::compareTimesPlayed)
+				return &compareTimesPlayed;
+			if(cached == &FileSorts::compareLastPlayed)
+				return &compareLastPlayed;
+			return &compareFileName;
+		}
+	}
+
+	void benchmark(unsigned int count)
+	{
+		// one folder of made up games, all with different metadata
+		FileData root(FOLDER, "/benchmark", NULL);
+		std::vector<FileData*> games;
+		srand(1);
+		for(unsigned int i = 0; i < count; i++)
+		{
+			std::stringstream name;
+			name << (char)('a' + rand() % 26) << (char)('A' + rand() % 26) << " game " << rand();
+
+			FileData* game = new FileData(GAME, "/benchmark/" + std::to_string(i) + ".rom", NULL);
+			game->metadata.set("name", name.str());
+			game->metadata.set("rating", std::to_string((rand() % 11) / 10.0f));
+			game->metadata.set("playcount", std::to_string(rand() % 50));
+			if(rand() % 2)
+				game->metadata.setTime("lastplayed", boost::posix_time::from_time_t(1400000000 + rand() % 100000000));
+			root.addChild(game);
+			games.push_back(game);
+		}
+
+		typedef std::chrono::high_resolution_clock Clock;
+		auto ms = [](const Clock::time_point& start) { return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0f; };
+
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(2);
+		ss << "Sorting " << count << " games (" << ThreadPool::getInstance()->getThreadCount() + 1 << " threads):\n";
+		for(unsigned int i = 0; i < SortTypes.size(); i++)
+		{
+			const FileData::SortType& type = SortTypes.at(i);
+
+			// the old way: std::sort with comparators parsing metadata, then reversing for descending
+			std::vector<FileData*> files(games);
+			auto start = Clock::now();
+			std::sort(files.begin(), files.end(), Uncached::get(type.comparisonFunction));
+			if(!type.ascending)
+				std::reverse(files.begin(), files.end());
+			const float uncached = ms(start);
+
+			// first sort after the metadata changed has to build the keys too
+			for(auto it = games.begin(); it != games.end(); it++)
+				(*it)->metadata.set("name", (*it)->getName() + " ");
+			start = Clock::now();
+			root.sort(type);
+			const float cold = ms(start);
+
+			start = Clock::now();
+			root.sort(type);
+			const float cached = ms(start);
+
+			ss << "  " << std::setw(24) << std::left << type.description << std::right
+				<< " uncached " << std::setw(8) << uncached << "ms, keys built " << std::setw(8) << cold << "ms, keys cached " << std::setw(8) << cached << "ms\n";
+		}
+
+		std::cout << ss.str();
+		LOG(LogInfo) << ss.str();
+
+		// back to front, so each one is at the end of the root's children when it removes itself
+		while(!root.getChildren().empty())
+			delete root.getChildren().back();
+	}
+};
@@ -0,0 +1,319 @@
+#include "GameSearchIndex.h"
+#include "FileData.h"
+#include "Log.h"
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+
+// don't bother rebuilding the key lists for only a few removed games
+#define SEARCH_REBUILD_MIN_DEAD 256
+
+static inline unsigned int trigramKey(const char* str)
+{
+	return ((unsigned char)str[0] << 16) | ((unsigned char)str[1] << 8) | (unsigned char)str[2];
+}
+
+// the first one or two characters of a word, kept above the 24 bits used by trigrams
+static inline unsigned int prefixKey(const char* str, size_t len)
+{
+	return ((unsigned int)len << 24) | ((unsigned char)str[0] << 8) | (len > 1 ? (unsigned char)str[1] : 0);
+}
+
+// calls func(word, length) for every word of normalized text
+template<typename Func>
+static void forEachWord(const std::string& text, Func func)
+{
+	size_t start = 0;
+	while(start < text.size())
+	{
+		size_t end = text.find(' ', start);
+		if(end == std::string::npos)
+			end = text.size();
+
+		func(text.data() + start, end - start);
+		start = end + 1;
+	}
+}
+
+// 0 if a word of text starts with word, 1 if word is only found inside a word of text, 2 if not found
+static int matchRank(const std::string& text, const std::string& word)
+{
+	int rank = 2;
+	for(size_t pos = text.find(word); pos != std::string::npos; pos = text.find(word, pos + 1))
+	{
+		if(pos == 0 || text[pos - 1] == ' ')
+			return 0;
+
+		rank = 1;
+	}
+
+	return rank;
+}
+
+static void appendField(std::string& fields, const std::string& value)
+{
+	// every unscraped game would match "unknown" otherwise
+	if(value.empty() || value == "unknown")
+		return;
+
+	fields += ' ';
+	fields += value;
+}
+
+GameSearchIndex::GameSearchIndex(FileData* root) : mDeadCount(0)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	add(root);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	LOG(LogDebug) << "Search index of " << mEntryIds.size() << " games with " << mKeys.size() << " keys built in "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0f << "ms";
+}
+
+std::string GameSearchIndex::normalize(const std::string& str)
+{
+	std::string out;
+	out.reserve(str.size());
+
+	bool separated = true; // no leading space
+	for(auto it = str.begin(); it != str.end(); it++)
+	{
+		unsigned char c = (unsigned char)*it;
+		if(c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+
+		// multi-byte UTF-8 sequences are kept as they are
+		if((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80)
+		{
+			out += (char)c;
+			separated = false;
+		}else if(!separated)
+		{
+			out += ' ';
+			separated = true;
+		}
+	}
+
+	if(!out.empty() && out.back() == ' ')
+		out.erase(out.size() - 1);
+
+	return out;
+}
+
+void GameSearchIndex::add(FileData* file)
+{
+	if(file->getType() == FOLDER)
+	{
+		std::vector<FileData*> games = file->getFilesRecursive(GAME);
+		for(auto it = games.begin(); it != games.end(); it++)
+		{
+			if(mEntryIds.find(*it) == mEntryIds.end())
+				index(*it);
+		}
+	}else if(mEntryIds.find(file) == mEntryIds.end())
+	{
+		index(file);
+	}
+}
+
+void GameSearchIndex::remove(FileData* file)
+{
+	if(file->getType() == FOLDER)
+	{
+		std::vector<FileData*> games = file->getFilesRecursive(GAME);
+		for(auto it = games.begin(); it != games.end(); it++)
+		{
+			unindex(*it);
+			mStale.erase(*it);
+		}
+	}else{
+		unindex(file);
+		mStale.erase(file);
+	}
+}
+
+void GameSearchIndex::invalidate(FileData* file)
+{
+	if(mEntryIds.find(file) != mEntryIds.end())
+		mStale.insert(file);
+}
+
+void GameSearchIndex::index(FileData* game)
+{
+	const unsigned int id = (unsigned int)mEntries.size();
+
+	std::string fields;
+	appendField(fields, game->metadata.get("developer"));
+	appendField(fields, game->metadata.get("publisher"));
+	appendField(fields, game->metadata.get("genre"));
+
+	Entry entry;
+	entry.file = game;
+	entry.name = normalize(game->getName());
+	entry.fields = normalize(fields);
+	entry.alive = true;
+
+	addKeys(entry.name, id);
+	addKeys(entry.fields, id);
+
+	mEntryIds[game] = id;
+	mEntries.push_back(entry);
+}
+
+void GameSearchIndex::unindex(FileData* game)
+{
+	auto it = mEntryIds.find(game);
+	if(it == mEntryIds.end())
+		return;
+
+	// the id stays in the key lists, search() skips dead entries
+	mEntries[it->second].alive = false;
+	mEntryIds.erase(it);
+	mDeadCount++;
+}
+
+void GameSearchIndex::addKeys(const std::string& text, unsigned int id)
+{
+	forEachWord(text, [this, id](const char* word, size_t len) {
+		std::vector<unsigned int> keys;
+		keys.push_back(prefixKey(word, 1));
+		if(len > 1)
+			keys.push_back(prefixKey(word, 2));
+		for(size_t i = 0; i + 2 < len; i++)
+			keys.push_back(trigramKey(word + i));
+
+		// ids only ever grow, so the lists stay sorted and duplicates can only be at the back
+		for(auto it = keys.begin(); it != keys.end(); it++)
+		{
+			std::vector<unsigned int>& ids = mKeys[*it];
+			if(ids.empty() || ids.back() != id)
+				ids.push_back(id);
+		}
+	});
+}
+
+void GameSearchIndex::refresh()
+{
+	for(auto it = mStale.begin(); it != mStale.end(); it++)
+	{
+		unindex(*it);
+		index(*it);
+	}
+	mStale.clear();
+
+	if(mDeadCount < SEARCH_REBUILD_MIN_DEAD || mDeadCount < mEntries.size() / 2)
+		return;
+
+	std::vector<Entry> entries;
+	entries.swap(mEntries);
+	mEntryIds.clear();
+	mKeys.clear();
+	mDeadCount = 0;
+
+	for(auto it = entries.begin(); it != entries.end(); it++)
+	{
+		if(it->alive)
+			index(it->file);
+	}
+}
+
+std::vector<FileData*> GameSearchIndex::search(const std::string& query, size_t maxResults)
+{
+	refresh();
+
+	const std::string normalized = normalize(query);
+	std::vector<std::string> words;
+	forEachWord(normalized, [&words](const char* word, size_t len) { words.push_back(std::string(word, len)); });
+
+	std::vector<FileData*> results;
+	if(words.empty() || maxResults == 0)
+		return results;
+
+	// short words can only be looked up by prefix, longer ones by all of their trigrams
+	std::vector<const std::vector<unsigned int>*> lists;
+	for(auto word = words.begin(); word != words.end(); word++)
+	{
+		std::vector<unsigned int> keys;
+		if(word->size() < 3)
+		{
+			keys.push_back(prefixKey(word->data(), word->size()));
+		}else{
+			for(size_t i = 0; i + 2 < word->size(); i++)
+				keys.push_back(trigramKey(word->data() + i));
+		}
+
+		for(auto key = keys.begin(); key != keys.end(); key++)
+		{
+			auto it = mKeys.find(*key);
+			if(it == mKeys.end())
+				return results;
+
+			lists.push_back(&it->second);
+		}
+	}
+
+	// intersecting the shortest lists first keeps the working set small
+	std::sort(lists.begin(), lists.end(), [](const std::vector<unsigned int>* a, const std::vector<unsigned int>* b) { return a->size() < b->size(); });
+
+	std::vector<unsigned int> candidates(*lists.front());
+	std::vector<unsigned int> merged;
+	for(size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+	{
+		merged.clear();
+		std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(merged));
+		candidates.swap(merged);
+	}
+
+	struct Match
+	{
+		const Entry* entry;
+		bool prefix; // name starts with the whole query
+		int rank; // sum of the words' ranks
+	};
+
+	// having all the trigrams of a word doesn't mean having the word, so check what's left
+	std::vector<Match> matches;
+	for(auto id = candidates.begin(); id != candidates.end(); id++)
+	{
+		const Entry& entry = mEntries[*id];
+		if(!entry.alive)
+			continue;
+
+		Match match;
+		match.entry = &entry;
+		match.prefix = entry.name.compare(0, normalized.size(), normalized) == 0;
+		match.rank = 0;
+
+		bool found = true;
+		for(auto word = words.begin(); word != words.end() && found; word++)
+		{
+			int rank = matchRank(entry.name, *word);
+			if(rank == 2)
+			{
+				rank += matchRank(entry.fields, *word);
+				found = rank < 4;
+			}
+			match.rank += rank;
+		}
+
+		if(found)
+			matches.push_back(match);
+	}
+
+	const size_t count = std::min(maxResults, matches.size());
+	std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), [](const Match& a, const Match& b) {
+		if(a.prefix != b.prefix)
+			return a.prefix;
+		if(a.rank != b.rank)
+			return a.rank < b.rank;
+		if(a.entry->name.size() != b.entry->name.size())
+			return a.entry->name.size() < b.entry->name.size();
+		return a.entry->name < b.entry->name;
+	});
+
+	results.reserve(count);
+	for(size_t i = 0; i < count; i++)
+		results.push_back(matches[i].entry->file);
+
+	return results;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+class FileData;
+
+// Trigram/prefix index over the games of one system, used to filter the gamelist while typing.
+// Every word of a game's name, developer, publisher and genre adds its trigrams and its first
+// one and two characters as keys, so a query only has to intersect a few sorted id lists and
+// check the handful of candidates left instead of scanning every game.
+//
+// The index is built on first use by SystemData::getSearchIndex() and kept up to date through
+// SystemData::onFileChanged(). Removed games only have their entry marked dead; the lists are
+// rebuilt once enough dead entries pile up.
+class GameSearchIndex
+{
+public:
+	GameSearchIndex(FileData* root);
+
+	// file may be a folder, in which case every game below it is added/removed.
+	void add(FileData* file);
+	void remove(FileData* file);
+
+	// Metadata of file changed. Re-indexing is deferred to the next search, so scraping
+	// (which sets many fields one by one) doesn't rebuild the entry over and over.
+	void invalidate(FileData* file);
+
+	// Games matching every word of query, best matches first: name starting with the query,
+	// then words of the name starting with the query's words, then substrings of the name,
+	// then matches in developer/publisher/genre only.
+	std::vector<FileData*> search(const std::string& query, size_t maxResults);
+
+	inline size_t size() const { return mEntryIds.size(); }
+
+	// Lower case ASCII, anything else that isn't a letter or digit becomes a single space.
+	static std::string normalize(const std::string& str);
+
+private:
+	struct Entry
+	{
+		FileData* file;
+		std::string name; // normalized
+		std::string fields; // normalized developer, publisher and genre
+		bool alive;
+	};
+
+	void index(FileData* game);
+	void unindex(FileData* game);
+	void addKeys(const std::string& text, unsigned int id);
+	void refresh(); // applies pending invalidations and drops dead entries if there are many
+
+	std::vector<Entry> mEntries; // id -> entry
+	std::unordered_map<const FileData*, unsigned int> mEntryIds;
+	std::unordered_map<unsigned int, std::vector<unsigned int>> mKeys; // key -> sorted ids
+	std::unordered_set<FileData*> mStale;
+	size_t mDeadCount;
+};
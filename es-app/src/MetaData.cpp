@@ -56,6 +56,22 @@ MetaDataList::MetaDataList(MetaDataListType type)
 		set(iter->key, iter->defaultValue);
 }
 
+MetaDataList::MetaDataList(const MetaDataList& other)
+	: mType(other.mType), mMap(other.mMap), mWasChanged(other.mWasChanged)
+{
+}
+
+MetaDataList& MetaDataList::operator=(const MetaDataList& other)
+{
+	mType = other.mType;
+	mMap = other.mMap;
+	mWasChanged = other.mWasChanged;
+
+	if(mChangedCallback)
+		mChangedCallback();
+
+	return *this;
+}
 
 MetaDataList MetaDataList::createFromXML(MetaDataListType type, pugi::xml_node node, const fs::path& relativeTo)
 {
@@ -111,6 +127,9 @@ void MetaDataList::set(const std::string& key, const std::string& value)
 {
 	mMap[key] = value;
 	mWasChanged = true;
+
+	if(mChangedCallback)
+		mChangedCallback();
 }
 
 void MetaDataList::setTime(const std::string& key, const boost::posix_time::ptime& time)
@@ -3,6 +3,7 @@
 #include "pugixml/pugixml.hpp"
 #include <string>
 #include <map>
+#include <functional>
 #include "GuiComponent.h"
 #include <boost/date_time.hpp>
 #include <boost/filesystem.hpp>
@@ -47,6 +48,12 @@ public:
 	void appendToXML(pugi::xml_node parent, bool ignoreDefaults, const boost::filesystem::path& relativeTo) const;
 
 	MetaDataList(MetaDataListType type);
+
+	// The changed callback belongs to the list's owner, so it is never copied from another list.
+	// Assigning a new list counts as a change.
+	MetaDataList(const MetaDataList& other);
+	MetaDataList& operator=(const MetaDataList& other);
+	inline void setChangedCallback(const std::function<void()>& func) { mChangedCallback = func; }
 	
 	void set(const std::string& key, const std::string& value);
 	void setTime(const std::string& key, const boost::posix_time::ptime& time); //times are internally stored as ISO strings (e.g. boost::posix_time::to_iso_string(ptime))
@@ -68,4 +75,5 @@ private:
 	MetaDataListType mType;
 	std::map<std::string, std::string> mMap;
 	bool mWasChanged;
+	std::function<void()> mChangedCallback;
 };
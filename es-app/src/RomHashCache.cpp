@@ -0,0 +1,390 @@
+#include "RomHashCache.h"
+#include "Hash.h"
+#include "Log.h"
+#include "ThreadPool.h"
+#include "platform.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+// how much of a file is mapped at once, small enough for a 32 bit address space
+#define HASH_MAP_SIZE (64 * 1024 * 1024)
+// each hash is fed this much at a time, so the data is still in the CPU cache for the next one
+#define HASH_BLOCK_SIZE (256 * 1024)
+// zip end of central directory record, plus the longest comment it can have
+#define ZIP_EOCD_SIZE 22
+#define ZIP_EOCD_SEARCH (ZIP_EOCD_SIZE + 0xFFFF)
+// don't read absurd central directories from broken zips
+#define ZIP_MAX_DIRECTORY_SIZE (16 * 1024 * 1024)
+
+RomHashCache* RomHashCache::getInstance()
+{
+	// Local DAT searches on the thread pool may be the first to get here, a function static is only ever created once
+	static RomHashCache* instance = new RomHashCache();
+	return instance;
+}
+
+RomHashCache::RomHashCache() : mPath(getHomePath() + "/.emulationstation/rom_hashes.txt"), mDirty(false)
+{
+	load();
+}
+
+// All three hashes in one pass over the data.
+struct RomHasher
+{
+	Crc32 crc32;
+	Md5 md5;
+	Sha1 sha1;
+
+	void update(const unsigned char* data, size_t size)
+	{
+		for(size_t offset = 0; offset < size; offset += HASH_BLOCK_SIZE)
+		{
+			const size_t length = std::min((size_t)HASH_BLOCK_SIZE, size - offset);
+			crc32.update(data + offset, length);
+			md5.update(data + offset, length);
+			sha1.update(data + offset, length);
+		}
+	}
+};
+
+static bool hashStream(const std::string& path, RomHasher& hasher)
+{
+	std::ifstream file(path, std::ios::binary);
+	if(!file)
+		return false;
+
+	std::vector<char> buffer(HASH_BLOCK_SIZE);
+	while(file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+		hasher.update((const unsigned char*)buffer.data(), (size_t)file.gcount());
+
+	return file.eof();
+}
+
+static bool hashContents(const std::string& path, uint64_t size, RomHasher& hasher)
+{
+#ifdef WIN32
+	return hashStream(path, hasher);
+#else
+	// mapping saves copying every byte into a buffer first
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+
+	// reading past the end of a mapping is fatal, so go by what the open file says
+	struct stat info;
+	if(fstat(fd, &info) != 0 || (uint64_t)info.st_size != size)
+	{
+		close(fd);
+		return false;
+	}
+
+	for(uint64_t offset = 0; offset < size; offset += HASH_MAP_SIZE)
+	{
+		const size_t length = (size_t)std::min((uint64_t)HASH_MAP_SIZE, size - offset);
+		void* data = (offset <= (uint64_t)std::numeric_limits<off_t>::max()) ? mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, (off_t)offset) : MAP_FAILED;
+		if(data == MAP_FAILED)
+		{
+			// e.g. a file over 2GB without a 64 bit off_t, start again the slow way
+			close(fd);
+			hasher = RomHasher();
+			return hashStream(path, hasher);
+		}
+
+		madvise(data, length, MADV_SEQUENTIAL);
+		hasher.update((const unsigned char*)data, length);
+		munmap(data, length);
+	}
+
+	close(fd);
+	return true;
+#endif
+}
+
+static inline uint16_t readLE16(const unsigned char* p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t readLE32(const unsigned char* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Lists the files in a zip from its central directory. Zip64 archives aren't supported.
+static bool readZipMembers(const std::string& path, uint64_t size, std::vector<RomArchiveMember>& members)
+{
+	if(size < ZIP_EOCD_SIZE)
+		return false;
+
+	std::ifstream file(path, std::ios::binary);
+	const uint64_t tailSize = std::min(size, (uint64_t)ZIP_EOCD_SEARCH);
+	std::vector<unsigned char> tail((size_t)tailSize);
+	file.seekg((std::streamoff)(size - tailSize));
+	if(!file.read((char*)tail.data(), tail.size()))
+		return false;
+
+	// the record is followed by a comment of unknown length, so search backwards for it
+	const unsigned char* eocd = NULL;
+	for(size_t i = tail.size() - ZIP_EOCD_SIZE + 1; i-- > 0; )
+	{
+		if(readLE32(&tail[i]) == 0x06054b50)
+		{
+			eocd = &tail[i];
+			break;
+		}
+	}
+	if(eocd == NULL)
+		return false;
+
+	const uint32_t directorySize = readLE32(eocd + 12);
+	const uint32_t directoryOffset = readLE32(eocd + 16);
+	if(directoryOffset == 0xFFFFFFFF || directorySize > ZIP_MAX_DIRECTORY_SIZE || (uint64_t)directoryOffset + directorySize > size)
+		return false;
+
+	std::vector<unsigned char> directory(directorySize);
+	file.seekg(directoryOffset);
+	if(!file.read((char*)directory.data(), directory.size()))
+		return false;
+
+	const size_t headerSize = 46;
+	for(size_t pos = 0; pos + headerSize <= directory.size(); )
+	{
+		const unsigned char* header = &directory[pos];
+		if(readLE32(header) != 0x02014b50)
+			break;
+
+		const uint16_t nameLength = readLE16(header + 28);
+		const size_t next = pos + headerSize + nameLength + readLE16(header + 30) + readLE16(header + 32);
+		if(pos + headerSize + nameLength > directory.size())
+			break;
+
+		RomArchiveMember member;
+		member.name.assign((const char*)header + headerSize, nameLength);
+		member.crc32 = readLE32(header + 16);
+		member.size = readLE32(header + 24);
+
+		// directories don't have contents worth identifying
+		if(!member.name.empty() && member.name.back() != '/')
+			members.push_back(member);
+
+		pos = next;
+	}
+
+	return true;
+}
+
+bool RomHashCache::hashFile(const std::string& path, RomHashes& hashes)
+{
+	boost::system::error_code ec;
+	hashes.size = fs::file_size(path, ec);
+	if(!ec)
+		hashes.modified = fs::last_write_time(path, ec);
+	if(ec)
+		return false;
+
+	RomHasher hasher;
+	if(!hashContents(path, hashes.size, hasher))
+	{
+		LOG(LogWarning) << "Could not read \"" << path << "\" to hash it";
+		return false;
+	}
+
+	hashes.crc32 = hasher.crc32.finish();
+	hashes.md5 = hasher.md5.finish();
+	hashes.sha1 = hasher.sha1.finish();
+
+	hashes.members.clear();
+	std::string extension = fs::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	if(extension == ".zip" && !readZipMembers(path, hashes.size, hashes.members))
+		LOG(LogDebug) << "Could not list the contents of \"" << path << "\"";
+
+	return true;
+}
+
+bool RomHashCache::isCurrent(const std::string& path, uint64_t size, time_t modified)
+{
+	auto it = mHashes.find(path);
+	return it != mHashes.end() && it->second.size == size && it->second.modified == modified;
+}
+
+unsigned int RomHashCache::update(const std::vector<std::string>& paths, std::unordered_map<std::string, RomHashes>* hashes)
+{
+	// only a stat for everything that's already known
+	std::vector<std::string> changed;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		for(auto it = paths.begin(); it != paths.end(); it++)
+		{
+			boost::system::error_code ec;
+			const uint64_t size = fs::file_size(*it, ec);
+			const time_t modified = ec ? 0 : fs::last_write_time(*it, ec);
+			if(ec)
+				continue;
+			if(!isCurrent(*it, size, modified))
+				changed.push_back(*it);
+			else if(hashes)
+				(*hashes)[*it] = mHashes[*it];
+		}
+	}
+
+	if(changed.empty())
+		return 0;
+
+	// one job per file, the hashes themselves can't be split up
+	std::vector<RomHashes> results(changed.size());
+	std::vector<char> hashed(changed.size(), 0);
+	std::vector< std::function<void()> > jobs;
+	jobs.reserve(changed.size());
+	for(size_t i = 0; i < changed.size(); i++)
+		jobs.push_back([&changed, &results, &hashed, i] { hashed[i] = hashFile(changed[i], results[i]); });
+
+	ThreadPool::getInstance()->run(jobs);
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	for(size_t i = 0; i < changed.size(); i++)
+	{
+		if(!hashed[i])
+			continue;
+		if(hashes)
+			(*hashes)[changed[i]] = results[i];
+		mHashes[changed[i]] = std::move(results[i]);
+	}
+	mDirty = true;
+
+	return (unsigned int)changed.size();
+}
+
+bool RomHashCache::get(const std::string& path, RomHashes& hashes, uint64_t maxReadSize)
+{
+	boost::system::error_code ec;
+	const uint64_t size = fs::file_size(path, ec);
+	const time_t modified = ec ? 0 : fs::last_write_time(path, ec);
+	if(ec)
+		return false;
+
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if(isCurrent(path, size, modified))
+		{
+			hashes = mHashes[path];
+			return true;
+		}
+	}
+
+	if((maxReadSize && size > maxReadSize) || !hashFile(path, hashes))
+		return false;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mHashes[path] = hashes;
+	mDirty = true;
+	return true;
+}
+
+// One file per line: path, size, modification time, crc32, md5, sha1 and then
+// name, size and crc32 of every zip member, all separated by tabs.
+void RomHashCache::load()
+{
+	std::ifstream file(mPath);
+	std::string line;
+	while(std::getline(file, line))
+	{
+		if(line.empty() || line[0] == '#')
+			continue;
+
+		std::vector<std::string> fields;
+		std::stringstream ss(line);
+		std::string field;
+		while(std::getline(ss, field, '\t'))
+			fields.push_back(field);
+
+		if(fields.size() < 6 || (fields.size() - 6) % 3 != 0)
+			continue;
+
+		RomHashes hashes;
+		hashes.size = strtoull(fields[1].c_str(), NULL, 10);
+		hashes.modified = (time_t)strtoll(fields[2].c_str(), NULL, 10);
+		hashes.crc32 = (uint32_t)strtoul(fields[3].c_str(), NULL, 16);
+		hashes.md5 = fields[4];
+		hashes.sha1 = fields[5];
+
+		for(size_t i = 6; i < fields.size(); i += 3)
+		{
+			RomArchiveMember member;
+			member.name = fields[i];
+			member.size = strtoull(fields[i + 1].c_str(), NULL, 10);
+			member.crc32 = (uint32_t)strtoul(fields[i + 2].c_str(), NULL, 16);
+			hashes.members.push_back(member);
+		}
+
+		mHashes[fields[0]] = hashes;
+	}
+
+	LOG(LogInfo) << "Loaded " << mHashes.size() << " cached ROM hashes";
+}
+
+void RomHashCache::save()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if(!mDirty)
+		return;
+
+	// can't be told apart from the separators
+	auto storable = [](const std::string& str) { return str.find_first_of("\t\r\n") == std::string::npos; };
+
+	const std::string tempPath = mPath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::trunc);
+		file << "# path\tsize\tmodified\tcrc32\tmd5\tsha1\t[zip member name\tsize\tcrc32]...\n";
+
+		char crc[9];
+		for(auto it = mHashes.begin(); it != mHashes.end(); it++)
+		{
+			if(!storable(it->first))
+				continue;
+
+			const RomHashes& hashes = it->second;
+			snprintf(crc, sizeof(crc), "%08x", hashes.crc32);
+			file << it->first << "\t" << hashes.size << "\t" << (long long)hashes.modified << "\t" << crc << "\t" << hashes.md5 << "\t" << hashes.sha1;
+
+			for(auto member = hashes.members.begin(); member != hashes.members.end(); member++)
+			{
+				if(!storable(member->name))
+					continue;
+
+				snprintf(crc, sizeof(crc), "%08x", member->crc32);
+				file << "\t" << member->name << "\t" << member->size << "\t" << crc;
+			}
+			file << "\n";
+		}
+
+		if(!file)
+		{
+			LOG(LogError) << "Could not write ROM hash cache \"" << tempPath << "\"";
+			return;
+		}
+	}
+
+	boost::system::error_code ec;
+	fs::rename(tempPath, mPath, ec);
+	if(ec)
+	{
+		LOG(LogError) << "Could not write ROM hash cache \"" << mPath << "\": " << ec.message();
+		return;
+	}
+
+	mDirty = false;
+}
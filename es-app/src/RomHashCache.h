@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <ctime>
+#include <stdint.h>
+
+// a file inside a .zip, as listed in its central directory
+struct RomArchiveMember
+{
+	std::string name;
+	uint64_t size;
+	uint32_t crc32;
+};
+
+struct RomHashes
+{
+	uint64_t size;
+	time_t modified;
+
+	uint32_t crc32;
+	std::string md5; // lower case hex
+	std::string sha1;
+
+	// For .zip files the CRCs of what's inside, which is what ROM databases list.
+	// Read from the zip's directory, nothing is decompressed.
+	std::vector<RomArchiveMember> members;
+};
+
+// Content hashes of ROM files, kept in ~/.emulationstation/rom_hashes.txt keyed by path.
+// A cached entry is only used while the file's size and modification time are unchanged,
+// so after the first run only new or changed files are read again.
+class RomHashCache
+{
+public:
+	static RomHashCache* getInstance();
+
+	// Hashes every path that isn't cached yet (or changed since), spread over the thread pool.
+	// Returns how many files had to be read. If hashes isn't NULL it gets the hashes of every
+	// path that has them now, cached or just read, so they don't need looking up again.
+	unsigned int update(const std::vector<std::string>& paths, std::unordered_map<std::string, RomHashes>* hashes = NULL);
+
+	// Hashes of path, read on the calling thread if they aren't cached. False if path can't be read,
+	// or if it isn't cached and is bigger than maxReadSize (when that isn't 0).
+	bool get(const std::string& path, RomHashes& hashes, uint64_t maxReadSize = 0);
+
+	// Writes the cache file if anything changed since it was read.
+	void save();
+
+	// Reads path and hashes it, without looking at the cache.
+	static bool hashFile(const std::string& path, RomHashes& hashes);
+
+private:
+	RomHashCache();
+
+	// true if path has an entry that still matches the file
+	bool isCurrent(const std::string& path, uint64_t size, time_t modified);
+	void load();
+
+	std::string mPath;
+	std::unordered_map<std::string, RomHashes> mHashes;
+	std::mutex mMutex;
+	bool mDirty;
+};
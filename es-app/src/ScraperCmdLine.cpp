@@ -1,285 +1,277 @@
 #include "ScraperCmdLine.h"
-#include <iostream>
-#include <vector>
+#include "scrapers/ScraperPipeline.h"
 #include "SystemData.h"
 #include "Settings.h"
-#include <signal.h>
 #include "Log.h"
+#include "platform.h"
+#include <boost/filesystem.hpp>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <map>
+#include <unordered_set>
+#include <thread>
+#include <signal.h>
 
-std::ostream& out = std::cout;
-
-void handle_interrupt_signal(int p)
-{
-	sleep(50);
+namespace fs = boost::filesystem;
 
-	LOG(LogInfo) << "Interrupt received during scrape...";
+// gamelists of systems still being scraped are written at least this often, so a killed run loses little
+#define CHECKPOINT_INTERVAL_MS (5 * 60 * 1000)
 
-	SystemData::deleteSystems();
+static volatile sig_atomic_t sInterrupted = 0;
 
-	exit(1);
+static void handle_interrupt_signal(int)
+{
+	sInterrupted = 1;
 }
 
-int run_scraper_cmdline()
+struct SystemProgress
 {
-	out << "EmulationStation scraper\n";
-	out << "========================\n";
-	out << "\n";
+	SystemProgress() : games(0), remaining(0), scraped(0), skipped(0), failed(0), resumed(0) {}
 
-	signal(SIGINT, handle_interrupt_signal);
+	unsigned int games; // queued this run
+	unsigned int remaining;
+	unsigned int scraped;
+	unsigned int skipped;
+	unsigned int failed;
+	unsigned int resumed; // already done by an earlier run
+
+	std::vector<std::string> finished; // done, but not in the checkpoint until the gamelist is written
+};
+
+// The checkpoint lists every game whose result is already in a written gamelist, one path per line.
+// Failed games are never listed, so resuming retries them.
+static std::unordered_set<std::string> readCheckpoint(const std::string& path)
+{
+	std::unordered_set<std::string> done;
 
-	//==================================================================================
-	//filter
-	//==================================================================================
-	enum FilterChoice
+	std::ifstream file(path);
+	std::string line;
+	while(std::getline(file, line))
 	{
-		FILTER_MISSING_IMAGES,
-		FILTER_ALL
-	};
+		if(!line.empty())
+			done.insert(line);
+	}
 
-	int filter_choice;
-	do {
-		out << "Select filter for games to be scraped:\n";
-		out << FILTER_MISSING_IMAGES << " - games missing images\n";
-		out << FILTER_ALL << " - all games period, can overwrite existing metadata\n";
+	return done;
+}
 
-		std::cin >> filter_choice;
-		std::cin.ignore(1, '\n'); //skip the unconsumed newline
-	} while(filter_choice < FILTER_MISSING_IMAGES || filter_choice > FILTER_ALL);
+static void appendCheckpoint(const std::string& path, std::vector<std::string>& games)
+{
+	if(games.empty())
+		return;
 
-	out << "\n";
+	std::ofstream file(path, std::ios::app);
+	for(auto it = games.begin(); it != games.end(); it++)
+		file << *it << "\n";
+	file.flush();
 
-	//==================================================================================
-	//platforms
-	//==================================================================================
+	if(!file)
+		LOG(LogError) << "Could not write scraper checkpoint \"" << path << "\"";
 
-	std::vector<SystemData*> systems;
+	games.clear();
+}
 
-	out << "You can scrape only specific platforms, or scrape all of them.\n";
-	out << "Would you like to scrape all platforms? (y/n)\n";
+static std::string jsonString(const std::string& str)
+{
+	std::stringstream ss;
+	ss << '"';
+	for(auto it = str.begin(); it != str.end(); it++)
+	{
+		const unsigned char c = (unsigned char)*it;
+		if(c == '"' || c == '\\')
+			ss << '\\' << c;
+		else if(c < 0x20)
+			ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec;
+		else
+			ss << c;
+	}
+	ss << '"';
+	return ss.str();
+}
 
-	std::string system_choice;
-	std::getline(std::cin, system_choice);
-	
-	if(system_choice == "y" || system_choice == "Y")
+int run_scraper_cmdline(const ScraperCmdLineOptions& options)
+{
+	std::vector<SystemData*> systems;
+	if(options.systems.empty())
 	{
-		out << "Will scrape all platforms.\n";
-		for(auto i = SystemData::sSystemVector.begin(); i != SystemData::sSystemVector.end(); i++)
+		// same default as the scraper menu
+		for(auto it = SystemData::sSystemVector.begin(); it != SystemData::sSystemVector.end(); it++)
 		{
-			out << "   " << (*i)->getName() << " (" << (*i)->getGameCount() << " games)\n";
-			systems.push_back(*i);
+			if(!(*it)->hasPlatformId(PlatformIds::PLATFORM_IGNORE) && !(*it)->getPlatformIds().empty())
+				systems.push_back(*it);
 		}
-
 	}else{
-		std::string sys_name;
-
-		out << "Enter the names of the platforms you would like to scrape, one at a time.\n";
-		out << "Type nothing and press enter when you are ready to continue.\n";
-
-		do {
-			for(auto i = SystemData::sSystemVector.begin(); i != SystemData::sSystemVector.end(); i++)
+		for(auto name = options.systems.begin(); name != options.systems.end(); name++)
+		{
+			auto it = std::find_if(SystemData::sSystemVector.begin(), SystemData::sSystemVector.end(),
+				[&name](SystemData* system) { return system->getName() == *name; });
+			if(it == SystemData::sSystemVector.end())
 			{
-				if(std::find(systems.begin(), systems.end(), (*i)) != systems.end())
-					out << " C ";
-				else
-					out << "   ";
-
-				out << "\"" << (*i)->getName() << "\" (" << (*i)->getGameCount() << " games)\n";
+				std::cerr << "Unknown system \"" << *name << "\".\n";
+				return 1;
 			}
 
-			std::getline(std::cin, sys_name);
-			
-			if(sys_name.empty())
-				break;
+			systems.push_back(*it);
+		}
+	}
 
-			bool found = false;
-			for(auto i = SystemData::sSystemVector.begin(); i != SystemData::sSystemVector.end(); i++)
-			{
-				if((*i)->getName() == sys_name)
-				{
-					systems.push_back(*i);
-					found = true;
-					break;
-				}
-			}
+	const std::string checkpointPath = options.checkpointPath.empty() ?
+		getHomePath() + "/.emulationstation/scrape_checkpoint.txt" : options.checkpointPath;
 
-			if(!found)
-				out << "System not found.\n";
+	std::unordered_set<std::string> done;
+	if(options.restart)
+		fs::remove(checkpointPath);
+	else
+		done = readCheckpoint(checkpointPath);
 
-		} while(true);
-	}
+	std::map<SystemData*, SystemProgress> progress;
+	std::queue<ScraperSearchParams> searches;
+	unsigned int resumed = 0;
+	for(auto sys = systems.begin(); sys != systems.end(); sys++)
+	{
+		SystemProgress& sp = progress[*sys];
 
-	//==================================================================================
-	//manual mode
-	//==================================================================================
+		std::vector<FileData*> games = (*sys)->getRootFolder()->getFilesRecursive(GAME);
+		for(auto game = games.begin(); game != games.end(); game++)
+		{
+			if(options.missingOnly && !(*game)->metadata.get("image").empty())
+				continue;
 
-	out << "\n";
-	out << "You can let the scraper try to automatically choose the best result, or\n";
-	out << "you can manually approve each result. This \"manual mode\" is much more accurate.\n";
-	out << "It is highly recommended you use manual mode unless you have a very large collection.\n";
-	out << "Scrape in manual mode? (y/n)\n";
+			if(done.find((*game)->getPath().generic_string()) != done.end())
+			{
+				sp.resumed++;
+				resumed++;
+				continue;
+			}
 
-	std::string manual_mode_str;
-	std::getline(std::cin, manual_mode_str);
+			ScraperSearchParams search;
+			search.game = *game;
+			search.system = *sys;
+			searches.push(search);
 
-	bool manual_mode = false;
+			sp.games++;
+			sp.remaining++;
+		}
+	}
 
-	if(manual_mode_str == "y" || manual_mode_str == "Y")
+	if(options.threads > 0)
 	{
-		manual_mode = true;
-		out << "Scraping in manual mode!\n";
-	}else{
-		out << "Scraping in automatic mode!\n";
+		Settings::getInstance()->setInt("ScraperMaxSearches", options.threads);
+		Settings::getInstance()->setInt("ScraperMaxDownloads", options.threads);
 	}
 
-	//==================================================================================
-	//scraping
-	//==================================================================================
-	out << "\n";
-	out << "Alright, let's do this thing!\n";
-	out << "=============================\n";
+	const unsigned int total = (unsigned int)searches.size();
+	std::cerr << "Scraping " << total << " games from " << systems.size() << " systems";
+	if(resumed > 0)
+		std::cerr << ", " << resumed << " already done by an earlier run";
+	std::cerr << ".\n";
+	LOG(LogInfo) << "Command line scrape of " << total << " games started, " << resumed << " resumed from \"" << checkpointPath << "\"";
 
-	/*
-	std::shared_ptr<Scraper> scraper = Settings::getInstance()->getScraper();
-	for(auto sysIt = systems.begin(); sysIt != systems.end(); sysIt++)
-	{
-		std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
+	signal(SIGINT, handle_interrupt_signal);
+	signal(SIGTERM, handle_interrupt_signal);
 
-		ScraperSearchParams params;
-		params.system = (*sysIt);
+	const auto startTime = std::chrono::steady_clock::now();
+	auto lastCheckpoint = startTime;
 
-		for(auto gameIt = files.begin(); gameIt != files.end(); gameIt++)
+	std::vector<SystemData*> completed;
+	ScraperPipeline pipeline(searches);
+	pipeline.setAcceptMode(options.singleResultOnly ? ScraperPipeline::ACCEPT_SINGLE_RESULT : ScraperPipeline::ACCEPT_FIRST_RESULT);
+	pipeline.setGameDoneCallback([&](const ScraperSearchParams& params, ScraperPipeline::GameResult result, const std::string& error) {
+		SystemProgress& sp = progress[params.system];
+		switch(result)
 		{
-			params.nameOverride = "";
-			params.game = *gameIt;
-
-			//print original search term
-			out << getCleanFileName(params.game->getPath()) << "...\n";
+		case ScraperPipeline::GAME_SCRAPED:
+			sp.scraped++;
+			break;
+		case ScraperPipeline::GAME_SKIPPED:
+			sp.skipped++;
+			break;
+		case ScraperPipeline::GAME_FAILED:
+			sp.failed++;
+			break;
+		}
 
-			//need to take into account filter_choice
-			if(filter_choice == FILTER_MISSING_IMAGES)
-			{
-				if(!params.game->metadata.get("image").empty()) //maybe should also check if the image file exists/is a URL
-				{
-					out << "   Skipping, metadata \"image\" entry is not empty.\n";
-					continue;
-				}
-			}
+		if(result != ScraperPipeline::GAME_FAILED)
+			sp.finished.push_back(params.game->getPath().generic_string());
 
-			//actually get some results
-			do {
-				std::vector<MetaDataList> mdls = scraper->getResults(params);
-
-				//no results
-				if(mdls.size() == 0)
-				{
-					if(manual_mode)
-					{
-						//in manual mode let the user enter a custom search
-						out << "   NO RESULTS FOUND! Enter a new name to search for, or nothing to skip.\n";
-
-						std::getline(std::cin, params.nameOverride);
-
-						if(params.nameOverride.empty())
-						{
-							out << "   Skipping...\n";
-							break;
-						}
-
-						continue;
-
-					}else{
-						out << "   NO RESULTS FOUND! Skipping...\n";
-						break;
-					}
-				}
-
-				//some results
-				if(manual_mode)
-				{
-					//print list of choices
-					for(unsigned int i = 0; i < mdls.size(); i++)
-					{
-						out << "   " << i << " - " << mdls.at(i).get("name") << "\n";
-					}
-
-					int choice = -1;
-					std::string choice_str;
-					
-					out << "Your choice: ";
-
-					std::getline(std::cin, choice_str);
-					std::stringstream choice_buff(choice_str); //convert to int
-					choice_buff >> choice;
-
-					if(choice >= 0 && choice < (int)mdls.size())
-					{
-						params.game->metadata = mdls.at(choice);
-						break;
-					}else{
-						out << "Invalid choice.\n";
-						continue;
-					}
-
-				}else{
-					//automatic mode
-					//always choose the first choice
-					out << "   name -> " << mdls.at(0).get("name") << "\n";
-					params.game->metadata = mdls.at(0);
-					break;
-				}
-
-			} while(true);
-
-			out << "===================\n";
-		}
-	}
+		if(--sp.remaining == 0)
+			completed.push_back(params.system);
 
-	out << "\n\n";
-	out << "Downloading boxart...\n";
+		std::cerr << "[" << pipeline.getFinished() << "/" << total << "] " << params.system->getName() << ": "
+			<< params.game->getPath().filename().string() << " - "
+			<< (result == ScraperPipeline::GAME_SCRAPED ? "scraped" : (result == ScraperPipeline::GAME_SKIPPED ? "skipped, " : "failed, "))
+			<< error << "\n";
+	});
 
-	for(auto sysIt = systems.begin(); sysIt != systems.end(); sysIt++)
+	while(!pipeline.isDone() && !sInterrupted)
 	{
-		std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
+		pipeline.update();
+		HttpReq::dispatchCompletions(); // there's no Window updating to do it
 
-		for(auto gameIt = files.begin(); gameIt != files.end(); gameIt++)
+		// a system is written as soon as its last game is done
+		for(auto it = completed.begin(); it != completed.end(); it++)
 		{
-			FileData* game = *gameIt;
-			const std::vector<MetaDataDecl>& mdd = game->metadata.getMDD();
-			for(auto i = mdd.begin(); i != mdd.end(); i++)
-			{
-				std::string key = i->key;
-				std::string url = game->metadata.get(key);
-
-				if(i->type == MD_IMAGE_PATH && HttpReq::isUrl(url))
-				{
-					std::string urlShort = url.substr(0, url.length() > 35 ? 35 : url.length());
-					if(url.length() != urlShort.length()) urlShort += "...";
-
-					out << "   " << game->metadata.get("name") << " [from: " << urlShort << "]...\n";
-
-					ScraperSearchParams p;
-					p.game = game;
-					p.system = *sysIt;
-					game->metadata.set(key, downloadImage(url, getSaveAsPath(p, key, url)));
-					if(game->metadata.get(key).empty())
-					{
-						out << "     FAILED! Skipping.\n";
-						game->metadata.set(key, url); //result URL to what it was if download failed, retry some other time
-					}
-				}
-			}
+			pipeline.flush(*it);
+			appendCheckpoint(checkpointPath, progress[*it].finished);
 		}
-	}
+		completed.clear();
 
+		// and the others every so often, in case we get killed
+		const auto now = std::chrono::steady_clock::now();
+		if(now - lastCheckpoint >= std::chrono::milliseconds(CHECKPOINT_INTERVAL_MS))
+		{
+			pipeline.flush();
+			for(auto it = progress.begin(); it != progress.end(); it++)
+				appendCheckpoint(checkpointPath, it->second.finished);
+			lastCheckpoint = now;
+		}
 
-	out << "\n\n";
-	out << "==============================\n";
-	out << "SCRAPE COMPLETE!\n";
-	out << "==============================\n";
-	*/
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	const bool interrupted = sInterrupted != 0;
+	if(interrupted)
+		std::cerr << "Interrupted, saving what was scraped so far...\n";
+
+	pipeline.stop();
+	for(auto it = progress.begin(); it != progress.end(); it++)
+		appendCheckpoint(checkpointPath, it->second.finished);
+
+	// nothing left to resume unless something failed
+	if(!interrupted && pipeline.getFailed() == 0)
+		fs::remove(checkpointPath);
+
+	const float seconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count() / 1000.0f;
+	LOG(LogInfo) << "Command line scrape " << (interrupted ? "interrupted" : "finished") << " after " << seconds << "s: "
+		<< pipeline.getScraped() << " scraped, " << pipeline.getSkipped() << " skipped, " << pipeline.getFailed() << " failed";
+
+	std::cout << "{\"interrupted\": " << (interrupted ? "true" : "false")
+		<< ", \"seconds\": " << seconds
+		<< ", \"gamesPerMinute\": " << pipeline.getGamesPerMinute()
+		<< ", \"scraped\": " << pipeline.getScraped()
+		<< ", \"skipped\": " << pipeline.getSkipped()
+		<< ", \"failed\": " << pipeline.getFailed()
+		<< ", \"remaining\": " << (total - pipeline.getFinished())
+		<< ", \"resumed\": " << resumed
+		<< ", \"systems\": [";
+	for(auto sys = systems.begin(); sys != systems.end(); sys++)
+	{
+		const SystemProgress& sp = progress[*sys];
+		std::cout << (sys == systems.begin() ? "" : ", ")
+			<< "{\"name\": " << jsonString((*sys)->getName())
+			<< ", \"games\": " << sp.games
+			<< ", \"scraped\": " << sp.scraped
+			<< ", \"skipped\": " << sp.skipped
+			<< ", \"failed\": " << sp.failed
+			<< ", \"resumed\": " << sp.resumed << "}";
+	}
+	std::cout << "]}\n";
 
-	out << "\n\n";
-	out << "ACTUALLY THIS IS STILL TODO\n";
+	if(interrupted)
+		return 130;
 
-	return 0;
+	return pipeline.getFailed() > 0 ? 2 : 0;
 }
@@ -1,3 +1,20 @@
 #pragma once
 
-int run_scraper_cmdline();
+#include <string>
+#include <vector>
+
+struct ScraperCmdLineOptions
+{
+	ScraperCmdLineOptions() : missingOnly(true), singleResultOnly(false), threads(0), restart(false) {}
+
+	std::vector<std::string> systems; // names, empty for every system with a platform set
+	bool missingOnly; // only games without an image
+	bool singleResultOnly; // skip games with more than one result instead of taking the first
+	int threads; // searches and downloads in flight at once, 0 to use the settings
+	std::string checkpointPath; // empty for the default
+	bool restart; // ignore an existing checkpoint
+};
+
+// Scrapes without asking anything, prints progress to stderr and a JSON summary to stdout.
+// Returns 0 if every game was handled, 1 on bad options, 2 if some games failed and 130 if interrupted.
+int run_scraper_cmdline(const ScraperCmdLineOptions& options);
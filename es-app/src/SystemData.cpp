@@ -12,6 +12,8 @@
 #include <iostream>
 #include "Settings.h"
 #include "FileSorts.h"
+#include "resources/TextureResource.h"
+#include "GameSearchIndex.h"
 
 std::vector<SystemData*> SystemData::sSystemVector;
 
@@ -58,6 +60,7 @@ SystemData::~SystemData()
 		updateGamelist(this);
 	}
 
+	mSearchIndex.reset();
 	delete mRootFolder;
 }
 
@@ -110,6 +113,12 @@ void SystemData::launchGame(Window* window, FileData* game)
 
 	AudioManager::getInstance()->deinit();
 	VolumeControl::getInstance()->deinit();
+
+	// keep the decoded images for the menus we come back to, rather than loading them all again.
+	// also with nothing to keep, so the texture loader stops until we're back
+	int keepTextures = std::max(0, Settings::getInstance()->getInt("LaunchTextureRAM"));
+	TextureResource::keepForLaunch((size_t)keepTextures * 1024 * 1024, keepTextures > 0 && Settings::getInstance()->getBool("LaunchTextureSnapshot"));
+
 	window->deinit();
 
 	std::string command = mLaunchCommand;
@@ -426,7 +435,7 @@ bool SystemData::hasGamelist() const
 
 unsigned int SystemData::getGameCount() const
 {
-	return mRootFolder->getFilesRecursive(GAME).size();
+	return mRootFolder->getCounts().games;
 }
 
 void SystemData::loadTheme()
@@ -447,3 +456,33 @@ void SystemData::loadTheme()
 		mTheme = std::make_shared<ThemeData>(); // reset to empty
 	}
 }
+
+GameSearchIndex* SystemData::getSearchIndex()
+{
+	if(!mSearchIndex)
+		mSearchIndex.reset(new GameSearchIndex(mRootFolder));
+
+	return mSearchIndex.get();
+}
+
+void SystemData::onFileChanged(FileData* file, FileChangeType change)
+{
+	// nothing to keep up to date until someone searched
+	if(!mSearchIndex)
+		return;
+
+	switch(change)
+	{
+	case FILE_ADDED:
+		mSearchIndex->add(file);
+		break;
+	case FILE_REMOVED:
+		mSearchIndex->remove(file);
+		break;
+	case FILE_METADATA_CHANGED:
+		mSearchIndex->invalidate(file);
+		break;
+	default:
+		break;
+	}
+}
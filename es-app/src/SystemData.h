@@ -7,6 +7,9 @@
 #include "MetaData.h"
 #include "PlatformId.h"
 #include "ThemeData.h"
+#include <memory>
+
+class GameSearchIndex;
 
 class SystemData
 {
@@ -64,6 +67,12 @@ public:
 	// Load or re-load theme.
 	void loadTheme();
 
+	// Search index over this system's games, built on first use.
+	GameSearchIndex* getSearchIndex();
+
+	// Called by FileData whenever one of our files is added, removed or has its metadata changed.
+	void onFileChanged(FileData* file, FileChangeType change);
+
 private:
 	std::string mName;
 	std::string mFullName;
@@ -77,4 +86,5 @@ private:
 	void populateFolder(FileData* folder);
 
 	FileData* mRootFolder;
+	std::unique_ptr<GameSearchIndex> mSearchIndex;
 };
@@ -12,13 +12,13 @@
 // 1. Current parameters are retrieved through a get() call
 //    ugliness:
 //		-have to have a way to get a reference to the animation
-//      -requires additional implementation in some parent object, potentially AnimationController
+//      -requires additional implementation in some parent object, potentially AnimationManager
 // 2. ViewController is passed in LaunchAnimation constructor, applies state through setters
 //    ugliness:
 //      -effect only works for ViewController
 // 3. Pass references to ViewController variables - LaunchAnimation(mCameraPos, mFadePerc, target)
 //    ugliness:
-//      -what if ViewController is deleted? --> AnimationController class handles that
+//      -what if ViewController is deleted? --> AnimationManager handles that
 //      -no callbacks for changes...but that works well with this style of update, so I think it's okay
 // 4. Use callbacks to set variables
 //    ugliness:
@@ -123,7 +123,7 @@ void RatingComponent::render(const Eigen::Affine3f& parentTrans)
 
 bool RatingComponent::input(InputConfig* config, Input input)
 {
-	if(config->isMappedTo("a", input) && input.value != 0)
+	if(config->isMappedTo(ACTION_A, input) && input.value != 0)
 	{
 		mValue += 1.f / NUM_RATING_STARS;
 		if(mValue > 1.0f)
@@ -146,14 +146,14 @@ void RatingComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const
 		return;
 
 	bool imgChanged = false;
-	if(properties & PATH && elem->has("filledPath"))
+	if(properties & PATH && elem->has(ThemeProperty::FILLED_PATH))
 	{
-		mFilledTexture = TextureResource::get(elem->get<std::string>("filledPath"), true);
+		mFilledTexture = TextureResource::get(elem->get<std::string>(ThemeProperty::FILLED_PATH), true);
 		imgChanged = true;
 	}
-	if(properties & PATH && elem->has("unfilledPath"))
+	if(properties & PATH && elem->has(ThemeProperty::UNFILLED_PATH))
 	{
-		mUnfilledTexture = TextureResource::get(elem->get<std::string>("unfilledPath"), true);
+		mUnfilledTexture = TextureResource::get(elem->get<std::string>(ThemeProperty::UNFILLED_PATH), true);
 		imgChanged = true;
 	}
 
@@ -307,6 +307,7 @@ void ScraperSearchComponent::updateInfoPane()
 		if(!thumb.empty())
 		{
 			mThumbnailReq = std::unique_ptr<HttpReq>(new HttpReq(thumb));
+			mThumbnailReq->setCompletionCallback([this](HttpReq*) { updateThumbnail(); });
 		}else{
 			mThumbnailReq.reset();
 		}
@@ -336,7 +337,7 @@ void ScraperSearchComponent::updateInfoPane()
 
 bool ScraperSearchComponent::input(InputConfig* config, Input input)
 {
-	if(config->isMappedTo("a", input) && input.value != 0)
+	if(config->isMappedTo(ACTION_A, input) && input.value != 0)
 	{
 		if(mBlockAccept)
 			return true;
@@ -385,11 +386,6 @@ void ScraperSearchComponent::update(int deltaTime)
 		mBusyAnim.update(deltaTime);
 	}
 
-	if(mThumbnailReq && mThumbnailReq->status() != HttpReq::REQ_IN_PROGRESS)
-	{
-		updateThumbnail();
-	}
-
 	if(mSearchHandle && mSearchHandle->status() != ASYNC_IN_PROGRESS)
 	{
 		auto status = mSearchHandle->status();
@@ -430,7 +426,7 @@ void ScraperSearchComponent::updateThumbnail()
 {
 	if(mThumbnailReq && mThumbnailReq->status() == HttpReq::REQ_SUCCESS)
 	{
-		std::string content = mThumbnailReq->getContent();
+		const std::string& content = mThumbnailReq->getContent();
 		mResultThumbnail->setImage(content.data(), content.length());
 		mGrid.onSizeChanged(); // a hack to fix the thumbnail position since its size changed
 	}else{
@@ -10,13 +10,14 @@
 #include "Util.h"
 #include <vector>
 #include <string>
+#include <list>
+#include <map>
 #include <memory>
 #include <functional>
 
 struct TextListData
 {
 	unsigned int colorId;
-	std::shared_ptr<TextCache> textCache;
 };
 
 //A graphical list. Supports multiple colors for rows and scrolling.
@@ -31,6 +32,7 @@ protected:
 	using IList<TextListData, T>::getTransform;
 	using IList<TextListData, T>::mSize;
 	using IList<TextListData, T>::mCursor;
+	using IList<TextListData, T>::mScrollVelocity;
 	using IList<TextListData, T>::Entry;
 
 public:
@@ -61,15 +63,13 @@ public:
 	inline void setFont(const std::shared_ptr<Font>& font)
 	{
 		mFont = font;
-		for(auto it = mEntries.begin(); it != mEntries.end(); it++)
-			it->data.textCache.reset();
+		clearTextCaches();
 	}
 
 	inline void setUppercase(bool uppercase) 
 	{
 		mUppercase = true;
-		for(auto it = mEntries.begin(); it != mEntries.end(); it++)
-			it->data.textCache.reset();
+		clearTextCaches();
 	}
 
 	inline void setSelectorColor(unsigned int color) { mSelectorColor = color; }
@@ -88,6 +88,21 @@ private:
 	static const int MARQUEE_SPEED = 8;
 	static const int MARQUEE_RATE = 1;
 
+	static const int TEXT_CACHE_SCREENS = 3; // number of screens worth of rows to keep text caches for
+	static const int PREBUILD_ROWS = 4; // rows past the edge of the screen to build while scrolling
+
+	void getVisibleRange(int& startEntry, int& listCutoff) const;
+
+	// Returns the text cache for name, building it if necessary. Only the most recently
+	// used caches are kept, so long lists don't hold vertex data for every row ever shown.
+	TextCache* getTextCache(const std::string& name);
+	void clearTextCaches();
+
+	typedef std::list< std::pair< std::string, std::shared_ptr<TextCache> > > TextCacheList;
+	TextCacheList mTextCaches;
+	std::map< std::string, typename TextCacheList::iterator > mTextCacheLookup;
+	size_t mMaxTextCaches;
+
 	int mMarqueeOffset;
 	int mMarqueeTime;
 
@@ -118,6 +133,7 @@ TextListComponent<T>::TextListComponent(Window* window) :
 
 	mFont = Font::get(FONT_SIZE_MEDIUM);
 	mUppercase = false;
+	mMaxTextCaches = PREBUILD_ROWS;
 	mLineSpacing = 1.5f;
 	mSelectorColor = 0x000000FF;
 	mSelectedColor = 0;
@@ -126,18 +142,11 @@ TextListComponent<T>::TextListComponent(Window* window) :
 }
 
 template <typename T>
-void TextListComponent<T>::render(const Eigen::Affine3f& parentTrans)
+void TextListComponent<T>::getVisibleRange(int& startEntry, int& listCutoff) const
 {
-	Eigen::Affine3f trans = parentTrans * getTransform();
-	
-	std::shared_ptr<Font>& font = mFont;
-
-	if(size() == 0)
-		return;
-
-	const float entrySize = round(font->getHeight(mLineSpacing));
+	const float entrySize = round(mFont->getHeight(mLineSpacing));
 
-	int startEntry = 0;
+	startEntry = 0;
 
 	//number of entries that can fit on the screen simultaniously
 	int screenCount = (int)(mSize.y() / entrySize + 0.5f);
@@ -151,11 +160,63 @@ void TextListComponent<T>::render(const Eigen::Affine3f& parentTrans)
 			startEntry = size() - screenCount;
 	}
 
-	float y = 0;
-
-	int listCutoff = startEntry + screenCount;
+	listCutoff = startEntry + screenCount;
 	if(listCutoff > size())
 		listCutoff = size();
+}
+
+template <typename T>
+TextCache* TextListComponent<T>::getTextCache(const std::string& name)
+{
+	auto it = mTextCacheLookup.find(name);
+	if(it != mTextCacheLookup.end())
+	{
+		// move it to the front so it's the last to be dropped
+		mTextCaches.splice(mTextCaches.begin(), mTextCaches, it->second);
+		return it->second->second.get();
+	}
+
+	// colour is applied when drawing, so the cache is built plain white
+	std::shared_ptr<TextCache> cache(mFont->buildTextCache(mUppercase ? strToUpper(name) : name, 0, 0, 0xFFFFFFFF));
+	mTextCaches.push_front(std::make_pair(name, cache));
+	mTextCacheLookup[name] = mTextCaches.begin();
+
+	while(mTextCaches.size() > mMaxTextCaches)
+	{
+		mTextCacheLookup.erase(mTextCaches.back().first);
+		mTextCaches.pop_back();
+	}
+
+	return cache.get();
+}
+
+template <typename T>
+void TextListComponent<T>::clearTextCaches()
+{
+	mTextCaches.clear();
+	mTextCacheLookup.clear();
+}
+
+template <typename T>
+void TextListComponent<T>::render(const Eigen::Affine3f& parentTrans)
+{
+	Eigen::Affine3f trans = parentTrans * getTransform();
+	
+	std::shared_ptr<Font>& font = mFont;
+
+	if(size() == 0)
+		return;
+
+	const float entrySize = round(font->getHeight(mLineSpacing));
+
+	int startEntry;
+	int listCutoff;
+	getVisibleRange(startEntry, listCutoff);
+
+	// keep enough caches around for a few screens of rows plus the ones built ahead while scrolling
+	mMaxTextCaches = (listCutoff - startEntry) * TEXT_CACHE_SCREENS + PREBUILD_ROWS;
+
+	float y = 0;
 
 	// draw selector bar
 	if(startEntry < listCutoff)
@@ -180,10 +241,7 @@ void TextListComponent<T>::render(const Eigen::Affine3f& parentTrans)
 		else
 			color = mColors[entry.data.colorId];
 
-		if(!entry.data.textCache)
-			entry.data.textCache = std::unique_ptr<TextCache>(font->buildTextCache(mUppercase ? strToUpper(entry.name) : entry.name, 0, 0, 0x000000FF));
-
-		entry.data.textCache->setColor(color);
+		TextCache* textCache = getTextCache(entry.name);
 
 		Eigen::Vector3f offset(0, y, 0);
 
@@ -193,12 +251,12 @@ void TextListComponent<T>::render(const Eigen::Affine3f& parentTrans)
 			offset[0] = mHorizontalMargin;
 			break;
 		case ALIGN_CENTER:
-			offset[0] = (mSize.x() - entry.data.textCache->metrics.size.x()) / 2;
+			offset[0] = (mSize.x() - textCache->metrics.size.x()) / 2;
 			if(offset[0] < 0)
 				offset[0] = 0;
 			break;
 		case ALIGN_RIGHT:
-			offset[0] = (mSize.x() - entry.data.textCache->metrics.size.x());
+			offset[0] = (mSize.x() - textCache->metrics.size.x());
 			offset[0] -= mHorizontalMargin;
 			if(offset[0] < 0)
 				offset[0] = 0;
@@ -212,7 +270,7 @@ void TextListComponent<T>::render(const Eigen::Affine3f& parentTrans)
 		drawTrans.translate(offset);
 		Renderer::setMatrix(drawTrans);
 
-		font->renderTextCache(entry.data.textCache.get());
+		font->renderTextCache(textCache, color);
 		
 		y += entrySize;
 	}
@@ -231,31 +289,31 @@ bool TextListComponent<T>::input(InputConfig* config, Input input)
 	{
 		if(input.value != 0)
 		{
-			if(config->isMappedTo("down", input))
+			if(config->isMappedTo(ACTION_DOWN, input))
 			{
 				listInput(1);
 				return true;
 			}
 
-			if(config->isMappedTo("up", input))
+			if(config->isMappedTo(ACTION_UP, input))
 			{
 				listInput(-1);
 				return true;
 			}
-			if(config->isMappedTo("pagedown", input))
+			if(config->isMappedTo(ACTION_PAGEDOWN, input))
 			{
 				listInput(10);
 				return true;
 			}
 
-			if(config->isMappedTo("pageup", input))
+			if(config->isMappedTo(ACTION_PAGEUP, input))
 			{
 				listInput(-10);
 				return true;
 			}
 		}else{
-			if(config->isMappedTo("down", input) || config->isMappedTo("up", input) || 
-				config->isMappedTo("pagedown", input) || config->isMappedTo("pageup", input))
+			if(config->isMappedTo(ACTION_DOWN, input) || config->isMappedTo(ACTION_UP, input) || 
+				config->isMappedTo(ACTION_PAGEDOWN, input) || config->isMappedTo(ACTION_PAGEUP, input))
 			{
 				stopScrolling();
 			}
@@ -269,6 +327,19 @@ template <typename T>
 void TextListComponent<T>::update(int deltaTime)
 {
 	listUpdate(deltaTime);
+
+	if(isScrolling() && size() > 0)
+	{
+		// build the rows that are about to scroll into view ahead of time
+		int startEntry;
+		int listCutoff;
+		getVisibleRange(startEntry, listCutoff);
+
+		const int dir = mScrollVelocity > 0 ? 1 : -1;
+		int i = dir > 0 ? listCutoff : startEntry - 1;
+		for(int n = 0; n < PREBUILD_ROWS && i >= 0 && i < size(); n++, i += dir)
+			getTextCache(mEntries.at((unsigned int)i).name);
+	}
 	if(!isScrolling() && size() > 0)
 	{
 		//if we're not scrolling and this object's text goes outside our size, marquee it!
@@ -326,26 +397,26 @@ void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, c
 	using namespace ThemeFlags;
 	if(properties & COLOR)
 	{
-		if(elem->has("selectorColor"))
-			setSelectorColor(elem->get<unsigned int>("selectorColor"));
-		if(elem->has("selectedColor"))
-			setSelectedColor(elem->get<unsigned int>("selectedColor"));
-		if(elem->has("primaryColor"))
-			setColor(0, elem->get<unsigned int>("primaryColor"));
-		if(elem->has("secondaryColor"))
-			setColor(1, elem->get<unsigned int>("secondaryColor"));
+		if(elem->has(ThemeProperty::SELECTOR_COLOR))
+			setSelectorColor(elem->get<unsigned int>(ThemeProperty::SELECTOR_COLOR));
+		if(elem->has(ThemeProperty::SELECTED_COLOR))
+			setSelectedColor(elem->get<unsigned int>(ThemeProperty::SELECTED_COLOR));
+		if(elem->has(ThemeProperty::PRIMARY_COLOR))
+			setColor(0, elem->get<unsigned int>(ThemeProperty::PRIMARY_COLOR));
+		if(elem->has(ThemeProperty::SECONDARY_COLOR))
+			setColor(1, elem->get<unsigned int>(ThemeProperty::SECONDARY_COLOR));
 	}
 
 	setFont(Font::getFromTheme(elem, properties, mFont));
 	
-	if(properties & SOUND && elem->has("scrollSound"))
-		setSound(Sound::get(elem->get<std::string>("scrollSound")));
+	if(properties & SOUND && elem->has(ThemeProperty::SCROLL_SOUND))
+		setSound(Sound::get(elem->get<std::string>(ThemeProperty::SCROLL_SOUND)));
 
 	if(properties & ALIGNMENT)
 	{
-		if(elem->has("alignment"))
+		if(elem->has(ThemeProperty::ALIGNMENT))
 		{
-			const std::string& str = elem->get<std::string>("alignment");
+			const std::string& str = elem->get<std::string>(ThemeProperty::ALIGNMENT);
 			if(str == "left")
 				setAlignment(ALIGN_LEFT);
 			else if(str == "center")
@@ -355,15 +426,15 @@ void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, c
 			else
 				LOG(LogError) << "Unknown TextListComponent alignment \"" << str << "\"!";
 		}
-		if(elem->has("horizontalMargin"))
+		if(elem->has(ThemeProperty::HORIZONTAL_MARGIN))
 		{
-			mHorizontalMargin = elem->get<float>("horizontalMargin") * (this->mParent ? this->mParent->getSize().x() : (float)Renderer::getScreenWidth());
+			mHorizontalMargin = elem->get<float>(ThemeProperty::HORIZONTAL_MARGIN) * (this->mParent ? this->mParent->getSize().x() : (float)Renderer::getScreenWidth());
 		}
 	}
 
-	if(properties & FORCE_UPPERCASE && elem->has("forceUppercase"))
-		setUppercase(elem->get<bool>("forceUppercase"));
+	if(properties & FORCE_UPPERCASE && elem->has(ThemeProperty::FORCE_UPPERCASE))
+		setUppercase(elem->get<bool>(ThemeProperty::FORCE_UPPERCASE));
 
-	if(properties & LINE_SPACING && elem->has("lineSpacing"))
-		setLineSpacing(elem->get<float>("lineSpacing"));
+	if(properties & LINE_SPACING && elem->has(ThemeProperty::LINE_SPACING))
+		setLineSpacing(elem->get<float>(ThemeProperty::LINE_SPACING));
 }
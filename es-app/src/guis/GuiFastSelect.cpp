@@ -45,7 +45,7 @@ GuiFastSelect::GuiFastSelect(Window* window, IGameListView* gamelist) : GuiCompo
 
 bool GuiFastSelect::input(InputConfig* config, Input input)
 {
-	if(input.value == 0 && config->isMappedTo("select", input))
+	if(input.value == 0 && config->isMappedTo(ACTION_SELECT, input))
 	{
 		// the user let go of select; make our changes to the gamelist and close this gui
 		updateGameListSort();
@@ -54,7 +54,7 @@ bool GuiFastSelect::input(InputConfig* config, Input input)
 		return true;
 	}
 
-	if(config->isMappedTo("up", input))
+	if(config->isMappedTo(ACTION_UP, input))
 	{
 		if(input.value != 0)
 			setScrollDir(-1);
@@ -62,7 +62,7 @@ bool GuiFastSelect::input(InputConfig* config, Input input)
 			setScrollDir(0);
 
 		return true;
-	}else if(config->isMappedTo("down", input))
+	}else if(config->isMappedTo(ACTION_DOWN, input))
 	{
 		if(input.value != 0)
 			setScrollDir(1);
@@ -70,12 +70,12 @@ bool GuiFastSelect::input(InputConfig* config, Input input)
 			setScrollDir(0);
 
 		return true;
-	}else if(config->isMappedTo("left", input) && input.value != 0)
+	}else if(config->isMappedTo(ACTION_LEFT, input) && input.value != 0)
 	{
 		mSortId = (mSortId + 1) % FileSorts::SortTypes.size();
 		updateSortText();
 		return true;
-	}else if(config->isMappedTo("right", input) && input.value != 0)
+	}else if(config->isMappedTo(ACTION_RIGHT, input) && input.value != 0)
 	{
 		mSortId--;
 		if(mSortId < 0)
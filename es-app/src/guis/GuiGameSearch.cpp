@@ -0,0 +1,120 @@
+#include "guis/GuiGameSearch.h"
+#include "GameSearchIndex.h"
+#include "SystemData.h"
+#include "Renderer.h"
+#include "Log.h"
+#include "Util.h"
+#include "views/ViewController.h"
+#include <chrono>
+
+#define SEARCH_MAX_RESULTS 50
+
+using namespace Eigen;
+
+GuiGameSearch::GuiGameSearch(Window* window, SystemData* system) : GuiComponent(window),
+	mBackground(window, ":/frame.png"), mGrid(window, Vector2i(1, 3)), mSystem(system)
+{
+	addChild(&mBackground);
+	addChild(&mGrid);
+
+	mTitle = std::make_shared<TextComponent>(mWindow, "SEARCH " + strToUpper(system->getFullName()), Font::get(FONT_SIZE_LARGE), 0x555555FF, ALIGN_CENTER);
+	mText = std::make_shared<TextEditComponent>(mWindow);
+	mList = std::make_shared<ComponentList>(mWindow);
+
+	mGrid.setEntry(mTitle, Vector2i(0, 0), false, true);
+	mGrid.setEntry(mText, Vector2i(0, 1), true, false, Vector2i(1, 1), GridFlags::BORDER_TOP | GridFlags::BORDER_BOTTOM);
+	mGrid.setEntry(mList, Vector2i(0, 2), true, true);
+
+	setSize(Renderer::getScreenWidth() * 0.6f, Renderer::getScreenHeight() * 0.8f);
+	setPosition((Renderer::getScreenWidth() - mSize.x()) / 2, (Renderer::getScreenHeight() - mSize.y()) / 2);
+
+	// start typing straight away
+	mText->startEditing();
+}
+
+GuiGameSearch::~GuiGameSearch()
+{
+	if(mText->isEditing())
+		mText->stopEditing();
+}
+
+void GuiGameSearch::onSizeChanged()
+{
+	mBackground.fitTo(mSize, Eigen::Vector3f::Zero(), Eigen::Vector2f(-32, -32));
+
+	mText->setSize(mSize.x() - 40, mText->getFont()->getHeight());
+
+	mGrid.setRowHeightPerc(0, mTitle->getFont()->getHeight() / mSize.y());
+	mGrid.setRowHeightPerc(1, (mText->getSize().y() + 16) / mSize.y());
+	mGrid.setSize(mSize);
+}
+
+void GuiGameSearch::textInput(const char* text)
+{
+	GuiComponent::textInput(text);
+
+	if(mText->getValue() != mQuery)
+	{
+		mQuery = mText->getValue();
+		updateResults();
+	}
+}
+
+void GuiGameSearch::updateResults()
+{
+	mList->clear();
+	if(mQuery.empty())
+		return;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<FileData*> results = mSystem->getSearchIndex()->search(mQuery, SEARCH_MAX_RESULTS);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	LOG(LogDebug) << "Search for \"" << mQuery << "\" found " << results.size() << " games in "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "us";
+
+	for(auto it = results.begin(); it != results.end(); it++)
+	{
+		FileData* file = *it;
+
+		ComponentListRow row;
+		row.addElement(std::make_shared<TextComponent>(mWindow, file->getName(), Font::get(FONT_SIZE_MEDIUM), 0x777777FF), true);
+		row.makeAcceptInputHandler([this, file] { select(file); });
+		mList->addRow(row);
+	}
+}
+
+void GuiGameSearch::select(FileData* file)
+{
+	ViewController::get()->getGameListView(mSystem)->setCursor(file);
+	delete this;
+}
+
+bool GuiGameSearch::input(InputConfig* config, Input input)
+{
+	// let the results be browsed without having to leave the text box first
+	if(mText->isEditing() && input.value && mList->size() > 0 && config->isMappedTo(ACTION_DOWN, input))
+	{
+		mText->stopEditing();
+		mGrid.setCursorTo(mList);
+		return true;
+	}
+
+	if(GuiComponent::input(config, input))
+		return true;
+
+	if(config->isMappedTo(ACTION_B, input) && input.value)
+	{
+		delete this;
+		return true;
+	}
+
+	return false;
+}
+
+std::vector<HelpPrompt> GuiGameSearch::getHelpPrompts()
+{
+	std::vector<HelpPrompt> prompts = mGrid.getHelpPrompts();
+	prompts.push_back(HelpPrompt("b", "close"));
+	return prompts;
+}
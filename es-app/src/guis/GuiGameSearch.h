@@ -0,0 +1,39 @@
+#pragma once
+
+#include "GuiComponent.h"
+#include "components/NinePatchComponent.h"
+#include "components/ComponentGrid.h"
+#include "components/ComponentList.h"
+#include "components/TextEditComponent.h"
+#include "components/TextComponent.h"
+
+class SystemData;
+class FileData;
+
+// Overlay that filters a system's games on every keystroke using its GameSearchIndex.
+// Picking a result moves the gamelist cursor to that game.
+class GuiGameSearch : public GuiComponent
+{
+public:
+	GuiGameSearch(Window* window, SystemData* system);
+	~GuiGameSearch();
+
+	bool input(InputConfig* config, Input input) override;
+	void textInput(const char* text) override;
+	void onSizeChanged() override;
+	std::vector<HelpPrompt> getHelpPrompts() override;
+
+private:
+	void updateResults();
+	void select(FileData* file);
+
+	NinePatchComponent mBackground;
+	ComponentGrid mGrid;
+
+	std::shared_ptr<TextComponent> mTitle;
+	std::shared_ptr<TextEditComponent> mText;
+	std::shared_ptr<ComponentList> mList;
+
+	SystemData* mSystem;
+	std::string mQuery;
+};
@@ -1,5 +1,6 @@
 #include "GuiGamelistOptions.h"
 #include "GuiMetaDataEd.h"
+#include "GuiGameSearch.h"
 #include "views/gamelist/IGameListView.h"
 #include "views/ViewController.h"
 
@@ -9,6 +10,13 @@ GuiGamelistOptions::GuiGamelistOptions(Window* window, SystemData* system) : Gui
 {
 	addChild(&mMenu);
 
+	// search
+	ComponentListRow row;
+	row.addElement(std::make_shared<TextComponent>(mWindow, "SEARCH GAMES", Font::get(FONT_SIZE_MEDIUM), 0x777777FF), true);
+	row.addElement(makeArrow(mWindow), false);
+	row.makeAcceptInputHandler(std::bind(&GuiGamelistOptions::openSearch, this));
+	mMenu.addRow(row);
+
 	// jump to letter
 	char curChar = toupper(getGamelist()->getCursor()->getName()[0]);
 	if(curChar < 'A' || curChar > 'Z')
@@ -18,11 +26,11 @@ GuiGamelistOptions::GuiGamelistOptions(Window* window, SystemData* system) : Gui
 	for(char c = 'A'; c <= 'Z'; c++)
 		mJumpToLetterList->add(std::string(1, c), c, c == curChar);
 
-	ComponentListRow row;
+	row.elements.clear();
 	row.addElement(std::make_shared<TextComponent>(mWindow, "JUMP TO LETTER", Font::get(FONT_SIZE_MEDIUM), 0x777777FF), true);
 	row.addElement(mJumpToLetterList, false);
 	row.input_handler = [&](InputConfig* config, Input input) {
-		if(config->isMappedTo("a", input) && input.value)
+		if(config->isMappedTo(ACTION_A, input) && input.value)
 		{
 			jumpToLetter();
 			return true;
@@ -80,6 +88,12 @@ void GuiGamelistOptions::openMetaDataEd()
 	}));
 }
 
+void GuiGamelistOptions::openSearch()
+{
+	mWindow->pushGui(new GuiGameSearch(mWindow, mSystem));
+	delete this;
+}
+
 void GuiGamelistOptions::jumpToLetter()
 {
 	char letter = mJumpToLetterList->getSelected();
@@ -117,7 +131,7 @@ void GuiGamelistOptions::jumpToLetter()
 
 bool GuiGamelistOptions::input(InputConfig* config, Input input)
 {
-	if((config->isMappedTo("b", input) || config->isMappedTo("select", input)) && input.value)
+	if((config->isMappedTo(ACTION_B, input) || config->isMappedTo(ACTION_SELECT, input)) && input.value)
 	{
 		delete this;
 		return true;
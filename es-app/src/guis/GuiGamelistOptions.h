@@ -16,6 +16,7 @@ public:
 
 private:
 	void openMetaDataEd();
+	void openSearch();
 	void jumpToLetter();
 	
 	MenuComponent mMenu;
@@ -50,6 +50,34 @@ GuiMenu::GuiMenu(Window* window) : GuiComponent(window), mMenu(window, "MAIN MEN
 			s->addWithLabel("SCRAPE RATINGS", scrape_ratings);
 			s->addSaveFunc([scrape_ratings] { Settings::getInstance()->setBool("ScrapeRatings", scrape_ratings->getState()); });
 
+			// smaller copy of each image for the grid and video views
+			auto scrape_thumbnails = std::make_shared<SwitchComponent>(mWindow);
+			scrape_thumbnails->setState(Settings::getInstance()->getBool("ScraperThumbnails"));
+			s->addWithLabel("SAVE THUMBNAILS", scrape_thumbnails);
+			s->addSaveFunc([scrape_thumbnails] { Settings::getInstance()->setBool("ScraperThumbnails", scrape_thumbnails->getState()); });
+
+			// automatic scraping runs several games at once
+			auto max_searches = std::make_shared<SliderComponent>(mWindow, 1.f, 16.f, 1.f, "");
+			max_searches->setValue((float)Settings::getInstance()->getInt("ScraperMaxSearches"));
+			s->addWithLabel("PARALLEL SEARCHES", max_searches);
+			s->addSaveFunc([max_searches] { Settings::getInstance()->setInt("ScraperMaxSearches", (int)round(max_searches->getValue())); });
+
+			auto max_downloads = std::make_shared<SliderComponent>(mWindow, 1.f, 16.f, 1.f, "");
+			max_downloads->setValue((float)Settings::getInstance()->getInt("ScraperMaxDownloads"));
+			s->addWithLabel("PARALLEL DOWNLOADS", max_downloads);
+			s->addSaveFunc([max_downloads] { Settings::getInstance()->setInt("ScraperMaxDownloads", (int)round(max_downloads->getValue())); });
+
+			auto request_rate = std::make_shared<SliderComponent>(mWindow, 1.f, 20.f, 1.f, "/s");
+			request_rate->setValue((float)Settings::getInstance()->getInt("ScraperRequestsPerSecond"));
+			s->addWithLabel("REQUESTS PER SITE", request_rate);
+			s->addSaveFunc([request_rate] { Settings::getInstance()->setInt("ScraperRequestsPerSecond", (int)round(request_rate->getValue())); });
+
+			// scraping again doesn't download what's still cached
+			auto http_cache = std::make_shared<SwitchComponent>(mWindow);
+			http_cache->setState(Settings::getInstance()->getBool("HttpCache"));
+			s->addWithLabel("CACHE DOWNLOADS", http_cache);
+			s->addSaveFunc([http_cache] { Settings::getInstance()->setBool("HttpCache", http_cache->getState()); });
+
 			// scrape now
 			ComponentListRow row;
 			std::function<void()> openAndSave = openScrapeNow;
@@ -178,12 +206,34 @@ GuiMenu::GuiMenu(Window* window) : GuiComponent(window), mMenu(window, "MAIN MEN
 			s->addWithLabel("PARSE GAMESLISTS ONLY", parse_gamelists);
 			s->addSaveFunc([parse_gamelists] { Settings::getInstance()->setBool("ParseGamelistOnly", parse_gamelists->getState()); });
 
+			auto preload_gamelists = std::make_shared<SwitchComponent>(mWindow);
+			preload_gamelists->setState(Settings::getInstance()->getBool("PreloadGameLists"));
+			s->addWithLabel("PRELOAD GAMELISTS AT STARTUP", preload_gamelists);
+			s->addSaveFunc([preload_gamelists] { Settings::getInstance()->setBool("PreloadGameLists", preload_gamelists->getState()); });
+
 			// maximum vram
 			auto max_vram = std::make_shared<SliderComponent>(mWindow, 0.f, 1000.f, 10.f, "Mb");
 			max_vram->setValue((float)(Settings::getInstance()->getInt("MaxVRAM")));
 			s->addWithLabel("VRAM LIMIT", max_vram);
 			s->addSaveFunc([max_vram] { Settings::getInstance()->setInt("MaxVRAM", (int)round(max_vram->getValue())); });
 
+			// memory for images loaded ahead of the gamelist cursor
+			auto prefetch_ram = std::make_shared<SliderComponent>(mWindow, 0.f, 200.f, 4.f, "Mb");
+			prefetch_ram->setValue((float)(Settings::getInstance()->getInt("PrefetchRAM")));
+			s->addWithLabel("IMAGE PREFETCH LIMIT", prefetch_ram);
+			s->addSaveFunc([prefetch_ram] { Settings::getInstance()->setInt("PrefetchRAM", (int)round(prefetch_ram->getValue())); });
+
+			// decoded images kept while a game runs
+			auto launch_ram = std::make_shared<SliderComponent>(mWindow, 0.f, 256.f, 8.f, "Mb");
+			launch_ram->setValue((float)(Settings::getInstance()->getInt("LaunchTextureRAM")));
+			s->addWithLabel("KEEP IMAGES DURING GAMES", launch_ram);
+			s->addSaveFunc([launch_ram] { Settings::getInstance()->setInt("LaunchTextureRAM", (int)round(launch_ram->getValue())); });
+
+			auto launch_snapshot = std::make_shared<SwitchComponent>(mWindow);
+			launch_snapshot->setState(Settings::getInstance()->getBool("LaunchTextureSnapshot"));
+			s->addWithLabel("MOVE KEPT IMAGES TO TMPFS", launch_snapshot);
+			s->addSaveFunc([launch_snapshot] { Settings::getInstance()->setBool("LaunchTextureSnapshot", launch_snapshot->getState()); });
+
 			mWindow->pushGui(s);
 	});
 
@@ -296,7 +346,7 @@ bool GuiMenu::input(InputConfig* config, Input input)
 	if(GuiComponent::input(config, input))
 		return true;
 
-	if((config->isMappedTo("b", input) || config->isMappedTo("start", input)) && input.value != 0)
+	if((config->isMappedTo(ACTION_B, input) || config->isMappedTo(ACTION_START, input)) && input.value != 0)
 	{
 		delete this;
 		return true;
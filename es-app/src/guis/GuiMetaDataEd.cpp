@@ -245,8 +245,8 @@ bool GuiMetaDataEd::input(InputConfig* config, Input input)
 	if(GuiComponent::input(config, input))
 		return true;
 
-	const bool isStart = config->isMappedTo("start", input);
-	if(input.value != 0 && (config->isMappedTo("b", input) || isStart))
+	const bool isStart = config->isMappedTo(ACTION_START, input);
+	if(input.value != 0 && (config->isMappedTo(ACTION_B, input) || isStart))
 	{
 		close(isStart);
 		return true;
@@ -9,12 +9,16 @@
 #include "components/ScraperSearchComponent.h"
 #include "components/MenuComponent.h" // for makeButtonGrid
 #include "guis/GuiMsgBox.h"
+#include <iomanip>
+
+// finished games listed in automatic mode
+#define RECENT_GAMES 8
 
 using namespace Eigen;
 
 GuiScraperMulti::GuiScraperMulti(Window* window, const std::queue<ScraperSearchParams>& searches, bool approveResults) : 
 	GuiComponent(window), mBackground(window, ":/frame.png"), mGrid(window, Vector2i(1, 5)), 
-	mSearchQueue(searches)
+	mSearchQueue(searches), mStartTime(std::chrono::steady_clock::now()), mFinished(false), mShownFinished(0)
 {
 	assert(mSearchQueue.size());
 
@@ -38,12 +42,21 @@ GuiScraperMulti::GuiScraperMulti(Window* window, const std::queue<ScraperSearchP
 	mSubtitle = std::make_shared<TextComponent>(mWindow, "subtitle text", Font::get(FONT_SIZE_SMALL), 0x888888FF, ALIGN_CENTER);
 	mGrid.setEntry(mSubtitle, Vector2i(0, 2), false, true);
 
-	mSearchComp = std::make_shared<ScraperSearchComponent>(mWindow, 
-		approveResults ? ScraperSearchComponent::ALWAYS_ACCEPT_MATCHING_CRC : ScraperSearchComponent::ALWAYS_ACCEPT_FIRST_RESULT);
-	mSearchComp->setAcceptCallback(std::bind(&GuiScraperMulti::acceptResult, this, std::placeholders::_1));
-	mSearchComp->setSkipCallback(std::bind(&GuiScraperMulti::skip, this));
-	mSearchComp->setCancelCallback(std::bind(&GuiScraperMulti::finish, this));
-	mGrid.setEntry(mSearchComp, Vector2i(0, 3), mSearchComp->getSearchType() != ScraperSearchComponent::ALWAYS_ACCEPT_FIRST_RESULT, true);
+	if(approveResults)
+	{
+		mSearchComp = std::make_shared<ScraperSearchComponent>(mWindow, ScraperSearchComponent::ALWAYS_ACCEPT_MATCHING_CRC);
+		mSearchComp->setAcceptCallback(std::bind(&GuiScraperMulti::acceptResult, this, std::placeholders::_1));
+		mSearchComp->setSkipCallback(std::bind(&GuiScraperMulti::skip, this));
+		mSearchComp->setCancelCallback(std::bind(&GuiScraperMulti::finish, this));
+		mGrid.setEntry(mSearchComp, Vector2i(0, 3), true, true);
+	}else{
+		// nothing to approve, so scrape as many games at once as the settings allow
+		mPipeline = std::unique_ptr<ScraperPipeline>(new ScraperPipeline(mSearchQueue));
+		mPipeline->setGameDoneCallback([this](const ScraperSearchParams& params, ScraperPipeline::GameResult result, const std::string&) { onGameDone(params, result); });
+
+		mRecentText = std::make_shared<TextComponent>(mWindow, "", Font::get(FONT_SIZE_SMALL), 0x777777FF, ALIGN_CENTER);
+		mGrid.setEntry(mRecentText, Vector2i(0, 3), false, true);
+	}
 
 	std::vector< std::shared_ptr<ButtonComponent> > buttons;
 
@@ -68,7 +81,10 @@ GuiScraperMulti::GuiScraperMulti(Window* window, const std::queue<ScraperSearchP
 	setSize(Renderer::getScreenWidth() * 0.95f, Renderer::getScreenHeight() * 0.849f);
 	setPosition((Renderer::getScreenWidth() - mSize.x()) / 2, (Renderer::getScreenHeight() - mSize.y()) / 2);
 
-	doNextSearch();
+	if(mPipeline)
+		updatePipelineStatus();
+	else
+		doNextSearch();
 }
 
 GuiScraperMulti::~GuiScraperMulti()
@@ -78,6 +94,23 @@ GuiScraperMulti::~GuiScraperMulti()
 		ViewController::get()->reloadGameListView(*it, false);
 }
 
+void GuiScraperMulti::update(int deltaTime)
+{
+	GuiComponent::update(deltaTime);
+
+	if(!mPipeline || mFinished)
+		return;
+
+	mPipeline->update();
+
+	// the text only needs rebuilding when a game finished
+	if(mPipeline->getFinished() != mShownFinished)
+		updatePipelineStatus();
+
+	if(mPipeline->isDone())
+		finish();
+}
+
 void GuiScraperMulti::onSizeChanged()
 {
 	mBackground.fitTo(mSize, Vector3f::Zero(), Vector2f(-32, -32));
@@ -104,6 +137,8 @@ void GuiScraperMulti::doNextSearch()
 	// update subtitle
 	ss.str(""); // clear
 	ss << "GAME " << (mCurrentGame + 1) << " OF " << mTotalGames << " - " << strToUpper(mSearchQueue.front().game->getPath().filename().string());
+	if(mCurrentGame > 0)
+		ss << " - " << std::fixed << std::setprecision(1) << getGamesPerMinute() << " GAMES/MIN";
 	mSubtitle->setText(ss.str());
 
 	mSearchComp->search(mSearchQueue.front());
@@ -114,7 +149,7 @@ void GuiScraperMulti::acceptResult(const ScraperSearchResult& result)
 	ScraperSearchParams& search = mSearchQueue.front();
 
 	search.game->metadata = result.mdl;
-	updateGamelist(search.system);
+	mDirtySystems.insert(search.system); // written all at once in finish()
 
 	mSearchQueue.pop();
 	mCurrentGame++;
@@ -130,8 +165,76 @@ void GuiScraperMulti::skip()
 	doNextSearch();
 }
 
+void GuiScraperMulti::onGameDone(const ScraperSearchParams& params, ScraperPipeline::GameResult result)
+{
+	std::string line;
+	switch(result)
+	{
+	case ScraperPipeline::GAME_SCRAPED:
+		line = "SCRAPED: ";
+		break;
+	case ScraperPipeline::GAME_SKIPPED:
+		line = "NO RESULTS: ";
+		break;
+	case ScraperPipeline::GAME_FAILED:
+		line = "FAILED: ";
+		break;
+	}
+	line += strToUpper(params.game->getPath().filename().string());
+
+	mRecentGames.push_front(line);
+	if(mRecentGames.size() > RECENT_GAMES)
+		mRecentGames.pop_back();
+
+	mSystem->setText(strToUpper(params.system->getFullName()));
+}
+
+void GuiScraperMulti::updatePipelineStatus()
+{
+	mShownFinished = mPipeline->getFinished();
+	mCurrentGame = mShownFinished;
+	mTotalSuccessful = mPipeline->getScraped();
+	mTotalSkipped = mPipeline->getSkipped() + mPipeline->getFailed();
+
+	std::stringstream ss;
+	ss << "GAME " << mShownFinished << " OF " << mTotalGames << " - " << mPipeline->getInFlight() << " IN PROGRESS";
+	if(mShownFinished > 0)
+		ss << " - " << std::fixed << std::setprecision(1) << mPipeline->getGamesPerMinute() << " GAMES/MIN";
+	mSubtitle->setText(ss.str());
+
+	ss.str("");
+	for(auto it = mRecentGames.begin(); it != mRecentGames.end(); it++)
+		ss << *it << "\n";
+	mRecentText->setText(ss.str());
+}
+
+float GuiScraperMulti::getGamesPerMinute() const
+{
+	const float minutes = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStartTime).count() / 60000.0f;
+	return minutes > 0 ? mCurrentGame / minutes : 0;
+}
+
 void GuiScraperMulti::finish()
 {
+	if(mFinished)
+		return;
+	mFinished = true;
+
+	// one write per system, whether we're done or were stopped
+	if(mPipeline)
+	{
+		mPipeline->stop();
+		updatePipelineStatus();
+	}
+
+	for(auto it = mDirtySystems.begin(); it != mDirtySystems.end(); it++)
+		updateGamelist(*it);
+	mDirtySystems.clear();
+
+	const float gamesPerMinute = mPipeline ? mPipeline->getGamesPerMinute() : getGamesPerMinute();
+	LOG(LogInfo) << "Scraping finished: " << mTotalSuccessful << " scraped, " << mTotalSkipped << " skipped of " << mTotalGames
+		<< " games, " << gamesPerMinute << " games per minute";
+
 	std::stringstream ss;
 	if(mTotalSuccessful == 0)
 	{
@@ -141,6 +244,8 @@ void GuiScraperMulti::finish()
 
 		if(mTotalSkipped > 0)
 			ss << "\n" << mTotalSkipped << " GAME" << ((mTotalSkipped > 1) ? "S" : "") << " SKIPPED.";
+
+		ss << "\n" << std::fixed << std::setprecision(1) << gamesPerMinute << " GAMES PER MINUTE.";
 	}
 
 	mWindow->pushGui(new GuiMsgBox(mWindow, ss.str(), 
@@ -4,8 +4,12 @@
 #include "components/NinePatchComponent.h"
 #include "components/ComponentGrid.h"
 #include "scrapers/Scraper.h"
+#include "scrapers/ScraperPipeline.h"
 
 #include <queue>
+#include <deque>
+#include <set>
+#include <chrono>
 
 class ScraperSearchComponent;
 class TextComponent;
@@ -16,14 +20,21 @@ public:
 	GuiScraperMulti(Window* window, const std::queue<ScraperSearchParams>& searches, bool approveResults);
 	virtual ~GuiScraperMulti();
 
+	void update(int deltaTime) override;
 	void onSizeChanged() override;
 	std::vector<HelpPrompt> getHelpPrompts() override;
 
 private:
+	// results approved one at a time
 	void acceptResult(const ScraperSearchResult& result);
 	void skip();
 	void doNextSearch();
-	
+
+	// automatic mode, everything runs through mPipeline
+	void onGameDone(const ScraperSearchParams& params, ScraperPipeline::GameResult result);
+	void updatePipelineStatus();
+
+	float getGamesPerMinute() const;
 	void finish();
 
 	unsigned int mTotalGames;
@@ -31,6 +42,13 @@ private:
 	unsigned int mTotalSuccessful;
 	unsigned int mTotalSkipped;
 	std::queue<ScraperSearchParams> mSearchQueue;
+	std::set<SystemData*> mDirtySystems; // gamelists to write once we're done
+	std::chrono::steady_clock::time_point mStartTime;
+	bool mFinished;
+
+	std::unique_ptr<ScraperPipeline> mPipeline;
+	unsigned int mShownFinished; // pipeline progress the texts were last updated for
+	std::deque<std::string> mRecentGames;
 
 	NinePatchComponent mBackground;
 	ComponentGrid mGrid;
@@ -38,6 +56,7 @@ private:
 	std::shared_ptr<TextComponent> mTitle;
 	std::shared_ptr<TextComponent> mSystem;
 	std::shared_ptr<TextComponent> mSubtitle;
-	std::shared_ptr<ScraperSearchComponent> mSearchComp;
+	std::shared_ptr<ScraperSearchComponent> mSearchComp; // when approving results
+	std::shared_ptr<TextComponent> mRecentText; // automatic mode
 	std::shared_ptr<ComponentGrid> mButtonGrid;
 };
@@ -100,13 +100,13 @@ bool GuiScraperStart::input(InputConfig* config, Input input)
 	if(consumed)
 		return true;
 	
-	if(input.value != 0 && config->isMappedTo("b", input))
+	if(input.value != 0 && config->isMappedTo(ACTION_B, input))
 	{
 		delete this;
 		return true;
 	}
 
-	if(config->isMappedTo("start", input) && input.value != 0)
+	if(config->isMappedTo(ACTION_START, input) && input.value != 0)
 	{
 		// close everything
 		Window* window = mWindow;
@@ -31,13 +31,13 @@ void GuiSettings::save()
 
 bool GuiSettings::input(InputConfig* config, Input input)
 {
-	if(config->isMappedTo("b", input) && input.value != 0)
+	if(config->isMappedTo(ACTION_B, input) && input.value != 0)
 	{
 		delete this;
 		return true;
 	}
 
-	if(config->isMappedTo("start", input) && input.value != 0)
+	if(config->isMappedTo(ACTION_START, input) && input.value != 0)
 	{
 		// close everything
 		Window* window = mWindow;
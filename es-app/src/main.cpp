@@ -17,7 +17,15 @@
 #include "EmulationStation.h"
 #include "Settings.h"
 #include "ScraperCmdLine.h"
+#include "InputRecorder.h"
+#include "resources/TextureData.h"
+#include "FileSorts.h"
+#include "RomHashCache.h"
+#include "ThemeData.h"
 #include <sstream>
+#include <set>
+#include <map>
+#include <chrono>
 #include <boost/locale.hpp>
 
 #ifdef WIN32
@@ -27,6 +35,14 @@
 namespace fs = boost::filesystem;
 
 bool scrape_cmdline = false;
+ScraperCmdLineOptions scrape_options;
+std::string record_input_path;
+std::string replay_input_path;
+int replay_frame_time = 16;
+bool benchmark_svg = false;
+bool benchmark_sort = false;
+bool benchmark_themes = false;
+bool hash_roms = false;
 
 bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height)
 {
@@ -74,10 +90,114 @@ bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height
 		}else if(strcmp(argv[i], "--scrape") == 0)
 		{
 			scrape_cmdline = true;
+		}else if(strcmp(argv[i], "--scrape-systems") == 0)
+		{
+			if(i >= argc - 1)
+			{
+				std::cerr << "No systems supplied.";
+				return false;
+			}
+
+			std::stringstream ss(argv[i + 1]);
+			std::string name;
+			while(std::getline(ss, name, ','))
+			{
+				if(!name.empty())
+					scrape_options.systems.push_back(name);
+			}
+			i++; // skip the list
+		}else if(strcmp(argv[i], "--scrape-filter") == 0)
+		{
+			if(i >= argc - 1 || (strcmp(argv[i + 1], "all") != 0 && strcmp(argv[i + 1], "missing") != 0))
+			{
+				std::cerr << "Invalid scrape filter supplied, use all or missing.";
+				return false;
+			}
+
+			scrape_options.missingOnly = strcmp(argv[i + 1], "missing") == 0;
+			i++; // skip the filter
+		}else if(strcmp(argv[i], "--scrape-mode") == 0)
+		{
+			if(i >= argc - 1 || (strcmp(argv[i + 1], "first") != 0 && strcmp(argv[i + 1], "single") != 0))
+			{
+				std::cerr << "Invalid scrape mode supplied, use first or single.";
+				return false;
+			}
+
+			scrape_options.singleResultOnly = strcmp(argv[i + 1], "single") == 0;
+			i++; // skip the mode
+		}else if(strcmp(argv[i], "--scrape-threads") == 0)
+		{
+			if(i >= argc - 1 || atoi(argv[i + 1]) <= 0)
+			{
+				std::cerr << "Invalid scrape thread count supplied.";
+				return false;
+			}
+
+			scrape_options.threads = atoi(argv[i + 1]);
+			i++; // skip the count
+		}else if(strcmp(argv[i], "--scrape-checkpoint") == 0)
+		{
+			if(i >= argc - 1)
+			{
+				std::cerr << "No checkpoint path supplied.";
+				return false;
+			}
+
+			scrape_options.checkpointPath = argv[i + 1];
+			i++; // skip the path
+		}else if(strcmp(argv[i], "--scrape-restart") == 0)
+		{
+			scrape_options.restart = true;
+		}else if(strcmp(argv[i], "--offline") == 0)
+		{
+			Settings::getInstance()->setBool("HttpCacheOffline", true);
 		}else if(strcmp(argv[i], "--max-vram") == 0)
 		{
 			int maxVRAM = atoi(argv[i + 1]);
 			Settings::getInstance()->setInt("MaxVRAM", maxVRAM);
+		}else if(strcmp(argv[i], "--record-input") == 0)
+		{
+			if(i >= argc - 1)
+			{
+				std::cerr << "No input log path supplied.";
+				return false;
+			}
+
+			record_input_path = argv[i + 1];
+			i++; // skip the path
+		}else if(strcmp(argv[i], "--replay-input") == 0)
+		{
+			if(i >= argc - 1)
+			{
+				std::cerr << "No input log path supplied.";
+				return false;
+			}
+
+			replay_input_path = argv[i + 1];
+			i++; // skip the path
+		}else if(strcmp(argv[i], "--replay-frametime") == 0)
+		{
+			if(i >= argc - 1)
+			{
+				std::cerr << "Invalid frame time supplied.";
+				return false;
+			}
+
+			replay_frame_time = atoi(argv[i + 1]);
+			i++; // skip the frame time
+		}else if(strcmp(argv[i], "--benchmark-svg") == 0)
+		{
+			benchmark_svg = true;
+		}else if(strcmp(argv[i], "--benchmark-sort") == 0)
+		{
+			benchmark_sort = true;
+		}else if(strcmp(argv[i], "--benchmark-themes") == 0)
+		{
+			benchmark_themes = true;
+		}else if(strcmp(argv[i], "--hash-roms") == 0)
+		{
+			hash_roms = true;
 		}else if(strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
 		{
 #ifdef WIN32
@@ -100,10 +220,24 @@ bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height
 				"--no-exit			don't show the exit option in the menu\n"
 				"--no-splash			don't show the splash screen\n"
 				"--debug				more logging, show console on Windows\n"
-				"--scrape			scrape using command line interface\n"
+				"--scrape			scrape without a window, print a JSON summary to stdout and exit\n"
+				"--scrape-systems [a,b,...]	systems to scrape (default is every system with a platform)\n"
+				"--scrape-filter [all/missing]	scrape all games or only those missing an image (default missing)\n"
+				"--scrape-mode [first/single]	take the first result, or skip games with more than one (default first)\n"
+				"--scrape-threads [count]	searches and downloads in flight at once\n"
+				"--scrape-checkpoint [file]	where progress is saved to resume from (default ~/.emulationstation/scrape_checkpoint.txt)\n"
+				"--scrape-restart		ignore the progress saved by an interrupted scrape\n"
+				"--offline			answer HTTP requests from the download cache only\n"
 				"--windowed			not fullscreen, should be used with --resolution\n"
 				"--vsync [1/on or 0/off]		turn vsync on or off (default is on)\n"
 				"--max-vram [size]		Max VRAM to use in Mb before swapping. 0 for unlimited\n"
+				"--record-input [file]		record all input to a log file for later replay\n"
+				"--replay-input [file]		replay a recorded input log, print frame timings and exit\n"
+				"--replay-frametime [ms]		fixed time step used by --replay-input (default 16)\n"
+				"--benchmark-svg			time rasterizing the built in SVGs, print the results and exit\n"
+				"--benchmark-sort		time sorting 50000 made up games, print the results and exit\n"
+				"--benchmark-themes		time loading the current theme set for every system, print the results and exit\n"
+				"--hash-roms			hash every game that changed since last time, list duplicates and exit\n"
 				"--help, -h			summon a sentient, angry tuba\n\n"
 				"More information available in README.md.\n";
 			return false; //exit after printing help
@@ -158,6 +292,50 @@ bool loadSystemConfigFile(const char** errorString)
 	return true;
 }
 
+// Brings the ROM hash cache up to date for every game and lists the files that have the same contents.
+int hashRoms()
+{
+	std::set<std::string> unique;
+	for(auto sys = SystemData::sSystemVector.begin(); sys != SystemData::sSystemVector.end(); sys++)
+	{
+		std::vector<FileData*> games = (*sys)->getRootFolder()->getFilesRecursive(GAME);
+		for(auto game = games.begin(); game != games.end(); game++)
+			unique.insert((*game)->getPath().string());
+	}
+	const std::vector<std::string> paths(unique.begin(), unique.end());
+
+	RomHashCache* cache = RomHashCache::getInstance();
+	const auto start = std::chrono::steady_clock::now();
+	std::unordered_map<std::string, RomHashes> hashes;
+	const unsigned int hashed = cache->update(paths, &hashes);
+	const auto end = std::chrono::steady_clock::now();
+	cache->save();
+
+	std::cout << "Hashed " << hashed << " of " << paths.size() << " files in "
+		<< std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms, the others were unchanged.\n";
+
+	// files that couldn't be read aren't in hashes, they're not tried again here
+	std::map< std::string, std::vector<std::string> > bySha1;
+	for(auto it = paths.begin(); it != paths.end(); it++)
+	{
+		auto found = hashes.find(*it);
+		if(found != hashes.end())
+			bySha1[found->second.sha1].push_back(*it);
+	}
+
+	for(auto it = bySha1.begin(); it != bySha1.end(); it++)
+	{
+		if(it->second.size() < 2)
+			continue;
+
+		std::cout << "Duplicates (sha1 " << it->first << "):\n";
+		for(auto path = it->second.begin(); path != it->second.end(); path++)
+			std::cout << "  " << *path << "\n";
+	}
+
+	return 0;
+}
+
 //called on exit, assuming we get far enough to have the log initialized
 void onExit()
 {
@@ -219,11 +397,33 @@ int main(int argc, char* argv[])
 	//always close the log on exit
 	atexit(&onExit);
 
+	//only needs the CPU, so no window is created for it
+	if(benchmark_svg)
+	{
+		TextureData::benchmarkSVG();
+		return 0;
+	}
+
+	if(benchmark_sort)
+	{
+		FileSorts::benchmark(50000);
+		return 0;
+	}
+
+	if(benchmark_themes)
+	{
+		ThemeData::benchmark();
+		return 0;
+	}
+
+	// these only need the systems loaded
+	const bool headless = scrape_cmdline || hash_roms;
+
 	Window window;
 	ViewController::init(&window);
 	window.pushGui(ViewController::get());
 
-	if(!scrape_cmdline)
+	if(!headless)
 	{
 		if(!window.init(width, height))
 		{
@@ -245,11 +445,18 @@ int main(int argc, char* argv[])
 		if(errorMsg == NULL)
 		{
 			LOG(LogError) << "Unknown error occured while parsing system config file.";
-			if(!scrape_cmdline)
+			if(!headless)
 				Renderer::deinit();
 			return 1;
 		}
 
+		// nobody's there to read a message box
+		if(headless)
+		{
+			std::cerr << errorMsg << "\n";
+			return 1;
+		}
+
 		// we can't handle es_systems.cfg file problems inside ES itself, so display the error message then quit
 		window.pushGui(new GuiMsgBox(&window,
 			errorMsg,
@@ -263,15 +470,20 @@ int main(int argc, char* argv[])
 	//run the command line scraper then quit
 	if(scrape_cmdline)
 	{
-		return run_scraper_cmdline();
+		return run_scraper_cmdline(scrape_options);
 	}
 
+	if(hash_roms)
+		return hashRoms();
+
 	//dont generate joystick events while we're loading (hopefully fixes "automatically started emulator" bug)
 	SDL_JoystickEventState(SDL_DISABLE);
 
 	// preload what we can right away instead of waiting for the user to select it
 	// this makes for no delays when accessing content, but a longer startup time
-	ViewController::get()->preload();
+	// otherwise gamelist views are built on demand and in the background
+	if(Settings::getInstance()->getBool("PreloadGameLists"))
+		ViewController::get()->preload();
 
 	//choose which GUI to open depending on if an input configuration already exists
 	if(errorMsg == NULL)
@@ -287,9 +499,19 @@ int main(int argc, char* argv[])
 	//generate joystick events since we're done loading
 	SDL_JoystickEventState(SDL_ENABLE);
 
+	if(!record_input_path.empty())
+		InputRecorder::getInstance()->startRecording(record_input_path);
+
 	int lastTime = SDL_GetTicks();
 	bool running = true;
 
+	//replay a recorded session with a fixed time step instead of running interactively
+	if(!replay_input_path.empty())
+	{
+		InputRecorder::getInstance()->replay(replay_input_path, &window, replay_frame_time);
+		running = false;
+	}
+
 	while(running)
 	{
 		SDL_Event event;
@@ -333,10 +555,10 @@ int main(int argc, char* argv[])
 		window.update(deltaTime);
 		window.render();
 		Renderer::swapBuffers();
-
-		Log::flush();
 	}
 
+	InputRecorder::getInstance()->stopRecording();
+
 	while(window.peekGui() != ViewController::get())
 		delete window.peekGui();
 	window.deinit();
@@ -0,0 +1,270 @@
+#include "scrapers/LocalDatScraper.h"
+#include "GameSearchIndex.h"
+#include "RomHashCache.h"
+#include "ThreadPool.h"
+#include "Log.h"
+#include "platform.h"
+#include "Util.h"
+#include "pugixml/pugixml.hpp"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+
+namespace fs = boost::filesystem;
+
+// ROMs that haven't been hashed yet (by --hash-roms or an earlier search) are only read if they're at most this big,
+// so a search never stalls on a disc image, those are matched by name instead
+#define LOCAL_DAT_MAX_HASH_SIZE (64 * 1024 * 1024)
+
+void localdat_generate_scraper_requests(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests,
+	std::vector<ScraperSearchResult>& results)
+{
+	requests.push(std::unique_ptr<ScraperRequest>(new LocalDatRequest(results, params)));
+}
+
+LocalDatRequest::LocalDatRequest(std::vector<ScraperSearchResult>& resultsWrite, const ScraperSearchParams& params)
+	: ScraperRequest(resultsWrite), mState(std::make_shared<State>())
+{
+	setStatus(ASYNC_IN_PROGRESS);
+
+	DatQuery query;
+	if(params.nameOverride.empty())
+	{
+		query.path = params.game->getPath().generic_string();
+		query.stem = params.game->getPath().stem().string();
+	}
+	query.title = params.nameOverride.empty() ? params.game->getCleanName() : params.nameOverride;
+	query.platforms = params.system->getPlatformIds();
+
+	std::shared_ptr<State> state = mState;
+	ThreadPool::getInstance()->queueWorkItem([state, query] {
+		DatCatalogue::getInstance()->search(query, state->results);
+		state->done = true;
+	});
+}
+
+void LocalDatRequest::update()
+{
+	if(mStatus != ASYNC_IN_PROGRESS || !mState->done)
+		return;
+
+	mResults.insert(mResults.end(), mState->results.begin(), mState->results.end());
+	setStatus(ASYNC_DONE);
+}
+
+static std::string toLower(std::string str)
+{
+	for(auto it = str.begin(); it != str.end(); it++)
+	{
+		if(*it >= 'A' && *it <= 'Z')
+			*it += 'a' - 'A';
+	}
+	return str;
+}
+
+// "Super Mario World (USA) [!]" -> "Super Mario World"
+static std::string getTitle(const std::string& name)
+{
+	std::string title = removeParenthesis(name);
+
+	const size_t end = title.find_last_not_of(' ');
+	title.erase(end == std::string::npos ? 0 : end + 1);
+	return title;
+}
+
+DatCatalogue* DatCatalogue::getInstance()
+{
+	// first called from searches running on the thread pool, a function static is only ever created once
+	static DatCatalogue* instance = new DatCatalogue();
+	return instance;
+}
+
+void DatCatalogue::load()
+{
+	const fs::path dir = getHomePath() + "/.emulationstation/dats";
+	boost::system::error_code ec;
+	if(!fs::is_directory(dir, ec))
+	{
+		LOG(LogWarning) << "Local DAT scraper - no catalogue directory at " << dir.generic_string();
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	unsigned int files = 0;
+	for(fs::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+	{
+		const fs::path& path = it->path();
+		const std::string ext = toLower(path.extension().string());
+		if(!fs::is_regular_file(path, ec) || (ext != ".dat" && ext != ".xml"))
+			continue;
+
+		// snes.dat or snes/No-Intro whatever.dat
+		PlatformIds::PlatformId platform = PlatformIds::getPlatformId(toLower(path.stem().string()).c_str());
+		if(platform == PlatformIds::PLATFORM_UNKNOWN && path.parent_path() != dir)
+			platform = PlatformIds::getPlatformId(toLower(path.parent_path().filename().string()).c_str());
+
+		loadFile(path.generic_string(), platform);
+		files++;
+	}
+
+	std::sort(mByTitle.begin(), mByTitle.end());
+
+	auto end = std::chrono::steady_clock::now();
+	LOG(LogInfo) << "Local DAT scraper - " << mGames.size() << " games from " << files << " files indexed in "
+		<< std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms";
+}
+
+void DatCatalogue::loadFile(const std::string& path, PlatformIds::PlatformId platform)
+{
+	pugi::xml_document doc;
+	pugi::xml_parse_result result = doc.load_file(path.c_str());
+	if(!result)
+	{
+		LOG(LogError) << "Local DAT scraper - error parsing " << path << ": " << result.description();
+		return;
+	}
+
+	// <datafile> for DATs, <mame> for -listxml, entries are <game> or <machine>
+	pugi::xml_node root = doc.document_element();
+	for(pugi::xml_node node = root.first_child(); node; node = node.next_sibling())
+	{
+		if(strcmp(node.name(), "game") != 0 && strcmp(node.name(), "machine") != 0)
+			continue;
+
+		// BIOS sets and devices aren't something anyone has in a game list
+		if(node.attribute("isbios").as_bool() || node.attribute("isdevice").as_bool() || strcmp(node.attribute("runnable").as_string("yes"), "no") == 0)
+			continue;
+
+		const unsigned int index = (unsigned int)mGames.size();
+
+		Game game;
+		game.name = node.attribute("name").as_string();
+		game.title = getTitle(node.child("description") ? node.child_value("description") : game.name);
+		game.year = node.child_value("year");
+		game.manufacturer = node.child_value("manufacturer");
+		game.platform = platform;
+
+		if(game.name.empty() || game.title.empty())
+			continue;
+
+		// <disk> is a CHD, it only has a sha1
+		for(pugi::xml_node rom = node.first_child(); rom; rom = rom.next_sibling())
+		{
+			if(strcmp(rom.name(), "rom") != 0 && strcmp(rom.name(), "disk") != 0)
+				continue;
+
+			const char* crc = rom.attribute("crc").value();
+			if(*crc)
+				mByCrc.insert(std::make_pair((uint32_t)strtoul(crc, NULL, 16), index));
+			if(*rom.attribute("sha1").value())
+				mBySha1.insert(std::make_pair(toLower(rom.attribute("sha1").value()), index));
+			if(*rom.attribute("md5").value())
+				mByMd5.insert(std::make_pair(toLower(rom.attribute("md5").value()), index));
+		}
+
+		mByName.insert(std::make_pair(game.name, index));
+		mByTitle.push_back(std::make_pair(GameSearchIndex::normalize(game.title), index));
+		mGames.push_back(std::move(game));
+	}
+}
+
+bool DatCatalogue::matchesSystem(const Game& game, const std::vector<PlatformIds::PlatformId>& platforms) const
+{
+	return game.platform == PlatformIds::PLATFORM_UNKNOWN || platforms.empty() ||
+		std::find(platforms.begin(), platforms.end(), game.platform) != platforms.end();
+}
+
+void DatCatalogue::addResult(unsigned int game, std::vector<ScraperSearchResult>& results) const
+{
+	const Game& g = mGames.at(game);
+
+	ScraperSearchResult result;
+	result.mdl.set("name", g.title);
+
+	// MAME has years like "199?"
+	if(g.year.size() == 4 && g.year.find_first_not_of("0123456789") == std::string::npos)
+		result.mdl.setTime("releasedate", string_to_ptime(g.year + "0101", "%Y%m%d"));
+
+	if(!g.manufacturer.empty())
+	{
+		result.mdl.set("developer", g.manufacturer);
+		result.mdl.set("publisher", g.manufacturer);
+	}
+
+	results.push_back(result);
+}
+
+void DatCatalogue::search(const DatQuery& query, std::vector<ScraperSearchResult>& results)
+{
+	// the catalogue is only written by load(), searches after that just read it
+	std::call_once(mLoaded, [this] { load(); });
+
+	std::vector<unsigned int> matches;
+	auto addMatch = [&](unsigned int game)
+	{
+		if(matchesSystem(mGames[game], query.platforms) && std::find(matches.begin(), matches.end(), game) == matches.end())
+			matches.push_back(game);
+	};
+
+	if(!query.path.empty())
+	{
+		// the file's own hashes identify it exactly, then the CRCs of what's in it if it's a zip
+		RomHashes hashes;
+		if(RomHashCache::getInstance()->get(query.path, hashes, LOCAL_DAT_MAX_HASH_SIZE))
+		{
+			auto sha1 = mBySha1.equal_range(hashes.sha1);
+			for(auto it = sha1.first; it != sha1.second; it++)
+				addMatch(it->second);
+
+			auto md5 = mByMd5.equal_range(hashes.md5);
+			for(auto it = md5.first; it != md5.second; it++)
+				addMatch(it->second);
+
+			auto crc = mByCrc.equal_range(hashes.crc32);
+			for(auto it = crc.first; it != crc.second; it++)
+				addMatch(it->second);
+
+			// a MAME set is the game whose ROMs it has the most of
+			if(matches.empty() && !hashes.members.empty())
+			{
+				std::unordered_map<unsigned int, unsigned int> votes;
+				unsigned int best = 0;
+				for(auto member = hashes.members.begin(); member != hashes.members.end(); member++)
+				{
+					auto range = mByCrc.equal_range(member->crc32);
+					for(auto it = range.first; it != range.second; it++)
+					{
+						if(matchesSystem(mGames[it->second], query.platforms))
+							best = std::max(best, ++votes[it->second]);
+					}
+				}
+
+				for(auto it = votes.begin(); it != votes.end(); it++)
+				{
+					if(it->second == best)
+						addMatch(it->first);
+				}
+			}
+		}
+
+		// DAT names are the file names their ROMs are distributed under
+		auto named = mByName.equal_range(query.stem);
+		for(auto it = named.first; it != named.second; it++)
+			addMatch(it->second);
+	}
+
+	// the title as typed, or the file name without tags; exact matches sort first, then longer titles starting with it
+	const std::string title = GameSearchIndex::normalize(query.title);
+	if(!title.empty())
+	{
+		auto it = std::lower_bound(mByTitle.begin(), mByTitle.end(), std::make_pair(title, 0u));
+		for(; it != mByTitle.end() && matches.size() < MAX_SCRAPER_RESULTS && it->first.compare(0, title.size(), title) == 0; it++)
+			addMatch(it->second);
+	}
+
+	for(unsigned int i = 0; i < matches.size() && results.size() < MAX_SCRAPER_RESULTS; i++)
+		addResult(matches[i], results);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "scrapers/Scraper.h"
+#include "PlatformId.h"
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+// Queues one LocalDatRequest, the search itself runs on the thread pool.
+void localdat_generate_scraper_requests(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests,
+	std::vector<ScraperSearchResult>& results);
+
+// What a search needs to know about the game, copied on the UI thread so the search doesn't touch the FileData.
+struct DatQuery
+{
+	std::string path; // empty when searching by nameOverride, the file isn't looked at then
+	std::string stem;
+	std::string title;
+	std::vector<PlatformIds::PlatformId> platforms;
+};
+
+// Searches the catalogue on the thread pool, as the first search loads every DAT and a search may have to hash
+// the ROM. Done once the job has finished, polled like an HTTP request.
+class LocalDatRequest : public ScraperRequest
+{
+public:
+	LocalDatRequest(std::vector<ScraperSearchResult>& resultsWrite, const ScraperSearchParams& params);
+	void update() override;
+
+private:
+	// shared with the job, which may finish after the request is gone
+	struct State
+	{
+		std::atomic<bool> done;
+		std::vector<ScraperSearchResult> results;
+
+		State() : done(false) {}
+	};
+
+	std::shared_ptr<State> mState;
+};
+
+// No-Intro/Redump style DAT files and MAME -listxml output from ~/.emulationstation/dats/, read once and indexed
+// by ROM hash and by name. A file named after a platform (snes.dat) or inside a folder named after one (snes/*.dat)
+// only matches systems with that platform, anything else matches every system.
+class DatCatalogue
+{
+public:
+	static DatCatalogue* getInstance();
+
+	// Appends up to MAX_SCRAPER_RESULTS matches for query to results. The first call loads the catalogue,
+	// which can take a while, so this is meant to run off the UI thread. Safe to call from several at once.
+	void search(const DatQuery& query, std::vector<ScraperSearchResult>& results);
+
+private:
+	struct Game
+	{
+		std::string name; // as in the DAT, usually the file name without extension
+		std::string title; // description without tags
+		std::string year;
+		std::string manufacturer;
+		PlatformIds::PlatformId platform;
+	};
+
+	DatCatalogue() {}
+
+	void load();
+	void loadFile(const std::string& path, PlatformIds::PlatformId platform);
+
+	bool matchesSystem(const Game& game, const std::vector<PlatformIds::PlatformId>& platforms) const;
+	void addResult(unsigned int game, std::vector<ScraperSearchResult>& results) const;
+
+	std::once_flag mLoaded;
+
+	std::vector<Game> mGames;
+	std::unordered_multimap<uint32_t, unsigned int> mByCrc;
+	std::unordered_multimap<std::string, unsigned int> mBySha1;
+	std::unordered_multimap<std::string, unsigned int> mByMd5;
+	std::unordered_multimap<std::string, unsigned int> mByName;
+	std::vector< std::pair<std::string, unsigned int> > mByTitle; // sorted normalized titles, for exact and prefix lookups
+};
@@ -4,11 +4,16 @@
 #include <FreeImage.h>
 #include <boost/filesystem.hpp>
 #include <boost/assign.hpp>
+#include <atomic>
+#include <fstream>
+#include "ThreadPool.h"
 
 #include "GamesDBScraper.h"
+#include "LocalDatScraper.h"
 
 const std::map<std::string, generate_scraper_requests_func> scraper_request_funcs = boost::assign::map_list_of
-	("TheGamesDB", &thegamesdb_generate_scraper_requests);
+	("TheGamesDB", &thegamesdb_generate_scraper_requests)
+	("Local DAT", &localdat_generate_scraper_requests);
 
 std::unique_ptr<ScraperSearchHandle> startScraperSearch(const ScraperSearchParams& params)
 {
@@ -30,6 +35,11 @@ std::vector<std::string> getScraperList()
 	return list;
 }
 
+bool isLocalScraper(const std::string& name)
+{
+	return name == "Local DAT";
+}
+
 // ScraperSearchHandle
 ScraperSearchHandle::ScraperSearchHandle()
 {
@@ -65,7 +75,8 @@ void ScraperSearchHandle::update()
 			continue;
 		}
 
-		// status == ASYNC_IN_PROGRESS
+		// status == ASYNC_IN_PROGRESS, check again on the next update instead of spinning here
+		return;
 	}
 
 	// we finished without any errors!
@@ -123,10 +134,25 @@ MDResolveHandle::MDResolveHandle(const ScraperSearchResult& result, const Scrape
 {
 	if(!result.imageUrl.empty())
 	{
+		Settings* settings = Settings::getInstance();
+
+		// every size is made from the one download and decode
+		std::vector<ImageVariant> variants;
 		std::string imgPath = getSaveAsPath(search, "image", result.imageUrl);
-		mFuncs.push_back(ResolvePair(downloadImageAsync(result.imageUrl, imgPath), [this, imgPath]
+		variants.push_back(ImageVariant(imgPath, settings->getInt("ScraperResizeWidth"), settings->getInt("ScraperResizeHeight")));
+
+		std::string thumbPath;
+		if(settings->getBool("ScraperThumbnails"))
+		{
+			thumbPath = getSaveAsPath(search, "thumbnail", result.imageUrl);
+			variants.push_back(ImageVariant(thumbPath, settings->getInt("ScraperThumbnailWidth"), 0));
+		}
+
+		mFuncs.push_back(ResolvePair(downloadImageAsync(result.imageUrl, variants), [this, imgPath, thumbPath]
 		{
 			mResult.mdl.set("image", imgPath);
+			if(!thumbPath.empty())
+				mResult.mdl.set("thumbnail", thumbPath);
 			mResult.imageUrl = "";
 		}));
 	}
@@ -159,17 +185,47 @@ void MDResolveHandle::update()
 
 std::unique_ptr<ImageDownloadHandle> downloadImageAsync(const std::string& url, const std::string& saveAs)
 {
-	return std::unique_ptr<ImageDownloadHandle>(new ImageDownloadHandle(url, saveAs, 
-		Settings::getInstance()->getInt("ScraperResizeWidth"), Settings::getInstance()->getInt("ScraperResizeHeight")));
+	std::vector<ImageVariant> variants;
+	variants.push_back(ImageVariant(saveAs, Settings::getInstance()->getInt("ScraperResizeWidth"), Settings::getInstance()->getInt("ScraperResizeHeight")));
+	return downloadImageAsync(url, variants);
 }
 
-ImageDownloadHandle::ImageDownloadHandle(const std::string& url, const std::string& path, int maxWidth, int maxHeight) : 
-	mSavePath(path), mMaxWidth(maxWidth), mMaxHeight(maxHeight), mReq(new HttpReq(url))
+std::unique_ptr<ImageDownloadHandle> downloadImageAsync(const std::string& url, const std::vector<ImageVariant>& variants)
+{
+	return std::unique_ptr<ImageDownloadHandle>(new ImageDownloadHandle(url, variants));
+}
+
+// filled in by the thread pool job that saves and resizes a finished download
+struct ImageDownloadHandle::SaveState
+{
+	std::atomic<bool> done;
+	std::string error; // empty on success
+
+	SaveState() : done(false) {}
+};
+
+ImageDownloadHandle::ImageDownloadHandle(const std::string& url, const std::vector<ImageVariant>& variants) : 
+	mReq(new HttpReq(url)), mVariants(variants)
 {
 }
 
 void ImageDownloadHandle::update()
 {
+	if(mStatus != ASYNC_IN_PROGRESS)
+		return;
+
+	if(mSave)
+	{
+		if(mSave->done)
+		{
+			if(mSave->error.empty())
+				setStatus(ASYNC_DONE);
+			else
+				setError(mSave->error);
+		}
+		return;
+	}
+
 	if(mReq->status() == HttpReq::REQ_IN_PROGRESS)
 		return;
 
@@ -181,89 +237,144 @@ void ImageDownloadHandle::update()
 		return;
 	}
 
-	// download is done, save it to disk
-	std::ofstream stream(mSavePath, std::ios_base::out | std::ios_base::binary);
-	if(stream.bad())
-	{
-		setError("Failed to open image path to write. Permission error? Disk full?");
-		return;
-	}
+	// download is done, decoding and resizing it is too slow for the UI thread
+	std::shared_ptr<SaveState> save = std::make_shared<SaveState>();
+	std::shared_ptr<std::string> content = std::make_shared<std::string>(mReq->takeContent());
+	const std::vector<ImageVariant> variants = mVariants;
+	ThreadPool::getInstance()->queueWorkItem([save, content, variants] {
+		save->error = saveImageVariants(*content, variants);
+		save->done = true;
+	});
 
-	const std::string& content = mReq->getContent();
-	stream.write(content.data(), content.length());
-	stream.close();
-	if(stream.bad())
-	{
-		setError("Failed to save image. Disk full?");
-		return;
-	}
+	mSave = save;
+}
 
-	// resize it
-	if(!resizeImage(mSavePath, mMaxWidth, mMaxHeight))
+// Moves tempPath over path, so nothing ever sees a half written image there.
+static bool replaceFile(const std::string& tempPath, const std::string& path)
+{
+	boost::system::error_code ec;
+	boost::filesystem::rename(tempPath, path, ec);
+	if(ec)
 	{
-		setError("Error saving resized image. Out of memory? Disk full?");
-		return;
+		LOG(LogError) << "Could not move \"" << tempPath << "\" to \"" << path << "\": " << ec.message();
+		boost::filesystem::remove(tempPath, ec);
+		return false;
 	}
 
-	setStatus(ASYNC_DONE);
+	return true;
 }
 
-//you can pass 0 for width or height to keep aspect ratio
-bool resizeImage(const std::string& path, int maxWidth, int maxHeight)
+// The size image should be saved at for maxWidth/maxHeight, false if it can be saved as it is.
+// Images are only ever made smaller.
+static bool getResizedSize(FIBITMAP* image, int maxWidth, int maxHeight, int& width, int& height)
 {
 	// nothing to do
 	if(maxWidth == 0 && maxHeight == 0)
-		return true;
-
-	FREE_IMAGE_FORMAT format = FIF_UNKNOWN;
-	FIBITMAP* image = NULL;
-	
-	//detect the filetype
-	format = FreeImage_GetFileType(path.c_str(), 0);
-	if(format == FIF_UNKNOWN)
-		format = FreeImage_GetFIFFromFilename(path.c_str());
-	if(format == FIF_UNKNOWN)
-	{
-		LOG(LogError) << "Error - could not detect filetype for image \"" << path << "\"!";
 		return false;
-	}
 
-	//make sure we can read this filetype first, then load it
-	if(FreeImage_FIFSupportsReading(format))
+	const float imageWidth = (float)FreeImage_GetWidth(image);
+	const float imageHeight = (float)FreeImage_GetHeight(image);
+
+	width = maxWidth;
+	height = maxHeight;
+	if(width == 0)
+		width = (int)((maxHeight / imageHeight) * imageWidth);
+	else if(height == 0)
+		height = (int)((maxWidth / imageWidth) * imageHeight);
+
+	width = std::max(width, 1);
+	height = std::max(height, 1);
+	return width < imageWidth || height < imageHeight;
+}
+
+std::string saveImageVariants(const std::string& image, const std::vector<ImageVariant>& variants)
+{
+	// FreeImage only reads from the memory stream, the cast is safe
+	FIMEMORY* stream = FreeImage_OpenMemory((BYTE*)image.data(), (DWORD)image.size());
+	FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(stream, 0);
+	if(format == FIF_UNKNOWN || !FreeImage_FIFSupportsReading(format))
 	{
-		image = FreeImage_Load(format, path.c_str());
-	}else{
-		LOG(LogError) << "Error - file format reading not supported for image \"" << path << "\"!";
-		return false;
+		FreeImage_CloseMemory(stream);
+		return "Unknown or unsupported image format.";
 	}
 
-	float width = (float)FreeImage_GetWidth(image);
-	float height = (float)FreeImage_GetHeight(image);
+	// decoded once, however many variants there are
+	FIBITMAP* source = FreeImage_LoadFromMemory(format, stream);
+	FreeImage_CloseMemory(stream);
+	if(source == NULL)
+		return "Could not decode image.";
 
-	if(maxWidth == 0)
-	{
-		maxWidth = (int)((maxHeight / height) * width);
-	}else if(maxHeight == 0)
+	std::string error;
+	for(auto it = variants.begin(); it != variants.end() && error.empty(); it++)
 	{
-		maxHeight = (int)((maxWidth / width) * height);
+		const std::string tempPath = it->path + ".tmp";
+
+		int width, height;
+		if(!getResizedSize(source, it->maxWidth, it->maxHeight, width, height))
+		{
+			// small enough already, keep the original bytes instead of encoding them again
+			std::ofstream stream(tempPath, std::ios_base::out | std::ios_base::binary);
+			stream.write(image.data(), image.length());
+			stream.close();
+			if(stream.fail())
+				error = "Failed to save image. Permission error? Disk full?";
+			else if(!replaceFile(tempPath, it->path))
+				error = "Failed to save image.";
+			continue;
+		}
+
+		// resized from the source every time, so smaller variants don't pile up resampling errors
+		FIBITMAP* resized = FreeImage_Rescale(source, width, height, FILTER_LANCZOS3);
+		if(resized == NULL)
+		{
+			error = "Could not resize image. Out of memory? Invalid bitdepth?";
+			continue;
+		}
+
+		// e.g. JPEG can't store an alpha channel
+		if(!FreeImage_FIFSupportsExportBPP(format, FreeImage_GetBPP(resized)))
+		{
+			FIBITMAP* converted = FreeImage_ConvertTo24Bits(resized);
+			FreeImage_Unload(resized);
+			resized = converted;
+		}
+
+		if(resized == NULL || !FreeImage_Save(format, resized, tempPath.c_str()) || !replaceFile(tempPath, it->path))
+			error = "Error saving resized image. Out of memory? Disk full?";
+
+		if(resized)
+			FreeImage_Unload(resized);
 	}
 
-	FIBITMAP* imageRescaled = FreeImage_Rescale(image, maxWidth, maxHeight, FILTER_BILINEAR);
-	FreeImage_Unload(image);
+	FreeImage_Unload(source);
+	return error;
+}
 
-	if(imageRescaled == NULL)
+//you can pass 0 for width or height to keep aspect ratio
+bool resizeImage(const std::string& path, int maxWidth, int maxHeight)
+{
+	// nothing to do
+	if(maxWidth == 0 && maxHeight == 0)
+		return true;
+
+	std::ifstream stream(path, std::ios_base::in | std::ios_base::binary);
+	if(!stream)
 	{
-		LOG(LogError) << "Could not resize image! (not enough memory? invalid bitdepth?)";
+		LOG(LogError) << "Error - could not open image \"" << path << "\"!";
 		return false;
 	}
 
-	bool saved = FreeImage_Save(format, imageRescaled, path.c_str());
-	FreeImage_Unload(imageRescaled);
+	const std::string image((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	stream.close();
+
+	std::vector<ImageVariant> variants;
+	variants.push_back(ImageVariant(path, maxWidth, maxHeight));
 
-	if(!saved)
-		LOG(LogError) << "Failed to save resized image!";
+	const std::string error = saveImageVariants(image, variants);
+	if(!error.empty())
+		LOG(LogError) << "Failed to resize image \"" << path << "\": " << error;
 
-	return saved;
+	return error.empty();
 }
 
 std::string getSaveAsPath(const ScraperSearchParams& params, const std::string& suffix, const std::string& url)
@@ -104,6 +104,9 @@ std::unique_ptr<ScraperSearchHandle> startScraperSearch(const ScraperSearchParam
 // returns a list of valid scraper names
 std::vector<std::string> getScraperList();
 
+// true for scrapers that only read local files, there's no server to be polite to
+bool isLocalScraper(const std::string& name);
+
 typedef void (*generate_scraper_requests_func)(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests, std::vector<ScraperSearchResult>& results);
 
 // -------------------------------------------------------------------------
@@ -126,18 +129,31 @@ private:
 	std::vector<ResolvePair> mFuncs;
 };
 
+// One file to save a downloaded image as, made to fit in maxWidth x maxHeight.
+// 0 for either keeps the aspect ratio, 0 for both keeps the size. Images are never enlarged.
+struct ImageVariant
+{
+	ImageVariant(const std::string& path, int maxWidth, int maxHeight) : path(path), maxWidth(maxWidth), maxHeight(maxHeight) {}
+
+	std::string path;
+	int maxWidth;
+	int maxHeight;
+};
+
+// Downloads an image and saves every variant of it, decoding and resizing on the thread pool.
 class ImageDownloadHandle : public AsyncHandle
 {
 public:
-	ImageDownloadHandle(const std::string& url, const std::string& path, int maxWidth, int maxHeight);
+	ImageDownloadHandle(const std::string& url, const std::vector<ImageVariant>& variants);
 
 	void update() override;
 
 private:
+	struct SaveState;
+
 	std::unique_ptr<HttpReq> mReq;
-	std::string mSavePath;
-	int mMaxWidth;
-	int mMaxHeight;
+	std::shared_ptr<SaveState> mSave; // set once the download is being saved
+	std::vector<ImageVariant> mVariants;
 };
 
 //About the same as "~/.emulationstation/downloaded_images/[system_name]/[game_name].[url's extension]".
@@ -146,10 +162,15 @@ std::string getSaveAsPath(const ScraperSearchParams& params, const std::string&
 
 //Will resize according to Settings::getInt("ScraperResizeWidth") and Settings::getInt("ScraperResizeHeight").
 std::unique_ptr<ImageDownloadHandle> downloadImageAsync(const std::string& url, const std::string& saveAs);
+std::unique_ptr<ImageDownloadHandle> downloadImageAsync(const std::string& url, const std::vector<ImageVariant>& variants);
 
 // Resolves all metadata assets that need to be downloaded.
 std::unique_ptr<MDResolveHandle> resolveMetaDataAssets(const ScraperSearchResult& result, const ScraperSearchParams& search);
 
+//Decodes image (the contents of an image file) once and saves each variant in the same format,
+//replacing any existing file in one step. Returns an error message, or an empty string on success.
+std::string saveImageVariants(const std::string& image, const std::vector<ImageVariant>& variants);
+
 //You can pass 0 for maxWidth or maxHeight to automatically keep the aspect ratio.
 //Will overwrite the image at [path] with the new resized one.
 //Returns true if successful, false otherwise.
@@ -0,0 +1,226 @@
+#include "scrapers/ScraperPipeline.h"
+#include "Gamelist.h"
+#include "RomHashCache.h"
+#include "Log.h"
+#include "Settings.h"
+#include "ThreadPool.h"
+
+// time an update may spend starting local scraper searches
+#define LOCAL_SEARCH_START_MS 2
+// local searches in flight per thread pool thread, enough to keep every thread busy
+#define LOCAL_SEARCHES_PER_THREAD 2
+
+ScraperPipeline::ScraperPipeline(const std::queue<ScraperSearchParams>& searches) : mPending(searches), mAcceptMode(ACCEPT_FIRST_RESULT),
+	mTotal((unsigned int)searches.size()), mScraped(0), mSkipped(0), mFailed(0), mStartTime(std::chrono::steady_clock::now())
+{
+	Settings* settings = Settings::getInstance();
+	mMaxSearches = (unsigned int)std::max(1, settings->getInt("ScraperMaxSearches"));
+	mMaxDownloads = (unsigned int)std::max(1, settings->getInt("ScraperMaxDownloads"));
+
+	const int rate = settings->getInt("ScraperRequestsPerSecond");
+	mRequestInterval = rate > 0 ? 1000 / rate : 0;
+}
+
+ScraperPipeline::~ScraperPipeline()
+{
+	stop();
+}
+
+std::string ScraperPipeline::getHost(const std::string& url)
+{
+	size_t start = url.find("://");
+	start = (start == std::string::npos) ? 0 : start + 3;
+
+	size_t end = url.find_first_of(":/?", start);
+	return url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
+bool ScraperPipeline::allowRequest(const std::string& host)
+{
+	if(mRequestInterval == 0)
+		return true;
+
+	const auto now = std::chrono::steady_clock::now();
+	auto it = mNextRequest.find(host);
+	if(it != mNextRequest.end() && now < it->second)
+		return false;
+
+	mNextRequest[host] = now + std::chrono::milliseconds(mRequestInterval);
+	return true;
+}
+
+void ScraperPipeline::update()
+{
+	unsigned int downloading = 0;
+	for(auto it = mJobs.begin(); it != mJobs.end(); it++)
+	{
+		if(it->resolve)
+			downloading++;
+	}
+
+	// advance what's running first, so slots freed up can be reused right away
+	unsigned int searching = 0;
+	unsigned int waiting = 0; // searched, waiting for a download slot
+	auto it = mJobs.begin();
+	while(it != mJobs.end())
+	{
+		Job& job = *it;
+
+		if(job.search)
+		{
+			AsyncHandleStatus status = job.search->status();
+			if(status == ASYNC_IN_PROGRESS)
+			{
+				searching++;
+				it++;
+				continue;
+			}
+
+			if(status == ASYNC_ERROR)
+			{
+				finishGame(job.params, GAME_FAILED, job.search->getStatusString());
+				it = mJobs.erase(it);
+				continue;
+			}
+
+			const std::vector<ScraperSearchResult>& results = job.search->getResults();
+			if(results.empty())
+			{
+				finishGame(job.params, GAME_SKIPPED, "no results");
+				it = mJobs.erase(it);
+				continue;
+			}
+
+			if(mAcceptMode == ACCEPT_SINGLE_RESULT && results.size() > 1)
+			{
+				finishGame(job.params, GAME_SKIPPED, std::to_string(results.size()) + " results");
+				it = mJobs.erase(it);
+				continue;
+			}
+
+			job.result = results.front();
+			job.search.reset();
+
+			if(job.result.imageUrl.empty())
+			{
+				accept(job.params, job.result);
+				it = mJobs.erase(it);
+				continue;
+			}
+
+			job.assetHost = getHost(job.result.imageUrl);
+		}
+
+		if(!job.resolve)
+		{
+			if(downloading >= mMaxDownloads || !allowRequest(job.assetHost))
+			{
+				waiting++;
+				it++;
+				continue;
+			}
+
+			job.resolve = resolveMetaDataAssets(job.result, job.params);
+			downloading++;
+		}
+
+		AsyncHandleStatus status = job.resolve->status();
+		if(status == ASYNC_IN_PROGRESS)
+		{
+			it++;
+			continue;
+		}
+
+		if(status == ASYNC_ERROR)
+			finishGame(job.params, GAME_FAILED, job.resolve->getStatusString());
+		else
+			accept(job.params, job.resolve->getResult());
+
+		downloading--;
+		it = mJobs.erase(it);
+	}
+
+	// don't let searches run ahead of downloads, they'd only pile up waiting
+	// a local scraper searches on the thread pool, so it isn't rate limited and gets as many searches as keep that busy,
+	// started for at most LOCAL_SEARCH_START_MS per update
+	static const SettingHandle<std::string> scraperSetting = Settings::getInstance()->getStringHandle("Scraper");
+	const std::string& scraper = scraperSetting.get();
+	const bool local = isLocalScraper(scraper);
+	const unsigned int maxSearches = local ? (unsigned int)(ThreadPool::getInstance()->getThreadCount() + 1) * LOCAL_SEARCHES_PER_THREAD : mMaxSearches;
+	const auto startTime = std::chrono::steady_clock::now();
+	while(!mPending.empty() && searching < maxSearches && waiting < mMaxDownloads && (local || allowRequest(scraper)))
+	{
+		if(local && std::chrono::steady_clock::now() - startTime >= std::chrono::milliseconds(LOCAL_SEARCH_START_MS))
+			break;
+
+		Job job;
+		job.params = mPending.front();
+		job.search = startScraperSearch(job.params);
+		mPending.pop();
+
+		mJobs.push_back(std::move(job));
+		searching++;
+	}
+
+	if(isDone())
+		flush();
+}
+
+void ScraperPipeline::stop()
+{
+	mJobs.clear();
+	while(!mPending.empty())
+		mPending.pop();
+
+	flush();
+}
+
+void ScraperPipeline::flush()
+{
+	for(auto it = mDirtySystems.begin(); it != mDirtySystems.end(); it++)
+		updateGamelist(*it);
+
+	mDirtySystems.clear();
+
+	// and any ROM hashes searches had to read, nothing is written if there were none
+	RomHashCache::getInstance()->save();
+}
+
+void ScraperPipeline::flush(SystemData* system)
+{
+	if(mDirtySystems.erase(system))
+		updateGamelist(system);
+}
+
+float ScraperPipeline::getGamesPerMinute() const
+{
+	const float minutes = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStartTime).count() / 60000.0f;
+	return minutes > 0 ? getFinished() / minutes : 0;
+}
+
+void ScraperPipeline::accept(const ScraperSearchParams& params, const ScraperSearchResult& result)
+{
+	params.game->metadata = result.mdl;
+	mDirtySystems.insert(params.system);
+	finishGame(params, GAME_SCRAPED, "");
+}
+
+void ScraperPipeline::finishGame(const ScraperSearchParams& params, GameResult result, const std::string& error)
+{
+	switch(result)
+	{
+	case GAME_SCRAPED:
+		mScraped++;
+		break;
+	case GAME_SKIPPED:
+		mSkipped++;
+		break;
+	case GAME_FAILED:
+		mFailed++;
+		LOG(LogWarning) << "Failed to scrape \"" << params.game->getPath().string() << "\": " << error;
+		break;
+	}
+
+	if(mGameDoneCallback)
+		mGameDoneCallback(params, result, error);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "scrapers/Scraper.h"
+#include <list>
+#include <map>
+#include <set>
+#include <chrono>
+
+// Scrapes a queue of games without asking, accepting the first result of each search
+// (or, with ACCEPT_SINGLE_RESULT, only results that aren't ambiguous).
+// Searches and asset downloads are two stages that each keep several requests in flight
+// (ScraperMaxSearches, ScraperMaxDownloads), new requests to the same host are spaced out
+// to stay under ScraperRequestsPerSecond, and changed gamelists are only written in flush().
+class ScraperPipeline
+{
+public:
+	enum GameResult
+	{
+		GAME_SCRAPED,
+		GAME_SKIPPED, // no results, or more than one with ACCEPT_SINGLE_RESULT
+		GAME_FAILED
+	};
+
+	enum AcceptMode
+	{
+		ACCEPT_FIRST_RESULT,
+		ACCEPT_SINGLE_RESULT // leave games with several results for someone to pick by hand
+	};
+
+	// error says what went wrong for GAME_FAILED and why the game was skipped for GAME_SKIPPED
+	typedef std::function<void(const ScraperSearchParams& params, GameResult result, const std::string& error)> GameDoneCallback;
+
+	ScraperPipeline(const std::queue<ScraperSearchParams>& searches);
+	~ScraperPipeline();
+
+	// Advances every stage and starts new work where there's room. Call this regularly (every frame).
+	void update();
+	inline bool isDone() const { return mPending.empty() && mJobs.empty(); }
+
+	// Drops everything that isn't finished yet and writes what was scraped so far.
+	void stop();
+
+	// Writes the gamelists of every system scraped into since the last flush, once each.
+	void flush();
+	void flush(SystemData* system); // only this system's, if it changed
+
+	inline void setAcceptMode(AcceptMode mode) { mAcceptMode = mode; }
+
+	inline void setGameDoneCallback(const GameDoneCallback& callback) { mGameDoneCallback = callback; }
+
+	inline unsigned int getTotal() const { return mTotal; }
+	inline unsigned int getFinished() const { return mScraped + mSkipped + mFailed; }
+	inline unsigned int getScraped() const { return mScraped; }
+	inline unsigned int getSkipped() const { return mSkipped; }
+	inline unsigned int getFailed() const { return mFailed; }
+	inline unsigned int getInFlight() const { return (unsigned int)mJobs.size(); }
+
+	// finished games per minute since the pipeline was created
+	float getGamesPerMinute() const;
+
+	// The part of url the rate limit is applied to.
+	static std::string getHost(const std::string& url);
+
+private:
+	struct Job
+	{
+		ScraperSearchParams params;
+		std::unique_ptr<ScraperSearchHandle> search; // set while searching
+		ScraperSearchResult result; // accepted search result
+		std::string assetHost;
+		std::unique_ptr<MDResolveHandle> resolve; // set while downloading
+	};
+
+	// false if a request to host now would go over the rate limit
+	bool allowRequest(const std::string& host);
+	void accept(const ScraperSearchParams& params, const ScraperSearchResult& result);
+	void finishGame(const ScraperSearchParams& params, GameResult result, const std::string& error);
+
+	std::queue<ScraperSearchParams> mPending;
+	std::list<Job> mJobs;
+	std::set<SystemData*> mDirtySystems;
+
+	AcceptMode mAcceptMode;
+	unsigned int mMaxSearches;
+	unsigned int mMaxDownloads;
+	unsigned int mRequestInterval; // ms between requests to one host
+	std::map<std::string, std::chrono::steady_clock::time_point> mNextRequest; // per host
+
+	unsigned int mTotal;
+	unsigned int mScraped;
+	unsigned int mSkipped;
+	unsigned int mFailed;
+	std::chrono::steady_clock::time_point mStartTime;
+
+	GameDoneCallback mGameDoneCallback;
+};
@@ -106,24 +106,24 @@ bool SystemView::input(InputConfig* config, Input input)
 			updateHelpPrompts();
 			return true;
 		}
-		if(config->isMappedTo("left", input))
+		if(config->isMappedTo(ACTION_LEFT, input))
 		{
 			listInput(-1);
 			return true;
 		}
-		if(config->isMappedTo("right", input))
+		if(config->isMappedTo(ACTION_RIGHT, input))
 		{
 			listInput(1);
 			return true;
 		}
-		if(config->isMappedTo("a", input))
+		if(config->isMappedTo(ACTION_A, input))
 		{
 			stopScrolling();
 			ViewController::get()->goToGameList(getSelected());
 			return true;
 		}
 	}else{
-		if(config->isMappedTo("left", input) || config->isMappedTo("right", input))
+		if(config->isMappedTo(ACTION_LEFT, input) || config->isMappedTo(ACTION_RIGHT, input))
 			listInput(0);
 	}
 
@@ -165,16 +165,10 @@ void SystemView::onCursorChanged(const CursorState& state)
 
 	const float infoStartOpacity = mSystemInfo.getOpacity() / 255.f;
 
-	Animation* infoFadeOut = new LambdaAnimation(
-		[infoStartOpacity, this] (float t)
-	{
-		mSystemInfo.setOpacity((unsigned char)(lerp<float>(infoStartOpacity, 0.f, t) * 255));
-	}, (int)(infoStartOpacity * 150));
-
 	unsigned int gameCount = getSelected()->getGameCount();
 
 	// also change the text after we've fully faded out
-	setAnimation(infoFadeOut, 0, [this, gameCount] {
+	setAnimation(OpacityTween{&mSystemInfo, infoStartOpacity, 0.f, (int)(infoStartOpacity * 150)}, 0, [this, gameCount] {
 		std::stringstream ss;
 		
 		if (getSelected()->getName() == "retropie")
@@ -189,14 +183,8 @@ void SystemView::onCursorChanged(const CursorState& state)
 	// only display a game count if there are at least 2 games
 	if(gameCount > 1)
 	{
-		Animation* infoFadeIn = new LambdaAnimation(
-			[this](float t)
-		{
-			mSystemInfo.setOpacity((unsigned char)(lerp<float>(0.f, 1.f, t) * 255));
-		}, 300);
-
 		// wait 600ms to fade in
-		setAnimation(infoFadeIn, 2000, nullptr, false, 2);
+		setAnimation(OpacityTween{&mSystemInfo, 0.f, 1.f, 300}, 2000, nullptr, false, 2);
 	}
 
 	// no need to animate transition, we're not going anywhere (probably mEntries.size() == 1)
@@ -204,7 +192,7 @@ void SystemView::onCursorChanged(const CursorState& state)
 		return;
 
 	Animation* anim;
-	if(Settings::getInstance()->getString("TransitionStyle") == "fade")
+	if(ViewController::get()->isFadeTransition())
 	{
 		float startExtrasFade = mExtrasFadeOpacity;
 		anim = new LambdaAnimation(
@@ -10,7 +10,6 @@
 #include "guis/GuiMenu.h"
 #include "guis/GuiMsgBox.h"
 #include "animations/LaunchAnimation.h"
-#include "animations/MoveCameraAnimation.h"
 #include "animations/LambdaAnimation.h"
 #include <SDL2/SDL.h>
 
@@ -29,13 +28,19 @@ void ViewController::init(Window* window)
 }
 
 ViewController::ViewController(Window* window)
-	: GuiComponent(window), mCurrentView(nullptr), mCamera(Eigen::Affine3f::Identity()), mFadeOpacity(0), mLockInput(false)
+	: GuiComponent(window), mCurrentView(nullptr), mCamera(Eigen::Affine3f::Identity()), mFadeOpacity(0), mLockInput(false), mIdleTime(0)
 {
 	mState.viewing = NOTHING;
+
+	// cached so transitions don't compare strings every time
+	auto updateTransitionStyle = [this] { mFadeTransition = (Settings::getInstance()->getString("TransitionStyle") == "fade"); };
+	updateTransitionStyle();
+	mTransitionStyleCallback = Settings::getInstance()->addChangedCallback("TransitionStyle", updateTransitionStyle);
 }
 
 ViewController::~ViewController()
 {
+	Settings::getInstance()->removeChangedCallback(mTransitionStyleCallback);
 	assert(sInstance == this);
 	sInstance = NULL;
 }
@@ -107,6 +112,9 @@ void ViewController::goToGameList(SystemData* system)
 	mState.viewing = GAME_LIST;
 	mState.system = system;
 
+	mVisitedSystems.remove(system);
+	mVisitedSystems.push_front(system);
+
 	if (mCurrentView)
 	{
 		mCurrentView->onHide();
@@ -129,7 +137,7 @@ void ViewController::playViewTransition()
 	if(target == -mCamera.translation() && !isAnimationPlaying(0))
 		return;
 
-	if(Settings::getInstance()->getString("TransitionStyle") == "fade")
+	if(mFadeTransition)
 	{
 		// fade
 		// stop whatever's currently playing, leaving mFadeOpacity wherever it is
@@ -159,7 +167,7 @@ void ViewController::playViewTransition()
 		}
 	}else{
 		// slide
-		setAnimation(new MoveCameraAnimation(mCamera, target));
+		setAnimation(CameraTween{&mCamera, -mCamera.translation(), target, 400});
 		updateHelpPrompts(); // update help prompts immediately
 	}
 }
@@ -168,7 +176,26 @@ void ViewController::onFileChanged(FileData* file, FileChangeType change)
 {
 	auto it = mGameListViews.find(file->getSystem());
 	if(it != mGameListViews.end())
+	{
 		it->second->onFileChanged(file, change);
+	}
+
+	if(change == FILE_REMOVED)
+	{
+		// don't try to restore the cursor to a file that no longer exists, or is in a folder that doesn't
+		auto cursor = mSavedCursors.find(file->getSystem());
+		if(cursor != mSavedCursors.end())
+		{
+			for(FileData* f = cursor->second; f != NULL; f = f->getParent())
+			{
+				if(f == file)
+				{
+					mSavedCursors.erase(cursor);
+					break;
+				}
+			}
+		}
+	}
 }
 
 void ViewController::launch(FileData* game, Eigen::Vector3f center)
@@ -190,7 +217,7 @@ void ViewController::launch(FileData* game, Eigen::Vector3f center)
 	stopAnimation(1); // make sure the fade in isn't still playing
 	mLockInput = true;
 
-	if(Settings::getInstance()->getString("TransitionStyle") == "fade")
+	if(mFadeTransition)
 	{
 		// fade out, launch game, fade back in
 		auto fadeFunc = [this](float t) {
@@ -229,22 +256,9 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 	std::shared_ptr<IGameListView> view;
 
 	//decide type
-	bool detailed = false;
-	bool video	  = false;
-	std::vector<FileData*> files = system->getRootFolder()->getFilesRecursive(GAME | FOLDER);
-	for(auto it = files.begin(); it != files.end(); it++)
-	{
-		if(!(*it)->getVideoPath().empty())
-		{
-			video = true;
-			break;
-		}
-		else if(!(*it)->getThumbnailPath().empty())
-		{
-			detailed = true;
-			// Don't break out in case any subsequent files have video
-		}
-	}
+	const FileCounts& counts = system->getRootFolder()->getCounts();
+	bool video	  = counts.videos > 0;
+	bool detailed = counts.thumbnails > 0;
 		
 	if (video)
 		// Create the view
@@ -266,6 +280,15 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 	addChild(view.get());
 
 	mGameListViews[system] = view;
+
+	// put the cursor back where it was if this view was evicted earlier
+	auto cursor = mSavedCursors.find(system);
+	if(cursor != mSavedCursors.end())
+	{
+		view->setCursor(cursor->second);
+		mSavedCursors.erase(cursor);
+	}
+
 	return view;
 }
 
@@ -284,11 +307,13 @@ std::shared_ptr<SystemView> ViewController::getSystemListView()
 
 bool ViewController::input(InputConfig* config, Input input)
 {
+	mIdleTime = 0;
+
 	if(mLockInput)
 		return true;
 
 	// open menu
-	if(config->isMappedTo("start", input) && input.value != 0)
+	if(config->isMappedTo(ACTION_START, input) && input.value != 0)
 	{
 		// open menu
 		mWindow->pushGui(new GuiMenu(mWindow));
@@ -309,6 +334,92 @@ void ViewController::update(int deltaTime)
 	}
 
 	updateSelf(deltaTime);
+
+	updateIdleViews(deltaTime);
+}
+
+void ViewController::updateIdleViews(int deltaTime)
+{
+	// everything was already built up front
+	static const SettingHandle<bool> preload = Settings::getInstance()->getBoolHandle("PreloadGameLists");
+	if(preload.get())
+		return;
+
+	mIdleTime += deltaTime;
+	if(mIdleTime < IDLE_BUILD_DELAY || mLockInput || isAnimationPlaying(0))
+		return;
+
+	SystemData* selected = NULL;
+	if(mState.viewing == SYSTEM_SELECT && mSystemListView && mSystemListView->size() > 0 && !mSystemListView->isScrolling())
+		selected = mSystemListView->getSelected();
+	else if(mState.viewing == GAME_LIST)
+		selected = mState.getSystem();
+
+	if(selected == NULL)
+		return;
+
+	evictGameListViews(selected);
+
+	// build at most one view per frame, closest to the selected system first
+	SystemData* next = selected;
+	SystemData* prev = selected;
+	for(int i = 0; i <= IDLE_BUILD_RADIUS; i++)
+	{
+		if(mGameListViews.find(next) == mGameListViews.end())
+		{
+			getGameListView(next);
+			return;
+		}
+		if(mGameListViews.find(prev) == mGameListViews.end())
+		{
+			getGameListView(prev);
+			return;
+		}
+
+		next = next->getNext();
+		prev = prev->getPrev();
+	}
+}
+
+bool ViewController::isNearSystem(SystemData* system, SystemData* selected) const
+{
+	SystemData* next = selected;
+	SystemData* prev = selected;
+	for(int i = 0; i <= IDLE_BUILD_RADIUS; i++)
+	{
+		if(system == next || system == prev)
+			return true;
+
+		next = next->getNext();
+		prev = prev->getPrev();
+	}
+
+	return false;
+}
+
+void ViewController::evictGameListViews(SystemData* selected)
+{
+	for(auto it = mGameListViews.begin(); it != mGameListViews.end(); )
+	{
+		SystemData* system = it->first;
+
+		bool keep = (mCurrentView == it->second) || isNearSystem(system, selected);
+		if(!keep)
+		{
+			auto visited = std::find(mVisitedSystems.begin(), mVisitedSystems.end(), system);
+			keep = (visited != mVisitedSystems.end() && std::distance(mVisitedSystems.begin(), visited) < MAX_RECENT_VIEWS);
+		}
+
+		if(keep)
+		{
+			it++;
+			continue;
+		}
+
+		LOG(LogDebug) << "Evicting gamelist view for " << system->getName();
+		mSavedCursors[system] = it->second->getCursor();
+		it = mGameListViews.erase(it);
+	}
 }
 
 void ViewController::render(const Eigen::Affine3f& parentTrans)
@@ -353,6 +464,20 @@ void ViewController::preload()
 	}
 }
 
+void ViewController::reloadGameListView(SystemData* system, bool reloadTheme)
+{
+	auto it = mGameListViews.find(system);
+	if(it != mGameListViews.end())
+	{
+		reloadGameListView(it->second.get(), reloadTheme);
+		return;
+	}
+
+	// no view to rebuild, it will pick up the changes whenever it's built
+	if(reloadTheme)
+		system->loadTheme();
+}
+
 void ViewController::reloadGameListView(IGameListView* view, bool reloadTheme)
 {
 	for(auto it = mGameListViews.begin(); it != mGameListViews.end(); it++)
@@ -391,11 +516,15 @@ void ViewController::reloadAll()
 	}
 	mGameListViews.clear();
 
+	// the old set's parsed files won't be used again
+	ThemeData::clearCache();
+
+	// every system, the carousel shows them all and views that weren't built yet use it later
+	for(auto it = SystemData::sSystemVector.begin(); it != SystemData::sSystemVector.end(); it++)
+		(*it)->loadTheme();
+
 	for(auto it = cursorMap.begin(); it != cursorMap.end(); it++)
-	{
-		it->first->loadTheme();
 		getGameListView(it->first)->setCursor(it->second);
-	}
 
 	mSystemListView.reset();
 	getSystemListView();
@@ -16,12 +16,14 @@ public:
 
 	// Try to completely populate the GameListView map.
 	// Caches things so there's no pauses during transitions.
+	// Only used if the PreloadGameLists setting is on, otherwise views are built
+	// when first needed or while idle, and dropped again when not visited for a while.
 	void preload();
 
 	// If a basic view detected a metadata change, it can request to recreate
 	// the current gamelist view (as it may change to be detailed).
 	void reloadGameListView(IGameListView* gamelist, bool reloadTheme = false);
-	inline void reloadGameListView(SystemData* system, bool reloadTheme = false) { reloadGameListView(getGameListView(system).get(), reloadTheme); }
+	void reloadGameListView(SystemData* system, bool reloadTheme = false);
 	void reloadAll(); // Reload everything with a theme.  Used when the "ThemeSet" setting changes.
 
 	// Navigation.
@@ -62,6 +64,9 @@ public:
 
 	inline const State& getState() const { return mState; }
 
+	// Whether the "TransitionStyle" setting is "fade" rather than "slide"
+	inline bool isFadeTransition() const { return mFadeTransition; }
+
 	virtual std::vector<HelpPrompt> getHelpPrompts() override;
 	virtual HelpStyle getHelpStyle() override;
 
@@ -74,10 +79,25 @@ private:
 
 	void playViewTransition();
 	int getSystemId(SystemData* system);
+
+	static const int IDLE_BUILD_DELAY = 500; // ms without input before gamelist views are built in the background
+	static const int IDLE_BUILD_RADIUS = 2; // systems either side of the selected one to have views ready for
+	static const int MAX_RECENT_VIEWS = 4; // recently visited views kept besides the ones near the selected system
+
+	void updateIdleViews(int deltaTime);
+	void evictGameListViews(SystemData* selected);
+	bool isNearSystem(SystemData* system, SystemData* selected) const;
 	
 	std::shared_ptr<GuiComponent> mCurrentView;
 	std::map< SystemData*, std::shared_ptr<IGameListView> > mGameListViews;
 	std::shared_ptr<SystemView> mSystemListView;
+
+	std::list<SystemData*> mVisitedSystems; // most recently visited first
+	std::map<SystemData*, FileData*> mSavedCursors; // cursors of evicted views, restored when they're rebuilt
+	int mIdleTime;
+
+	bool mFadeTransition;
+	int mTransitionStyleCallback;
 	
 	Eigen::Affine3f mCamera;
 	float mFadeOpacity;
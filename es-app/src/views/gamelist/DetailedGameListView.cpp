@@ -1,7 +1,6 @@
 #include "views/gamelist/DetailedGameListView.h"
 #include "views/ViewController.h"
 #include "Window.h"
-#include "animations/LambdaAnimation.h"
 
 DetailedGameListView::DetailedGameListView(Window* window, FileData* root) : 
 	BasicGameListView(window, root), 
@@ -177,8 +176,19 @@ void DetailedGameListView::initMDValues()
 	mDescContainer.setSize(mDescContainer.getSize().x(), mSize.y() - mDescContainer.getPosition().y());
 }
 
+void DetailedGameListView::prefetchUpcoming()
+{
+	std::vector<FileData*> upcoming = mList.getUpcoming(PREFETCH_COUNT);
+	std::vector<std::string> paths;
+	for(auto it = upcoming.begin(); it != upcoming.end(); it++)
+		paths.push_back((*it)->metadata.get("image"));
+	TextureResource::prefetch(paths);
+}
+
 void DetailedGameListView::updateInfoPanel()
 {
+	prefetchUpcoming();
+
 	FileData* file = (mList.size() == 0 || mList.isScrolling()) ? NULL : mList.getSelected();
 
 	bool fadingOut;
@@ -223,11 +233,7 @@ void DetailedGameListView::updateInfoPanel()
 		if((comp->isAnimationPlaying(0) && comp->isAnimationReversed(0) != fadingOut) || 
 			(!comp->isAnimationPlaying(0) && comp->getOpacity() != (fadingOut ? 0 : 255)))
 		{
-			auto func = [comp](float t)
-			{
-				comp->setOpacity((unsigned char)(lerp<float>(0.0f, 1.0f, t)*255));
-			};
-			comp->setAnimation(new LambdaAnimation(func, 150), 0, nullptr, fadingOut);
+			comp->setAnimation(OpacityTween{comp, 0.0f, 1.0f, 150}, 0, nullptr, fadingOut);
 		}
 	}
 }
@@ -18,7 +18,10 @@ protected:
 	virtual void launch(FileData* game) override;
 
 private:
+	static const int PREFETCH_COUNT = 4; // number of upcoming entries to load images for
+
 	void updateInfoPanel();
+	void prefetchUpcoming();
 
 	void initMDLabels();
 	void initMDValues();
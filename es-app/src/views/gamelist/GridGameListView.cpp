@@ -29,7 +29,7 @@ void GridGameListView::setCursor(FileData* file)
 
 bool GridGameListView::input(InputConfig* config, Input input)
 {
-	if(config->isMappedTo("left", input) || config->isMappedTo("right", input))
+	if(config->isMappedTo(ACTION_LEFT, input) || config->isMappedTo(ACTION_RIGHT, input))
 		return GuiComponent::input(config, input);
 
 	return ISimpleGameListView::input(config, input);
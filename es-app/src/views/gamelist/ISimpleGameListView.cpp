@@ -55,7 +55,7 @@ bool ISimpleGameListView::input(InputConfig* config, Input input)
 {
 	if(input.value != 0)
 	{
-		if(config->isMappedTo("a", input))
+		if(config->isMappedTo(ACTION_A, input))
 		{
 			FileData* cursor = getCursor();
 			if(cursor->getType() == GAME)
@@ -72,7 +72,7 @@ bool ISimpleGameListView::input(InputConfig* config, Input input)
 			}
 				
 			return true;
-		}else if(config->isMappedTo("b", input))
+		}else if(config->isMappedTo(ACTION_B, input))
 		{
 			if(mCursorStack.size())
 			{
@@ -86,7 +86,7 @@ bool ISimpleGameListView::input(InputConfig* config, Input input)
 			}
 
 			return true;
-		}else if(config->isMappedTo("right", input))
+		}else if(config->isMappedTo(ACTION_RIGHT, input))
 		{
 			if(Settings::getInstance()->getBool("QuickSystemSelect"))
 			{
@@ -94,7 +94,7 @@ bool ISimpleGameListView::input(InputConfig* config, Input input)
 				ViewController::get()->goToNextGameList();
 				return true;
 			}
-		}else if(config->isMappedTo("left", input))
+		}else if(config->isMappedTo(ACTION_LEFT, input))
 		{
 			if(Settings::getInstance()->getBool("QuickSystemSelect"))
 			{
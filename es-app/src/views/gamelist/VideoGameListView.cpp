@@ -1,7 +1,6 @@
 #include "views/gamelist/VideoGameListView.h"
 #include "views/ViewController.h"
 #include "Window.h"
-#include "animations/LambdaAnimation.h"
 #include <sys/stat.h>
 #include <fcntl.h>
 
@@ -211,8 +210,30 @@ void VideoGameListView::initMDValues()
 
 
 
+void VideoGameListView::prefetchUpcoming()
+{
+	std::vector<FileData*> upcoming = mList.getUpcoming(PREFETCH_COUNT);
+	std::vector<std::string> paths;
+	for(auto it = upcoming.begin(); it != upcoming.end(); it++)
+	{
+		std::string marquee_path = (*it)->getMarqueePath();
+		std::string thumbnail_path = (*it)->getThumbnailPath();
+
+		if (!marquee_path.empty() && (marquee_path[0] == '~'))
+			marquee_path.replace(0, 1, getHomePath());
+		if (!thumbnail_path.empty() && (thumbnail_path[0] == '~'))
+			thumbnail_path.replace(0, 1, getHomePath());
+
+		paths.push_back(thumbnail_path);
+		paths.push_back(marquee_path);
+	}
+	TextureResource::prefetch(paths);
+}
+
 void VideoGameListView::updateInfoPanel()
 {
+	prefetchUpcoming();
+
 	FileData* file = (mList.size() == 0 || mList.isScrolling()) ? NULL : mList.getSelected();
 
 	bool fadingOut;
@@ -292,11 +313,7 @@ void VideoGameListView::updateInfoPanel()
 		if((comp->isAnimationPlaying(0) && comp->isAnimationReversed(0) != fadingOut) || 
 			(!comp->isAnimationPlaying(0) && comp->getOpacity() != (fadingOut ? 0 : 255)))
 		{
-			auto func = [comp](float t)
-			{
-				comp->setOpacity((unsigned char)(lerp<float>(0.0f, 1.0f, t)*255));
-			};
-			comp->setAnimation(new LambdaAnimation(func, 150), 0, nullptr, fadingOut);
+			comp->setAnimation(OpacityTween{comp, 0.0f, 1.0f, 150}, 0, nullptr, fadingOut);
 		}
 	}
 }
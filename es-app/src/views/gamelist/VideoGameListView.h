@@ -22,7 +22,10 @@ protected:
 	virtual void update(int deltaTime) override;
 
 private:
+	static const int PREFETCH_COUNT = 4; // number of upcoming entries to load images for
+
 	void updateInfoPanel();
+	void prefetchUpcoming();
 
 	void initMDLabels();
 	void initMDValues();
@@ -2,15 +2,14 @@
 #include "Window.h"
 #include "Log.h"
 #include "Renderer.h"
-#include "animations/AnimationController.h"
 #include "ThemeData.h"
 
 GuiComponent::GuiComponent(Window* window) : mWindow(window), mParent(NULL), mOpacity(255), 
 	mPosition(Eigen::Vector3f::Zero()), mSize(Eigen::Vector2f::Zero()), mTransform(Eigen::Affine3f::Identity()),
-	mIsProcessing(false)
+	mIsProcessing(false), mUpdateFrame(AnimationManager::getInstance()->getFrame() - 1)
 {
 	for(unsigned char i = 0; i < MAX_ANIMATIONS; i++)
-		mAnimationMap[i] = NULL;
+		mAnimations[i] = -1;
 }
 
 GuiComponent::~GuiComponent()
@@ -39,8 +38,8 @@ bool GuiComponent::input(InputConfig* config, Input input)
 
 void GuiComponent::updateSelf(int deltaTime)
 {
-	for(unsigned char i = 0; i < MAX_ANIMATIONS; i++)
-		advanceAnimation(i, deltaTime);
+	// AnimationManager::update advances them by the same deltaTime once everything has been updated
+	mUpdateFrame = AnimationManager::getInstance()->getFrame();
 }
 
 void GuiComponent::updateChildren(int deltaTime)
@@ -204,21 +203,42 @@ void GuiComponent::textInput(const char* text)
 void GuiComponent::setAnimation(Animation* anim, int delay, std::function<void()> finishedCallback, bool reverse, unsigned char slot)
 {
 	assert(slot < MAX_ANIMATIONS);
+	setAnimationHandle(slot, AnimationManager::getInstance()->start(this, slot, anim, delay, finishedCallback, reverse));
+}
+
+void GuiComponent::setAnimation(const OpacityTween& tween, int delay, std::function<void()> finishedCallback, bool reverse, unsigned char slot)
+{
+	assert(slot < MAX_ANIMATIONS);
+	setAnimationHandle(slot, AnimationManager::getInstance()->start(this, slot, tween, delay, finishedCallback, reverse));
+}
+
+void GuiComponent::setAnimation(const PositionTween& tween, int delay, std::function<void()> finishedCallback, bool reverse, unsigned char slot)
+{
+	assert(slot < MAX_ANIMATIONS);
+	setAnimationHandle(slot, AnimationManager::getInstance()->start(this, slot, tween, delay, finishedCallback, reverse));
+}
 
-	AnimationController* oldAnim = mAnimationMap[slot];
-	mAnimationMap[slot] = new AnimationController(anim, delay, finishedCallback, reverse);
+void GuiComponent::setAnimation(const CameraTween& tween, int delay, std::function<void()> finishedCallback, bool reverse, unsigned char slot)
+{
+	assert(slot < MAX_ANIMATIONS);
+	setAnimationHandle(slot, AnimationManager::getInstance()->start(this, slot, tween, delay, finishedCallback, reverse));
+}
 
-	if(oldAnim)
-		delete oldAnim;
+void GuiComponent::setAnimationHandle(unsigned char slot, int handle)
+{
+	const int oldAnim = mAnimations[slot];
+	mAnimations[slot] = handle;
+
+	if(oldAnim != -1)
+		AnimationManager::getInstance()->stop(oldAnim, true);
 }
 
 bool GuiComponent::stopAnimation(unsigned char slot)
 {
 	assert(slot < MAX_ANIMATIONS);
-	if(mAnimationMap[slot])
+	if(mAnimations[slot] != -1)
 	{
-		delete mAnimationMap[slot];
-		mAnimationMap[slot] = NULL;
+		AnimationManager::getInstance()->stop(mAnimations[slot], true); // also empties the slot
 		return true;
 	}else{
 		return false;
@@ -228,11 +248,9 @@ bool GuiComponent::stopAnimation(unsigned char slot)
 bool GuiComponent::cancelAnimation(unsigned char slot)
 {
 	assert(slot < MAX_ANIMATIONS);
-	if(mAnimationMap[slot])
+	if(mAnimations[slot] != -1)
 	{
-		mAnimationMap[slot]->removeFinishedCallback();
-		delete mAnimationMap[slot];
-		mAnimationMap[slot] = NULL;
+		AnimationManager::getInstance()->stop(mAnimations[slot], false);
 		return true;
 	}else{
 		return false;
@@ -242,14 +260,10 @@ bool GuiComponent::cancelAnimation(unsigned char slot)
 bool GuiComponent::finishAnimation(unsigned char slot)
 {
 	assert(slot < MAX_ANIMATIONS);
-	if(mAnimationMap[slot])
+	if(mAnimations[slot] != -1)
 	{
-		// skip to animation's end
-		const bool done = mAnimationMap[slot]->update(mAnimationMap[slot]->getAnimation()->getDuration() - mAnimationMap[slot]->getTime());
-		assert(done);
-
-		delete mAnimationMap[slot]; // will also call finishedCallback
-		mAnimationMap[slot] = NULL;
+		// skip to animation's end, will also call finishedCallback
+		AnimationManager::getInstance()->finish(mAnimations[slot]);
 		return true;
 	}else{
 		return false;
@@ -259,15 +273,9 @@ bool GuiComponent::finishAnimation(unsigned char slot)
 bool GuiComponent::advanceAnimation(unsigned char slot, unsigned int time)
 {
 	assert(slot < MAX_ANIMATIONS);
-	AnimationController* anim = mAnimationMap[slot];
-	if(anim)
+	if(mAnimations[slot] != -1)
 	{
-		bool done = anim->update(time);
-		if(done)
-		{
-			mAnimationMap[slot] = NULL;
-			delete anim;
-		}
+		AnimationManager::getInstance()->advance(mAnimations[slot], time);
 		return true;
 	}else{
 		return false;
@@ -288,19 +296,19 @@ void GuiComponent::cancelAllAnimations()
 
 bool GuiComponent::isAnimationPlaying(unsigned char slot) const
 {
-	return mAnimationMap[slot] != NULL;
+	return mAnimations[slot] != -1;
 }
 
 bool GuiComponent::isAnimationReversed(unsigned char slot) const
 {
-	assert(mAnimationMap[slot] != NULL);
-	return mAnimationMap[slot]->isReversed();
+	assert(mAnimations[slot] != -1);
+	return AnimationManager::getInstance()->isReversed(mAnimations[slot]);
 }
 
 int GuiComponent::getAnimationTime(unsigned char slot) const
 {
-	assert(mAnimationMap[slot] != NULL);
-	return mAnimationMap[slot]->getTime();
+	assert(mAnimations[slot] != -1);
+	return AnimationManager::getInstance()->getTime(mAnimations[slot]);
 }
 
 void GuiComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties)
@@ -312,14 +320,14 @@ void GuiComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const std
 		return;
 
 	using namespace ThemeFlags;
-	if(properties & POSITION && elem->has("pos"))
+	if(properties & POSITION && elem->has(ThemeProperty::POS))
 	{
-		Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>("pos").cwiseProduct(scale);
+		Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>(ThemeProperty::POS).cwiseProduct(scale);
 		setPosition(Eigen::Vector3f(denormalized.x(), denormalized.y(), 0));
 	}
 
-	if(properties & ThemeFlags::SIZE && elem->has("size"))
-		setSize(elem->get<Eigen::Vector2f>("size").cwiseProduct(scale));
+	if(properties & ThemeFlags::SIZE && elem->has(ThemeProperty::SIZE))
+		setSize(elem->get<Eigen::Vector2f>(ThemeProperty::SIZE).cwiseProduct(scale));
 }
 
 void GuiComponent::updateHelpPrompts()
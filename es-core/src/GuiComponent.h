@@ -4,10 +4,9 @@
 #include <memory>
 #include <Eigen/Dense>
 #include "HelpStyle.h"
+#include "animations/AnimationManager.h"
 
 class Window;
-class Animation;
-class AnimationController;
 class ThemeData;
 class Font;
 
@@ -60,6 +59,10 @@ public:
 	bool isAnimationReversed(unsigned char slot) const;
 	int getAnimationTime(unsigned char slot) const;
 	void setAnimation(Animation* animation, int delay = 0, std::function<void()> finishedCallback = nullptr, bool reverse = false, unsigned char slot = 0);
+	// the common cases, these don't allocate
+	void setAnimation(const OpacityTween& tween, int delay = 0, std::function<void()> finishedCallback = nullptr, bool reverse = false, unsigned char slot = 0);
+	void setAnimation(const PositionTween& tween, int delay = 0, std::function<void()> finishedCallback = nullptr, bool reverse = false, unsigned char slot = 0);
+	void setAnimation(const CameraTween& tween, int delay = 0, std::function<void()> finishedCallback = nullptr, bool reverse = false, unsigned char slot = 0);
 	bool stopAnimation(unsigned char slot);
 	bool cancelAnimation(unsigned char slot); // Like stopAnimation, but doesn't call finishedCallback - only removes the animation, leaving things in their current state.  Returns true if successful (an animation was in this slot).
 	bool finishAnimation(unsigned char slot); // Calls update(1.f) and finishedCallback, then deletes the animation - basically skips to the end.  Returns true if successful (an animation was in this slot).
@@ -98,8 +101,8 @@ public:
 
 protected:
 	void renderChildren(const Eigen::Affine3f& transform) const;
-	void updateSelf(int deltaTime); // updates animations
-	void updateChildren(int deltaTime); // updates animations
+	void updateSelf(int deltaTime); // lets AnimationManager advance this component's animations this frame
+	void updateChildren(int deltaTime);
 
 	unsigned char mOpacity;
 	Window* mWindow;
@@ -116,6 +119,12 @@ public:
 	const static unsigned char MAX_ANIMATIONS = 4;
 
 private:
+	friend class AnimationManager;
+
+	// installs a handle from AnimationManager::start, then stops whatever was in slot
+	void setAnimationHandle(unsigned char slot, int handle);
+
 	Eigen::Affine3f mTransform; //Don't access this directly! Use getTransform()!
-	AnimationController* mAnimationMap[MAX_ANIMATIONS];
+	int mAnimations[MAX_ANIMATIONS]; // AnimationManager handles, -1 if the slot is empty
+	unsigned int mUpdateFrame; // AnimationManager frame of the last updateSelf
 };
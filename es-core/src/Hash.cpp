@@ -0,0 +1,262 @@
+#include "Hash.h"
+#include <string.h>
+
+// Slicing-by-8 CRC tables, table[k][b] is the CRC of byte b followed by k zero bytes.
+// Processing 8 bytes per step is several times faster than the byte at a time loop.
+struct Crc32Tables
+{
+	uint32_t table[8][256];
+
+	Crc32Tables()
+	{
+		for(uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t crc = i;
+			for(int bit = 0; bit < 8; bit++)
+				crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+			table[0][i] = crc;
+		}
+
+		for(uint32_t i = 0; i < 256; i++)
+		{
+			for(int k = 1; k < 8; k++)
+				table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+		}
+	}
+};
+
+static const Crc32Tables sCrc32Tables;
+
+void Crc32::update(const void* data, size_t size)
+{
+	const unsigned char* p = (const unsigned char*)data;
+	const uint32_t (*t)[256] = sCrc32Tables.table;
+	uint32_t crc = mCrc;
+
+	while(size >= 8)
+	{
+		// assembled byte by byte, so neither alignment nor endianness matter
+		const uint32_t lo = crc ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+			t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+		p += 8;
+		size -= 8;
+	}
+
+	while(size--)
+		crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+
+	mCrc = crc;
+}
+
+static inline uint32_t rotl(uint32_t x, int n)
+{
+	return (x << n) | (x >> (32 - n));
+}
+
+static std::string toHex(const unsigned char* bytes, size_t count)
+{
+	static const char digits[] = "0123456789abcdef";
+
+	std::string hex(count * 2, ' ');
+	for(size_t i = 0; i < count; i++)
+	{
+		hex[i * 2] = digits[bytes[i] >> 4];
+		hex[i * 2 + 1] = digits[bytes[i] & 0xF];
+	}
+	return hex;
+}
+
+// Both MD5 and SHA-1 work on 64 byte blocks and only differ in the transform and byte order.
+template<typename Transform>
+static void updateBlocks(const void* data, size_t size, unsigned char* buffer, uint64_t& length, Transform transform)
+{
+	const unsigned char* p = (const unsigned char*)data;
+	size_t used = (size_t)(length % 64);
+	length += size;
+
+	if(used)
+	{
+		const size_t fill = 64 - used;
+		if(size < fill)
+		{
+			memcpy(buffer + used, p, size);
+			return;
+		}
+
+		memcpy(buffer + used, p, fill);
+		transform(buffer);
+		p += fill;
+		size -= fill;
+	}
+
+	// straight from the input, no copy
+	for(; size >= 64; p += 64, size -= 64)
+		transform(p);
+
+	memcpy(buffer, p, size);
+}
+
+// MD5 (RFC 1321)
+
+Md5::Md5() : mLength(0)
+{
+	mState[0] = 0x67452301;
+	mState[1] = 0xEFCDAB89;
+	mState[2] = 0x98BADCFE;
+	mState[3] = 0x10325476;
+}
+
+void Md5::transform(const unsigned char* block)
+{
+	static const uint32_t K[64] = {
+		0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+		0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+		0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+		0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+		0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+		0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+		0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+		0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391 };
+	static const int S[64] = {
+		7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+		5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+		4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+		6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21 };
+
+	uint32_t M[16];
+	for(int i = 0; i < 16; i++)
+		M[i] = (uint32_t)block[i * 4] | ((uint32_t)block[i * 4 + 1] << 8) | ((uint32_t)block[i * 4 + 2] << 16) | ((uint32_t)block[i * 4 + 3] << 24);
+
+	// one loop per round, so the round function isn't picked 64 times per block
+	uint32_t a = mState[0], b = mState[1], c = mState[2], d = mState[3];
+#define MD5_STEP(f, g) \
+	{ \
+		const uint32_t temp = b + rotl(a + (f) + K[i] + M[g], S[i]); \
+		a = d; \
+		d = c; \
+		c = b; \
+		b = temp; \
+	}
+	for(int i = 0; i < 16; i++)
+		MD5_STEP((b & c) | (~b & d), i);
+	for(int i = 16; i < 32; i++)
+		MD5_STEP((d & b) | (~d & c), (5 * i + 1) & 15);
+	for(int i = 32; i < 48; i++)
+		MD5_STEP(b ^ c ^ d, (3 * i + 5) & 15);
+	for(int i = 48; i < 64; i++)
+		MD5_STEP(c ^ (b | ~d), (7 * i) & 15);
+#undef MD5_STEP
+
+	mState[0] += a;
+	mState[1] += b;
+	mState[2] += c;
+	mState[3] += d;
+}
+
+void Md5::update(const void* data, size_t size)
+{
+	updateBlocks(data, size, mBuffer, mLength, [this](const unsigned char* block) { transform(block); });
+}
+
+std::string Md5::finish()
+{
+	const uint64_t bits = mLength * 8;
+
+	unsigned char padding[72] = { 0x80 };
+	const size_t used = (size_t)(mLength % 64);
+	const size_t padLength = (used < 56) ? 56 - used : 120 - used;
+	update(padding, padLength);
+
+	unsigned char length[8];
+	for(int i = 0; i < 8; i++)
+		length[i] = (unsigned char)(bits >> (i * 8));
+	update(length, 8);
+
+	unsigned char digest[16];
+	for(int i = 0; i < 16; i++)
+		digest[i] = (unsigned char)(mState[i / 4] >> ((i % 4) * 8));
+	return toHex(digest, 16);
+}
+
+// SHA-1 (RFC 3174)
+
+Sha1::Sha1() : mLength(0)
+{
+	mState[0] = 0x67452301;
+	mState[1] = 0xEFCDAB89;
+	mState[2] = 0x98BADCFE;
+	mState[3] = 0x10325476;
+	mState[4] = 0xC3D2E1F0;
+}
+
+void Sha1::transform(const unsigned char* block)
+{
+	// the message schedule only ever looks 16 words back, so it's kept in a ring
+	uint32_t w[16];
+	for(int i = 0; i < 16; i++)
+		w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) | ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+
+	uint32_t a = mState[0], b = mState[1], c = mState[2], d = mState[3], e = mState[4];
+
+	// five steps at a time with the variables renamed instead of shifted along
+#define SHA1_W(i) ((i) < 16 ? w[(i)] : (w[(i) & 15] = rotl(w[((i) + 13) & 15] ^ w[((i) + 8) & 15] ^ w[((i) + 2) & 15] ^ w[(i) & 15], 1)))
+#define SHA1_STEP(f, k, v, x, t, i) \
+	t += (f) + SHA1_W(i) + (k) + rotl(v, 5); \
+	x = rotl(x, 30);
+#define SHA1_ROUND(F, k, start) \
+	for(int i = start; i < start + 20; i += 5) \
+	{ \
+		SHA1_STEP(F(b, c, d), k, a, b, e, i); \
+		SHA1_STEP(F(a, b, c), k, e, a, d, i + 1); \
+		SHA1_STEP(F(e, a, b), k, d, e, c, i + 2); \
+		SHA1_STEP(F(d, e, a), k, c, d, b, i + 3); \
+		SHA1_STEP(F(c, d, e), k, b, c, a, i + 4); \
+	}
+#define SHA1_CH(x, y, z) (((x) & ((y) ^ (z))) ^ (z))
+#define SHA1_PARITY(x, y, z) ((x) ^ (y) ^ (z))
+#define SHA1_MAJ(x, y, z) ((((x) | (y)) & (z)) | ((x) & (y)))
+
+	SHA1_ROUND(SHA1_CH, 0x5A827999, 0);
+	SHA1_ROUND(SHA1_PARITY, 0x6ED9EBA1, 20);
+	SHA1_ROUND(SHA1_MAJ, 0x8F1BBCDC, 40);
+	SHA1_ROUND(SHA1_PARITY, 0xCA62C1D6, 60);
+
+#undef SHA1_MAJ
+#undef SHA1_PARITY
+#undef SHA1_CH
+#undef SHA1_ROUND
+#undef SHA1_STEP
+#undef SHA1_W
+
+	mState[0] += a;
+	mState[1] += b;
+	mState[2] += c;
+	mState[3] += d;
+	mState[4] += e;
+}
+
+void Sha1::update(const void* data, size_t size)
+{
+	updateBlocks(data, size, mBuffer, mLength, [this](const unsigned char* block) { transform(block); });
+}
+
+std::string Sha1::finish()
+{
+	const uint64_t bits = mLength * 8;
+
+	unsigned char padding[72] = { 0x80 };
+	const size_t used = (size_t)(mLength % 64);
+	const size_t padLength = (used < 56) ? 56 - used : 120 - used;
+	update(padding, padLength);
+
+	unsigned char length[8];
+	for(int i = 0; i < 8; i++)
+		length[i] = (unsigned char)(bits >> ((7 - i) * 8));
+	update(length, 8);
+
+	unsigned char digest[20];
+	for(int i = 0; i < 20; i++)
+		digest[i] = (unsigned char)(mState[i / 4] >> ((3 - i % 4) * 8));
+	return toHex(digest, 20);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+#include <stddef.h>
+
+// Incremental checksums for identifying files by content, as listed in ROM databases.
+// Feed data with update() in as many pieces as convenient, then call finish() once.
+
+// CRC-32 as used by zip, PNG and DAT files (not the CRC-32C hardware instructions compute)
+class Crc32
+{
+public:
+	Crc32() : mCrc(0xFFFFFFFF) {}
+
+	void update(const void* data, size_t size);
+	inline uint32_t finish() const { return mCrc ^ 0xFFFFFFFF; }
+
+private:
+	uint32_t mCrc;
+};
+
+class Md5
+{
+public:
+	Md5();
+
+	void update(const void* data, size_t size);
+	std::string finish(); // lower case hex
+
+private:
+	void transform(const unsigned char* block);
+
+	uint32_t mState[4];
+	uint64_t mLength; // bytes
+	unsigned char mBuffer[64];
+};
+
+class Sha1
+{
+public:
+	Sha1();
+
+	void update(const void* data, size_t size);
+	std::string finish(); // lower case hex
+
+private:
+	void transform(const unsigned char* block);
+
+	uint32_t mState[5];
+	uint64_t mLength; // bytes
+	unsigned char mBuffer[64];
+};
@@ -0,0 +1,169 @@
+#include "HttpCache.h"
+#include "Log.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+// first line of every cache file, bump it if the layout changes
+#define HTTP_CACHE_MAGIC "ESHTTP1"
+#define HTTP_CACHE_EXTENSION ".http"
+
+// evicting down a bit further than the limit, so not every new response has to evict something
+#define HTTP_CACHE_TRIM_RATIO 0.9
+
+HttpCache::HttpCache(const std::string& directory) : mDirectory(directory), mSize(-1)
+{
+}
+
+std::string HttpCache::getPath(const std::string& url) const
+{
+	// 64 bit FNV-1a, the url in the file tells collisions apart
+	unsigned long long hash = 14695981039346656037ULL;
+	for(auto it = url.begin(); it != url.end(); it++)
+	{
+		hash ^= (unsigned char)*it;
+		hash *= 1099511628211ULL;
+	}
+
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", hash);
+	return mDirectory + "/" + name + HTTP_CACHE_EXTENSION;
+}
+
+bool HttpCache::get(const std::string& url, Entry& entry)
+{
+	const std::string path = getPath(url);
+
+	std::ifstream file(path, std::ios::binary);
+	if(!file)
+		return false;
+
+	std::string magic, storedUrl;
+	if(!std::getline(file, magic) || magic != HTTP_CACHE_MAGIC || !std::getline(file, storedUrl) || storedUrl != url)
+		return false;
+
+	if(!std::getline(file, entry.etag) || !std::getline(file, entry.lastModified))
+		return false;
+
+	entry.body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	boost::system::error_code ec;
+	entry.fetched = fs::last_write_time(path, ec);
+	return !ec;
+}
+
+void HttpCache::put(const std::string& url, const std::string& etag, const std::string& lastModified, const std::string& body, size_t maxSize)
+{
+	// wouldn't survive the next trim anyway
+	if(body.size() > maxSize * HTTP_CACHE_TRIM_RATIO)
+		return;
+
+	boost::system::error_code ec;
+	if(!fs::exists(mDirectory, ec))
+	{
+		fs::create_directories(mDirectory, ec);
+		if(ec)
+		{
+			LOG(LogError) << "Could not create HTTP cache directory \"" << mDirectory << "\": " << ec.message();
+			return;
+		}
+	}
+
+	if(mSize < 0)
+		trim(maxSize); // only counts what's there unless it's already too big
+
+	const std::string path = getPath(url);
+	const std::string tempPath = path + ".tmp";
+
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file << HTTP_CACHE_MAGIC << "\n" << url << "\n" << etag << "\n" << lastModified << "\n";
+		file.write(body.data(), body.size());
+		if(!file)
+		{
+			LOG(LogWarning) << "Could not write HTTP cache file \"" << tempPath << "\"";
+			file.close();
+			fs::remove(tempPath, ec);
+			return;
+		}
+	}
+
+	// replaced in one go, so an interrupted write never leaves half a response behind
+	const uintmax_t oldSize = fs::exists(path, ec) ? fs::file_size(path, ec) : 0;
+	const uintmax_t newSize = fs::file_size(tempPath, ec);
+	fs::rename(tempPath, path, ec);
+	if(ec)
+	{
+		LOG(LogWarning) << "Could not write HTTP cache file \"" << path << "\": " << ec.message();
+		fs::remove(tempPath, ec);
+		return;
+	}
+
+	mSize += (long long)newSize - (long long)oldSize;
+	if(mSize > (long long)maxSize)
+		trim(maxSize, path);
+}
+
+void HttpCache::touch(const std::string& url)
+{
+	boost::system::error_code ec;
+	fs::last_write_time(getPath(url), time(NULL), ec);
+}
+
+void HttpCache::trim(size_t maxSize, const std::string& keepPath)
+{
+	struct CacheFile
+	{
+		fs::path path;
+		time_t fetched;
+		uintmax_t size;
+	};
+
+	std::vector<CacheFile> files;
+	mSize = 0;
+
+	boost::system::error_code ec;
+	for(fs::directory_iterator it(mDirectory, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if(it->path().extension() != HTTP_CACHE_EXTENSION)
+			continue;
+
+		CacheFile file;
+		file.path = it->path();
+		file.fetched = fs::last_write_time(file.path, ec);
+		file.size = fs::file_size(file.path, ec);
+		if(ec)
+		{
+			ec.clear();
+			continue;
+		}
+
+		files.push_back(file);
+		mSize += file.size;
+	}
+
+	if(mSize <= (long long)maxSize)
+		return;
+
+	std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.fetched < b.fetched; });
+
+	const long long target = (long long)(maxSize * HTTP_CACHE_TRIM_RATIO);
+	unsigned int removed = 0;
+	for(auto it = files.begin(); it != files.end() && mSize > target; it++)
+	{
+		// modification times are only as fine as a second, don't throw out what was just written
+		if(it->path == keepPath)
+			continue;
+
+		if(fs::remove(it->path, ec))
+		{
+			mSize -= it->size;
+			removed++;
+		}
+	}
+
+	LOG(LogDebug) << "Evicted " << removed << " responses from the HTTP cache, " << mSize / 1024 << "KB left";
+}
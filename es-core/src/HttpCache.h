@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <ctime>
+
+// On-disk cache of HTTP responses, one file per URL (named after a hash of it) holding the
+// body and the validators needed to revalidate it. A file's modification time is when the
+// response was last fetched or revalidated, which is also what the oldest entries are evicted by
+// once the cache grows over its size limit.
+//
+// Only used by the HTTP network thread, so there's no locking.
+class HttpCache
+{
+public:
+	struct Entry
+	{
+		std::string body;
+		std::string etag;
+		std::string lastModified;
+		time_t fetched;
+	};
+
+	HttpCache(const std::string& directory);
+
+	// false if url isn't cached (or the file is unreadable)
+	bool get(const std::string& url, Entry& entry);
+
+	// Evicts the oldest responses if the cache ends up over maxSize bytes.
+	void put(const std::string& url, const std::string& etag, const std::string& lastModified, const std::string& body, size_t maxSize);
+
+	// The server said our copy is still good, count it as fetched now.
+	void touch(const std::string& url);
+
+private:
+	std::string getPath(const std::string& url) const;
+	void trim(size_t maxSize, const std::string& keepPath = "");
+
+	std::string mDirectory;
+	long long mSize; // bytes on disk, -1 until first needed
+};
@@ -1,11 +1,364 @@
 #include <iostream>
 #include "HttpReq.h"
+#include "HttpCache.h"
 #include "Log.h"
+#include "Settings.h"
+#include "platform.h"
 #include <boost/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 
-CURLM* HttpReq::s_multi_handle = curl_multi_init();
+// how long the network thread sleeps if nothing happens, new requests wake it up earlier
+#define HTTP_POLL_TIMEOUT 1000
+// older curl can't be woken up, so it has to check for new requests more often
+#define HTTP_WAIT_TIMEOUT 50
 
-std::map<CURL*, HttpReq*> HttpReq::s_requests;
+enum CacheMode
+{
+	CACHE_OFF,
+	CACHE_ON, // fresh responses come from the cache, stale ones are revalidated
+	CACHE_OFFLINE // only the cache, however old
+};
+
+struct HttpReq::Transfer
+{
+	CURL* handle;
+	std::atomic<int> status; // HttpReq::Status, set last by the network thread
+	std::string content; // only touched by the network thread while in progress
+	std::string errorMsg;
+
+	std::string url;
+	CacheMode cacheMode;
+	time_t cacheTtl; // seconds
+	size_t cacheMaxSize; // bytes
+	curl_slist* headers; // conditional request headers when revalidating
+	bool revalidating;
+	std::string cachedBody; // served if the server answers 304 Not Modified
+	std::string etag; // validators of the response
+	std::string lastModified;
+
+	// UI thread only
+	HttpReq* owner;
+	std::function<void(HttpReq*)> completionCallback;
+
+	// only transfers with a callback are queued for dispatchCompletions(), once
+	std::atomic<bool> wantsCompletion;
+	std::atomic<bool> completionQueued;
+
+	Transfer() : handle(NULL), status(REQ_IN_PROGRESS), cacheMode(CACHE_OFF), cacheTtl(0), cacheMaxSize(0),
+		headers(NULL), revalidating(false), owner(NULL), wantsCompletion(false), completionQueued(false) {}
+	~Transfer()
+	{
+		if(handle)
+			curl_easy_cleanup(handle);
+		if(headers)
+			curl_slist_free_all(headers);
+	}
+};
+
+// The only thread that touches the curl multi handle. Requests are handed over through
+// queues, and finished transfers with a completion callback are queued up for HttpReq::dispatchCompletions().
+class HttpThread
+{
+public:
+	static HttpThread* getInstance();
+	static inline bool isStarted() { return sInstance != NULL; }
+
+	void add(const std::shared_ptr<HttpReq::Transfer>& transfer);
+	void cancel(const std::shared_ptr<HttpReq::Transfer>& transfer);
+	void takeCompleted(std::vector< std::shared_ptr<HttpReq::Transfer> >& completed);
+	// hands a finished transfer to the next dispatchCompletions(), if it hasn't been already
+	void queueCompletion(const std::shared_ptr<HttpReq::Transfer>& transfer);
+
+	static size_t writeContent(void* buff, size_t size, size_t nmemb, void* transfer_ptr);
+	static size_t writeHeader(char* buff, size_t size, size_t nmemb, void* transfer_ptr);
+
+private:
+	HttpThread();
+
+	// true if the transfer was answered from the cache and is finished already
+	bool startFromCache(const std::shared_ptr<HttpReq::Transfer>& transfer);
+	void onResponse(const std::shared_ptr<HttpReq::Transfer>& transfer, long code);
+
+	void threadProc();
+	void wakeUp();
+	void finish(const std::shared_ptr<HttpReq::Transfer>& transfer, HttpReq::Status status, const std::string& errorMsg);
+
+	static HttpThread* sInstance;
+
+	CURLM* mMultiHandle;
+	HttpCache mCache; // network thread only
+	std::thread mThread;
+	std::mutex mMutex;
+	std::vector< std::shared_ptr<HttpReq::Transfer> > mAdded;
+	std::vector< std::shared_ptr<HttpReq::Transfer> > mCancelled;
+	std::vector< std::shared_ptr<HttpReq::Transfer> > mCompleted;
+	std::map< CURL*, std::shared_ptr<HttpReq::Transfer> > mActive; // network thread only
+};
+
+HttpThread* HttpThread::sInstance = NULL;
+
+HttpThread* HttpThread::getInstance()
+{
+	// never deleted, the thread may still be waiting on curl when the program exits
+	if(!sInstance)
+		sInstance = new HttpThread();
+
+	return sInstance;
+}
+
+HttpThread::HttpThread() : mMultiHandle(curl_multi_init()), mCache(getHomePath() + "/.emulationstation/http_cache")
+{
+	mThread = std::thread(&HttpThread::threadProc, this);
+	mThread.detach();
+}
+
+void HttpThread::add(const std::shared_ptr<HttpReq::Transfer>& transfer)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mAdded.push_back(transfer);
+	}
+	wakeUp();
+}
+
+void HttpThread::cancel(const std::shared_ptr<HttpReq::Transfer>& transfer)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mCancelled.push_back(transfer);
+	}
+	wakeUp();
+}
+
+void HttpThread::takeCompleted(std::vector< std::shared_ptr<HttpReq::Transfer> >& completed)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	completed.swap(mCompleted);
+}
+
+void HttpThread::wakeUp()
+{
+#if LIBCURL_VERSION_NUM >= 0x074400
+	curl_multi_wakeup(mMultiHandle);
+#endif
+}
+
+void HttpThread::queueCompletion(const std::shared_ptr<HttpReq::Transfer>& transfer)
+{
+	if(transfer->completionQueued.exchange(true))
+		return;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mCompleted.push_back(transfer);
+}
+
+void HttpThread::finish(const std::shared_ptr<HttpReq::Transfer>& transfer, HttpReq::Status status, const std::string& errorMsg)
+{
+	transfer->errorMsg = errorMsg;
+	transfer->status = status;
+
+	// requests that are polled instead don't need their response kept around for a dispatch that may never come.
+	// setCompletionCallback() queues it if it's set after this
+	if(transfer->wantsCompletion)
+		queueCompletion(transfer);
+}
+
+void HttpThread::threadProc()
+{
+	std::vector< std::shared_ptr<HttpReq::Transfer> > added;
+	std::vector< std::shared_ptr<HttpReq::Transfer> > cancelled;
+
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			added.swap(mAdded);
+			cancelled.swap(mCancelled);
+		}
+
+		// a request destroyed right after being created may be in both lists
+		for(auto it = cancelled.begin(); it != cancelled.end(); it++)
+		{
+			auto active = mActive.find((*it)->handle);
+			if(active != mActive.end())
+			{
+				curl_multi_remove_handle(mMultiHandle, active->first);
+				mActive.erase(active);
+			}else{
+				added.erase(std::remove(added.begin(), added.end(), *it), added.end());
+			}
+		}
+		cancelled.clear();
+
+		for(auto it = added.begin(); it != added.end(); it++)
+		{
+			if(startFromCache(*it))
+				continue;
+
+			CURLMcode merr = curl_multi_add_handle(mMultiHandle, (*it)->handle);
+			if(merr != CURLM_OK)
+				finish(*it, HttpReq::REQ_IO_ERROR, curl_multi_strerror(merr));
+			else
+				mActive[(*it)->handle] = *it;
+		}
+		added.clear();
+
+		int handleCount;
+		CURLMcode merr = curl_multi_perform(mMultiHandle, &handleCount);
+		if(merr != CURLM_OK && merr != CURLM_CALL_MULTI_PERFORM)
+			LOG(LogError) << "curl_multi_perform failed: " << curl_multi_strerror(merr);
+
+		int msgsLeft;
+		CURLMsg* msg;
+		while((msg = curl_multi_info_read(mMultiHandle, &msgsLeft)))
+		{
+			if(msg->msg != CURLMSG_DONE)
+				continue;
+
+			auto active = mActive.find(msg->easy_handle);
+			if(active == mActive.end())
+			{
+				LOG(LogError) << "Cannot find easy handle!";
+				continue;
+			}
+
+			std::shared_ptr<HttpReq::Transfer> transfer = active->second;
+			CURLcode result = msg->data.result; // msg is invalid once the handle is removed
+			mActive.erase(active);
+			curl_multi_remove_handle(mMultiHandle, transfer->handle);
+
+			if(result != CURLE_OK)
+			{
+				finish(transfer, HttpReq::REQ_IO_ERROR, curl_easy_strerror(result));
+				continue;
+			}
+
+			long code = 0;
+			curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &code);
+			onResponse(transfer, code);
+		}
+
+		// sleep until there's network activity, a timeout or a new request
+#if LIBCURL_VERSION_NUM >= 0x074400
+		curl_multi_poll(mMultiHandle, NULL, 0, HTTP_POLL_TIMEOUT, NULL);
+#else
+		curl_multi_wait(mMultiHandle, NULL, 0, HTTP_WAIT_TIMEOUT, NULL);
+#endif
+	}
+}
+
+bool HttpThread::startFromCache(const std::shared_ptr<HttpReq::Transfer>& transfer)
+{
+	if(transfer->cacheMode == CACHE_OFF)
+		return false;
+
+	HttpCache::Entry entry;
+	const bool cached = mCache.get(transfer->url, entry);
+
+	if(transfer->cacheMode == CACHE_OFFLINE)
+	{
+		if(cached)
+		{
+			transfer->content = std::move(entry.body);
+			finish(transfer, HttpReq::REQ_SUCCESS, "");
+		}else{
+			finish(transfer, HttpReq::REQ_IO_ERROR, "not in the HTTP cache, and offline");
+		}
+		return true;
+	}
+
+	if(!cached)
+		return false;
+
+	if(time(NULL) - entry.fetched < transfer->cacheTtl)
+	{
+		transfer->content = std::move(entry.body);
+		finish(transfer, HttpReq::REQ_SUCCESS, "");
+		return true;
+	}
+
+	// too old to trust, but the server may be able to tell us it hasn't changed instead of sending it again
+	if(!entry.etag.empty())
+		transfer->headers = curl_slist_append(transfer->headers, ("If-None-Match: " + entry.etag).c_str());
+	if(!entry.lastModified.empty())
+		transfer->headers = curl_slist_append(transfer->headers, ("If-Modified-Since: " + entry.lastModified).c_str());
+
+	if(transfer->headers)
+	{
+		curl_easy_setopt(transfer->handle, CURLOPT_HTTPHEADER, transfer->headers);
+		transfer->revalidating = true;
+		transfer->cachedBody = std::move(entry.body);
+	}
+
+	return false;
+}
+
+void HttpThread::onResponse(const std::shared_ptr<HttpReq::Transfer>& transfer, long code)
+{
+	if(code == 304 && transfer->revalidating)
+	{
+		mCache.touch(transfer->url);
+		transfer->content = std::move(transfer->cachedBody);
+		finish(transfer, HttpReq::REQ_SUCCESS, "");
+		return;
+	}
+
+	if(code >= 400)
+	{
+		std::stringstream ss;
+		ss << "HTTP status code " << code;
+		finish(transfer, HttpReq::REQ_BAD_STATUS_CODE, ss.str());
+		return;
+	}
+
+	if(code == 200 && transfer->cacheMode == CACHE_ON)
+		mCache.put(transfer->url, transfer->etag, transfer->lastModified, transfer->content, transfer->cacheMaxSize);
+
+	transfer->cachedBody.clear();
+	finish(transfer, HttpReq::REQ_SUCCESS, "");
+}
+
+//used as a curl callback
+//size = size of an element, nmemb = number of elements
+//return value is number of bytes taken, anything else aborts the transfer
+size_t HttpThread::writeContent(void* buff, size_t size, size_t nmemb, void* transfer_ptr)
+{
+	// appended in place, the finished string is handed to the caller without another copy
+	((HttpReq::Transfer*)transfer_ptr)->content.append((char*)buff, size * nmemb);
+	return size * nmemb;
+}
+
+//used as a curl callback, called once per header line (not null terminated, includes the line break)
+size_t HttpThread::writeHeader(char* buff, size_t size, size_t nmemb, void* transfer_ptr)
+{
+	HttpReq::Transfer* transfer = (HttpReq::Transfer*)transfer_ptr;
+	const size_t length = size * nmemb;
+
+	std::string line(buff, length);
+	const size_t colon = line.find(':');
+	if(colon == std::string::npos)
+		return length;
+
+	std::string name = line.substr(0, colon);
+	std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+	const size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+	const size_t valueEnd = line.find_last_not_of(" \t\r\n");
+	const std::string value = (valueStart == std::string::npos || valueEnd < valueStart) ? "" : line.substr(valueStart, valueEnd - valueStart + 1);
+
+	if(name == "etag")
+		transfer->etag = value;
+	else if(name == "last-modified")
+		transfer->lastModified = value;
+
+	return length;
+}
 
 std::string HttpReq::urlEncode(const std::string &s)
 {
@@ -36,142 +389,146 @@ bool HttpReq::isUrl(const std::string& str)
 		(str.find("http://") != std::string::npos || str.find("https://") != std::string::npos || str.find("www.") != std::string::npos));
 }
 
-HttpReq::HttpReq(const std::string& url)
-	: mStatus(REQ_IN_PROGRESS), mHandle(NULL)
+HttpReq::HttpReq(const std::string& url, long timeoutMs)
+	: mTransfer(std::make_shared<Transfer>())
 {
-	mHandle = curl_easy_init();
+	mTransfer->owner = this;
+	mTransfer->handle = curl_easy_init();
+	mTransfer->url = url;
+
+	Settings* settings = Settings::getInstance();
+	if(settings->getBool("HttpCacheOffline"))
+		mTransfer->cacheMode = CACHE_OFFLINE;
+	else if(settings->getBool("HttpCache"))
+		mTransfer->cacheMode = CACHE_ON;
+	mTransfer->cacheTtl = (time_t)settings->getInt("HttpCacheHours") * 60 * 60;
+	mTransfer->cacheMaxSize = (size_t)std::max(0, settings->getInt("HttpCacheMaxSize")) * 1024 * 1024;
 
-	if(mHandle == NULL)
+	CURL* handle = mTransfer->handle;
+	if(handle == NULL)
 	{
-		mStatus = REQ_IO_ERROR;
 		onError("curl_easy_init failed");
 		return;
 	}
 
 	//set the url
-	CURLcode err = curl_easy_setopt(mHandle, CURLOPT_URL, url.c_str());
+	CURLcode err = curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
 	if(err != CURLE_OK)
 	{
-		mStatus = REQ_IO_ERROR;
 		onError(curl_easy_strerror(err));
 		return;
 	}
 
+	//signals can't be used for timeouts outside of the main thread
+	err = curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+	if(err != CURLE_OK)
+	{
+		onError(curl_easy_strerror(err));
+		return;
+	}
+
+	if(timeoutMs > 0)
+	{
+		err = curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, timeoutMs);
+		if(err != CURLE_OK)
+		{
+			onError(curl_easy_strerror(err));
+			return;
+		}
+	}
+
 	//tell curl how to write the data
-	err = curl_easy_setopt(mHandle, CURLOPT_WRITEFUNCTION, &HttpReq::write_content);
+	err = curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &HttpThread::writeContent);
 	if(err != CURLE_OK)
 	{
-		mStatus = REQ_IO_ERROR;
 		onError(curl_easy_strerror(err));
 		return;
 	}
 
-	//give curl a pointer to this HttpReq so we know where to write the data *to* in our write function
-	err = curl_easy_setopt(mHandle, CURLOPT_WRITEDATA, this);
+	//give curl a pointer to the transfer so we know where to write the data *to* in our write function
+	err = curl_easy_setopt(handle, CURLOPT_WRITEDATA, mTransfer.get());
 	if(err != CURLE_OK)
 	{
-		mStatus = REQ_IO_ERROR;
 		onError(curl_easy_strerror(err));
 		return;
 	}
 
-	//add the handle to our multi
-	CURLMcode merr = curl_multi_add_handle(s_multi_handle, mHandle);
-	if(merr != CURLM_OK)
+	//the validators are kept with cached responses
+	err = curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, &HttpThread::writeHeader);
+	if(err != CURLE_OK)
 	{
-		mStatus = REQ_IO_ERROR;
-		onError(curl_multi_strerror(merr));
+		onError(curl_easy_strerror(err));
+		return;
+	}
+
+	err = curl_easy_setopt(handle, CURLOPT_HEADERDATA, mTransfer.get());
+	if(err != CURLE_OK)
+	{
+		onError(curl_easy_strerror(err));
 		return;
 	}
 
-	s_requests[mHandle] = this;
+	HttpThread::getInstance()->add(mTransfer);
 }
 
 HttpReq::~HttpReq()
 {
-	if(mHandle)
-	{
-		s_requests.erase(mHandle);
-
-		CURLMcode merr = curl_multi_remove_handle(s_multi_handle, mHandle);
-
-		if(merr != CURLM_OK)
-			LOG(LogError) << "Error removing curl_easy handle from curl_multi: " << curl_multi_strerror(merr);
-
-		curl_easy_cleanup(mHandle);
-	}
+	// the transfer itself is cleaned up once the network thread lets go of it too
+	mTransfer->owner = NULL;
+	if(mTransfer->status == REQ_IN_PROGRESS)
+		HttpThread::getInstance()->cancel(mTransfer);
 }
 
 HttpReq::Status HttpReq::status()
 {
-	if(mStatus == REQ_IN_PROGRESS)
-	{
-		int handle_count;
-		CURLMcode merr = curl_multi_perform(s_multi_handle, &handle_count);
-		if(merr != CURLM_OK && merr != CURLM_CALL_MULTI_PERFORM)
-		{
-			mStatus = REQ_IO_ERROR;
-			onError(curl_multi_strerror(merr));
-			return mStatus;
-		}
-
-		int msgs_left;
-		CURLMsg* msg;
-		while(msg = curl_multi_info_read(s_multi_handle, &msgs_left))
-		{
-			if(msg->msg == CURLMSG_DONE)
-			{
-				HttpReq* req = s_requests[msg->easy_handle];
-				
-				if(req == NULL)
-				{
-					LOG(LogError) << "Cannot find easy handle!";
-					continue;
-				}
-
-				if(msg->data.result == CURLE_OK)
-				{
-					req->mStatus = REQ_SUCCESS;
-				}else{
-					req->mStatus = REQ_IO_ERROR;
-					req->onError(curl_easy_strerror(msg->data.result));
-				}
-			}
-		}
-	}
-
-	return mStatus;
+	return (Status)mTransfer->status.load();
 }
 
-std::string HttpReq::getContent() const
+const std::string& HttpReq::getContent() const
 {
-	assert(mStatus == REQ_SUCCESS);
-	return mContent.str();
+	assert(mTransfer->status == REQ_SUCCESS);
+	return mTransfer->content;
 }
 
-void HttpReq::onError(const char* msg)
+std::string HttpReq::takeContent()
 {
-	mErrorMsg = msg;
+	assert(mTransfer->status == REQ_SUCCESS);
+	return std::move(mTransfer->content);
 }
 
-std::string HttpReq::getErrorMsg()
+void HttpReq::setCompletionCallback(const std::function<void(HttpReq*)>& callback)
 {
-	return mErrorMsg;
+	mTransfer->completionCallback = callback;
+	mTransfer->wantsCompletion = true;
+
+	// finished already, by the network thread or because the constructor failed
+	if(mTransfer->status != REQ_IN_PROGRESS)
+		HttpThread::getInstance()->queueCompletion(mTransfer);
 }
 
-//used as a curl callback
-//size = size of an element, nmemb = number of elements
-//return value is number of elements successfully read
-size_t HttpReq::write_content(void* buff, size_t size, size_t nmemb, void* req_ptr)
+void HttpReq::dispatchCompletions()
 {
-	std::stringstream& ss = ((HttpReq*)req_ptr)->mContent;
-	ss.write((char*)buff, size * nmemb);
+	if(!HttpThread::isStarted())
+		return;
+
+	std::vector< std::shared_ptr<Transfer> > completed;
+	HttpThread::getInstance()->takeCompleted(completed);
 
-	return nmemb;
+	// a callback may destroy other requests, which clears their owner
+	for(auto it = completed.begin(); it != completed.end(); it++)
+	{
+		if((*it)->owner && (*it)->completionCallback)
+			(*it)->completionCallback((*it)->owner);
+	}
 }
 
-//used as a curl callback
-/*int HttpReq::update_progress(void* req_ptr, double dlTotal, double dlNow, double ulTotal, double ulNow)
+void HttpReq::onError(const char* msg)
 {
-	
-}*/
+	mTransfer->errorMsg = msg;
+	mTransfer->status = REQ_IO_ERROR;
+}
+
+std::string HttpReq::getErrorMsg()
+{
+	return mTransfer->errorMsg;
+}
@@ -1,14 +1,20 @@
 #pragma once
 
 #include <curl/curl.h>
-#include <sstream>
-#include <map>
+#include <string>
+#include <memory>
+#include <functional>
+
+// whole transfer, connecting included
+#define HTTP_DEFAULT_TIMEOUT 30000
 
 /* Usage:
- * HttpReq myRequest("www.google.com", "/index.html");
+ * HttpReq myRequest("www.google.com/index.html");
+ * //transfers run on a background network thread, status() only reports how far it got
  * //for blocking behavior: while(myRequest.status() == HttpReq::REQ_IN_PROGRESS);
- * //for non-blocking behavior: check if(myRequest.status() != HttpReq::REQ_IN_PROGRESS) in some sort of update method
- * 
+ * //for non-blocking behavior: check if(myRequest.status() != HttpReq::REQ_IN_PROGRESS) in some sort of update method,
+ * //or set a completion callback, which Window::update() runs on the UI thread once the request finished
+ *
  * //once one of those completes, the request is ready
  * if(myRequest.status() != REQ_SUCCESS)
  * {
@@ -17,14 +23,15 @@
  *    return;
  * }
  *
- * std::string content = myRequest.getContent();
+ * const std::string& content = myRequest.getContent(); // or takeContent() to move it out
  * //process contents...
 */
 
 class HttpReq
 {
 public:
-	HttpReq(const std::string& url);
+	// timeoutMs of 0 means no time limit
+	HttpReq(const std::string& url, long timeoutMs = HTTP_DEFAULT_TIMEOUT);
 
 	~HttpReq();
 
@@ -33,36 +40,33 @@ public:
 		REQ_IN_PROGRESS,		//request is in progress
 		REQ_SUCCESS,			//request completed successfully, get it with getContent()
 
-		REQ_IO_ERROR,			//some boost::asio error happened, get it with getErrorMsg()
-		REQ_BAD_STATUS_CODE,	//some invalid HTTP response status code happened (non-200)
+		REQ_IO_ERROR,			//some curl error happened (including timeouts), get it with getErrorMsg()
+		REQ_BAD_STATUS_CODE,	//the server answered with an HTTP error status (400 and up)
 		REQ_INVALID_RESPONSE	//the HTTP response was invalid
 	};
 
-	Status status(); //process any received data and return the status afterwards
+	Status status(); //return the status of the transfer, which is driven by the network thread
 
 	std::string getErrorMsg();
 
-	std::string getContent() const; // mStatus must be REQ_SUCCESS
+	const std::string& getContent() const; // mStatus must be REQ_SUCCESS
+	std::string takeContent(); // as above, but moves the content out instead of copying it
 
-	static std::string urlEncode(const std::string &s);
-	static bool isUrl(const std::string& s);
+	// Run on the UI thread by dispatchCompletions() once the request is no longer in progress, including
+	// when it failed in the constructor. Not called if the request is destroyed before that.
+	void setCompletionCallback(const std::function<void(HttpReq*)>& callback);
 
-private:
-	static size_t write_content(void* buff, size_t size, size_t nmemb, void* req_ptr);
-	//static int update_progress(void* req_ptr, double dlTotal, double dlNow, double ulTotal, double ulNow);
+	// Runs the completion callbacks of the requests that finished since the last call.
+	static void dispatchCompletions();
 
-	//god dammit libcurl why can't you have some way to check the status of an individual handle
-	//why do I have to handle ALL messages at once
-	static std::map<CURL*, HttpReq*> s_requests;
+	static std::string urlEncode(const std::string &s);
+	static bool isUrl(const std::string& s);
 
-	static CURLM* s_multi_handle;
+	// State shared with the network thread, which keeps it alive until curl is done with it.
+	struct Transfer;
 
+private:
 	void onError(const char* msg);
 
-	CURL* mHandle;
-
-	Status mStatus;
-
-	std::stringstream mContent;
-	std::string mErrorMsg;
+	std::shared_ptr<Transfer> mTransfer;
 };
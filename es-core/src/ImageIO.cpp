@@ -91,3 +91,85 @@ void ImageIO::flipPixelsVert(unsigned char* imagePx, const size_t& width, const
 		}
 	}
 }
+
+static inline unsigned int readBE16(const unsigned char* p) { return (p[0] << 8) | p[1]; }
+static inline unsigned int readBE32(const unsigned char* p) { return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+static inline unsigned int readLE16(const unsigned char* p) { return p[0] | (p[1] << 8); }
+static inline int readLE32(const unsigned char* p) { return (int)(p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24)); }
+
+bool ImageIO::getImageSize(const unsigned char* data, const size_t size, size_t& width, size_t& height)
+{
+	width = 0;
+	height = 0;
+
+	// PNG - the IHDR chunk always comes first
+	static const unsigned char pngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if(size >= 24 && memcmp(data, pngSignature, 8) == 0)
+	{
+		width = readBE32(data + 16);
+		height = readBE32(data + 20);
+	}
+	// GIF - logical screen size follows the signature
+	else if(size >= 10 && (memcmp(data, "GIF87a", 6) == 0 || memcmp(data, "GIF89a", 6) == 0))
+	{
+		width = readLE16(data + 6);
+		height = readLE16(data + 8);
+	}
+	// BMP - size is in the DIB header, which is the old 16 bit kind if it's 12 bytes long
+	else if(size >= 26 && data[0] == 'B' && data[1] == 'M')
+	{
+		if(readLE32(data + 14) == 12)
+		{
+			width = readLE16(data + 18);
+			height = readLE16(data + 20);
+		}else{
+			int h = readLE32(data + 22);
+			width = (size_t)readLE32(data + 18);
+			height = (size_t)(h < 0 ? -h : h); // negative for top-down bitmaps
+		}
+	}
+	// JPEG - walk the segments until we find a start of frame
+	else if(size >= 4 && data[0] == 0xFF && data[1] == 0xD8)
+	{
+		size_t pos = 2;
+		while(pos + 4 <= size)
+		{
+			if(data[pos] != 0xFF)
+				return false;
+
+			const unsigned char marker = data[pos + 1];
+			if(marker == 0xFF)
+			{
+				// fill byte
+				pos++;
+				continue;
+			}
+
+			if(marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+			{
+				// markers without a length
+				pos += 2;
+				continue;
+			}
+
+			// SOF0-SOF15, except DHT (C4), JPG (C8) and DAC (CC)
+			if(marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+			{
+				if(pos + 9 > size)
+					return false;
+
+				height = readBE16(data + pos + 5);
+				width = readBE16(data + pos + 7);
+				break;
+			}
+
+			// start of scan or end of image before any frame header, give up
+			if(marker == 0xDA || marker == 0xD9)
+				return false;
+
+			pos += 2 + readBE16(data + pos + 2);
+		}
+	}
+
+	return (width != 0 && height != 0);
+}
@@ -8,4 +8,8 @@ class ImageIO
 public:
 	static std::vector<unsigned char> loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height);
 	static void flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height);
+
+	// Reads the dimensions of a PNG, JPEG, GIF or BMP image from the start of its file without
+	// decoding any pixels. Returns false if the format isn't recognised or more data is needed.
+	static bool getImageSize(const unsigned char* data, const size_t size, size_t& width, size_t& height);
 };
\ No newline at end of file
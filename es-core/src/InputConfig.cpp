@@ -47,15 +47,51 @@ std::string toLower(std::string str)
 
 	return str;
 }
+
+// names of the InputAction values, in order
+static const char* actionNames[ACTION_COUNT] = { "up", "down", "left", "right", "a", "b", "start", "select",
+	"pageup", "pagedown", "leftbottom", "rightbottom" };
+
+static bool inputMatches(const Input& comp, const Input& input)
+{
+	if(comp.configured && comp.type == input.type && comp.id == input.id)
+	{
+		if(comp.type == TYPE_HAT)
+		{
+			return (input.value == 0 || input.value & comp.value);
+		}
+
+		if(comp.type == TYPE_AXIS)
+		{
+			return input.value == 0 || comp.value == input.value;
+		}else{
+			return true;
+		}
+	}
+	return false;
+}
 //end util functions
 
-InputConfig::InputConfig(int deviceId, const std::string& deviceName, const std::string& deviceGUID) : mDeviceId(deviceId), mDeviceName(deviceName), mDeviceGUID(deviceGUID)
+InputConfig::InputConfig(int deviceId, const std::string& deviceName, const std::string& deviceGUID) : mActionsVersion(0), mDeviceId(deviceId), mDeviceName(deviceName), mDeviceGUID(deviceGUID)
 {
 }
 
 void InputConfig::clear()
 {
 	mNameMap.clear();
+	updateActions();
+}
+
+void InputConfig::updateActions()
+{
+	for(int i = 0; i < ACTION_COUNT; i++)
+	{
+		auto it = mNameMap.find(actionNames[i]);
+		mActionInputs[i] = (it != mNameMap.end()) ? it->second : Input();
+	}
+
+	// anything resolved against the old mapping is out of date now
+	mActionsVersion++;
 }
 
 bool InputConfig::isConfigured()
@@ -66,13 +102,17 @@ bool InputConfig::isConfigured()
 void InputConfig::mapInput(const std::string& name, Input input)
 {
 	mNameMap[toLower(name)] = input;
+	updateActions();
 }
 
 void InputConfig::unmapInput(const std::string& name)
 {
 	auto it = mNameMap.find(toLower(name));
 	if(it != mNameMap.end())
+	{
 		mNameMap.erase(it);
+		updateActions();
+	}
 }
 
 bool InputConfig::getInputByName(const std::string& name, Input* result)
@@ -89,25 +129,38 @@ bool InputConfig::getInputByName(const std::string& name, Input* result)
 
 bool InputConfig::isMappedTo(const std::string& name, Input input)
 {
+	const std::string lowerName = toLower(name);
+	for(int i = 0; i < ACTION_COUNT; i++)
+	{
+		if(lowerName == actionNames[i])
+			return isMappedTo((InputAction)i, input);
+	}
+
 	Input comp;
-	if(!getInputByName(name, &comp))
+	if(!getInputByName(lowerName, &comp))
 		return false;
-	
-	if(comp.configured && comp.type == input.type && comp.id == input.id)
-	{
-		if(comp.type == TYPE_HAT)
-		{
-			return (input.value == 0 || input.value & comp.value);
-		}
 
-		if(comp.type == TYPE_AXIS)
-		{
-			return input.value == 0 || comp.value == input.value;
-		}else{
-			return true;
-		}
+	return inputMatches(comp, input);
+}
+
+bool InputConfig::isMappedTo(InputAction action, const Input& input) const
+{
+	if(input.actionsConfig == this && input.actionsVersion == mActionsVersion)
+		return (input.actions & (1 << action)) != 0;
+
+	return inputMatches(mActionInputs[action], input);
+}
+
+void InputConfig::resolveActions(Input& input) const
+{
+	input.actions = 0;
+	for(int i = 0; i < ACTION_COUNT; i++)
+	{
+		if(inputMatches(mActionInputs[i], input))
+			input.actions |= (1 << i);
 	}
-	return false;
+	input.actionsConfig = this;
+	input.actionsVersion = mActionsVersion;
 }
 
 std::vector<std::string> InputConfig::getMappedTo(Input input)
@@ -170,6 +223,8 @@ void InputConfig::loadFromXML(pugi::xml_node node)
 
 		mNameMap[toLower(name)] = Input(mDeviceId, typeEnum, id, value, true);
 	}
+
+	updateActions();
 }
 
 void InputConfig::writeToXML(pugi::xml_node parent)
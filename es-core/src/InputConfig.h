@@ -19,6 +19,27 @@ enum InputType
 	TYPE_COUNT
 };
 
+// The named inputs components react to. InputManager works out which of them an event is
+// mapped to once, so checking one is a bit test instead of a lookup by name.
+enum InputAction
+{
+	ACTION_UP,
+	ACTION_DOWN,
+	ACTION_LEFT,
+	ACTION_RIGHT,
+	ACTION_A,
+	ACTION_B,
+	ACTION_START,
+	ACTION_SELECT,
+	ACTION_PAGEUP,
+	ACTION_PAGEDOWN,
+	ACTION_LEFTBOTTOM,
+	ACTION_RIGHTBOTTOM,
+	ACTION_COUNT
+};
+
+class InputConfig;
+
 struct Input
 {
 public:
@@ -28,6 +49,12 @@ public:
 	int value;
 	bool configured;
 
+	// Bit per InputAction, filled in by InputConfig::resolveActions(). Only valid for
+	// actionsConfig as it was at actionsVersion
+	unsigned int actions;
+	const InputConfig* actionsConfig;
+	unsigned int actionsVersion;
+
 	Input()
 	{
 		device = DEVICE_KEYBOARD;
@@ -35,9 +62,13 @@ public:
 		id = -1;
 		value = -999;
 		type = TYPE_COUNT;
+		actions = 0;
+		actionsConfig = NULL;
+		actionsVersion = 0;
 	}
 
-	Input(int dev, InputType t, int i, int val, bool conf) : device(dev), type(t), id(i), value(val), configured(conf)
+	Input(int dev, InputType t, int i, int val, bool conf) : device(dev), type(t), id(i), value(val), configured(conf),
+		actions(0), actionsConfig(NULL), actionsVersion(0)
 	{
 	}
 
@@ -95,6 +126,11 @@ public:
 
 	//Returns true if Input is mapped to this name, false otherwise.
 	bool isMappedTo(const std::string& name, Input input);
+	//Same for the common names, without looking anything up if input has been through resolveActions().
+	bool isMappedTo(InputAction action, const Input& input) const;
+
+	//Work out every action input is mapped to and store them in it.
+	void resolveActions(Input& input) const;
 
 	//Returns a list of names this input is mapped to.
 	std::vector<std::string> getMappedTo(Input input);
@@ -109,7 +145,12 @@ private:
 	// Writes Input mapped to this name to result if true.
 	bool getInputByName(const std::string& name, Input* result);
 
+	//Rebuild mActionInputs after the mapping changed.
+	void updateActions();
+
 	std::map<std::string, Input> mNameMap;
+	Input mActionInputs[ACTION_COUNT];
+	unsigned int mActionsVersion;
 	const int mDeviceId;
 	const std::string mDeviceName;
 	const std::string mDeviceGUID;
@@ -8,6 +8,7 @@
 
 class InputConfig;
 class Window;
+struct Input;
 
 //you should only ever instantiate one of these, by the way
 class InputManager
@@ -33,6 +34,8 @@ private:
 	void removeJoystickByJoystickID(SDL_JoystickID id);
 	bool loadInputConfig(InputConfig* config); // returns true if successfully loaded, false if not (or didn't exist)
 
+	void sendInput(Window* window, Input input); // records (if enabled) and forwards an input to the window
+
 public:
 	virtual ~InputManager();
 
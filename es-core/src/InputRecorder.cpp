@@ -0,0 +1,273 @@
+#include "InputRecorder.h"
+#include "InputManager.h"
+#include "Window.h"
+#include "Renderer.h"
+#include "Log.h"
+#include "resources/TextureData.h"
+#include <SDL.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// keep rendering this long after the last input so trailing animations and texture loads are timed too
+#define REPLAY_SETTLE_TIME 1000
+#define REPLAY_WORST_FRAMES 10
+
+struct ReplayEvent
+{
+	unsigned int time;
+	bool isText;
+	Input input;
+	std::string text;
+};
+
+struct ReplayFrame
+{
+	unsigned int time;
+	float updateTime; // ms
+	float renderTime; // ms
+	unsigned int stalls;
+	float stallTime; // ms
+};
+
+InputRecorder* InputRecorder::sInstance = NULL;
+
+InputRecorder::InputRecorder() : mStartTime(0)
+{
+}
+
+InputRecorder* InputRecorder::getInstance()
+{
+	if(!sInstance)
+		sInstance = new InputRecorder();
+
+	return sInstance;
+}
+
+bool InputRecorder::startRecording(const std::string& path)
+{
+	stopRecording();
+
+	mFile.open(path.c_str(), std::ios::out | std::ios::trunc);
+	if(!mFile.is_open())
+	{
+		LOG(LogError) << "Could not open input log \"" << path << "\" for writing!";
+		return false;
+	}
+
+	mStartTime = SDL_GetTicks();
+	LOG(LogInfo) << "Recording input to \"" << path << "\"";
+	return true;
+}
+
+void InputRecorder::stopRecording()
+{
+	if(mFile.is_open())
+		mFile.close();
+}
+
+void InputRecorder::recordInput(Input input)
+{
+	if(!mFile.is_open())
+		return;
+
+	mFile << (SDL_GetTicks() - mStartTime) << " input " << input.device << " " << input.type << " " << input.id << " " << input.value << "\n";
+}
+
+void InputRecorder::recordText(const char* text)
+{
+	if(!mFile.is_open())
+		return;
+
+	mFile << (SDL_GetTicks() - mStartTime) << " text " << text << "\n";
+}
+
+static bool loadReplayEvents(const std::string& path, std::vector<ReplayEvent>& events)
+{
+	std::ifstream file(path.c_str());
+	if(!file.is_open())
+		return false;
+
+	std::string line;
+	while(std::getline(file, line))
+	{
+		std::istringstream ss(line);
+		ReplayEvent ev;
+		std::string kind;
+		if(!(ss >> ev.time >> kind))
+			continue;
+
+		if(kind == "input")
+		{
+			int type;
+			ev.isText = false;
+			if(!(ss >> ev.input.device >> type >> ev.input.id >> ev.input.value) || type < 0 || type >= TYPE_COUNT)
+			{
+				LOG(LogWarning) << "Skipping malformed input log line \"" << line << "\"";
+				continue;
+			}
+			ev.input.type = (InputType)type;
+			ev.input.configured = false;
+		}else if(kind == "text")
+		{
+			ev.isText = true;
+			ss.get(); // skip the separator
+			std::getline(ss, ev.text);
+		}else{
+			LOG(LogWarning) << "Skipping unknown input log line \"" << line << "\"";
+			continue;
+		}
+
+		events.push_back(ev);
+	}
+
+	// the log should already be in order, but a stable sort keeps same-time events as recorded
+	std::stable_sort(events.begin(), events.end(), [](const ReplayEvent& a, const ReplayEvent& b) { return a.time < b.time; });
+	return true;
+}
+
+static float percentile(std::vector<float> values, float p)
+{
+	if(values.empty())
+		return 0;
+
+	std::sort(values.begin(), values.end());
+	return values.at((size_t)(p * (values.size() - 1)));
+}
+
+static void printReport(const std::string& path, int frameTime, unsigned int inputCount, const std::vector<ReplayFrame>& frames)
+{
+	std::vector<float> updateTimes;
+	std::vector<float> renderTimes;
+	float updateTotal = 0;
+	float renderTotal = 0;
+	unsigned int overBudget = 0;
+	unsigned int stalls = 0;
+	unsigned int stalledFrames = 0;
+	float stallTotal = 0;
+
+	for(auto it = frames.begin(); it != frames.end(); it++)
+	{
+		updateTimes.push_back(it->updateTime);
+		renderTimes.push_back(it->renderTime);
+		updateTotal += it->updateTime;
+		renderTotal += it->renderTime;
+		if(it->updateTime + it->renderTime > frameTime)
+			overBudget++;
+		if(it->stalls)
+		{
+			stalls += it->stalls;
+			stalledFrames++;
+			stallTotal += it->stallTime;
+		}
+	}
+
+	std::vector<size_t> worst(frames.size());
+	for(size_t i = 0; i < worst.size(); i++)
+		worst[i] = i;
+	std::sort(worst.begin(), worst.end(), [&frames](size_t a, size_t b) {
+		return frames[a].updateTime + frames[a].renderTime > frames[b].updateTime + frames[b].renderTime;
+	});
+	if(worst.size() > REPLAY_WORST_FRAMES)
+		worst.resize(REPLAY_WORST_FRAMES);
+
+	const float count = frames.empty() ? 1.0f : (float)frames.size();
+
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	ss << "Replay of \"" << path << "\": " << frames.size() << " frames, " << inputCount << " inputs, " << frameTime << "ms per frame\n";
+	ss << "  update: avg " << updateTotal / count << "ms, 95% " << percentile(updateTimes, 0.95f) << "ms, max " << percentile(updateTimes, 1.0f) << "ms\n";
+	ss << "  render: avg " << renderTotal / count << "ms, 95% " << percentile(renderTimes, 0.95f) << "ms, max " << percentile(renderTimes, 1.0f) << "ms\n";
+	ss << "  frames over budget: " << overBudget << "\n";
+	ss << "  texture load stalls: " << stalls << " in " << stalledFrames << " frames, " << stallTotal << "ms total\n";
+	ss << "  slowest frames:\n";
+	for(auto it = worst.begin(); it != worst.end(); it++)
+	{
+		const ReplayFrame& frame = frames[*it];
+		ss << "    frame " << *it << " (" << frame.time << "ms): update " << frame.updateTime << "ms, render " << frame.renderTime << "ms";
+		if(frame.stalls)
+			ss << ", " << frame.stalls << " stalls (" << frame.stallTime << "ms)";
+		ss << "\n";
+	}
+
+	std::cout << ss.str();
+	LOG(LogInfo) << ss.str();
+}
+
+bool InputRecorder::replay(const std::string& path, Window* window, int frameTime)
+{
+	std::vector<ReplayEvent> events;
+	if(!loadReplayEvents(path, events))
+	{
+		LOG(LogError) << "Could not open input log \"" << path << "\" for replay!";
+		return false;
+	}
+
+	if(frameTime <= 0)
+		frameTime = 16;
+
+	LOG(LogInfo) << "Replaying " << events.size() << " inputs from \"" << path << "\"";
+
+	InputManager* im = InputManager::getInstance();
+	std::vector<ReplayFrame> frames;
+	unsigned int clock = 0;
+	unsigned int endTime = (events.empty() ? 0 : events.back().time) + REPLAY_SETTLE_TIME;
+	size_t next = 0;
+	bool running = true;
+
+	while(running && clock <= endTime)
+	{
+		// real devices are ignored so they can't disturb the replay, but still allow quitting
+		SDL_Event event;
+		while(SDL_PollEvent(&event))
+		{
+			if(event.type == SDL_QUIT)
+				running = false;
+		}
+
+		while(next < events.size() && events[next].time <= clock)
+		{
+			const ReplayEvent& ev = events[next++];
+			if(ev.isText)
+			{
+				window->textInput(ev.text.c_str());
+			}else{
+				InputConfig* config = im->getInputConfigByDevice(ev.input.device);
+				if(config == NULL)
+				{
+					LOG(LogWarning) << "Input log refers to unconnected device " << ev.input.device << ", skipping input";
+					continue;
+				}
+				Input input = ev.input;
+				config->resolveActions(input);
+				window->input(config, input);
+			}
+		}
+
+		ReplayFrame frame;
+		frame.time = clock;
+		const unsigned int stallCount = TextureData::getStallCount();
+		const unsigned int stallTime = TextureData::getStallTime();
+
+		auto start = std::chrono::high_resolution_clock::now();
+		window->update(frameTime);
+		auto updated = std::chrono::high_resolution_clock::now();
+		window->render();
+		auto rendered = std::chrono::high_resolution_clock::now();
+		Renderer::swapBuffers();
+
+		frame.updateTime = std::chrono::duration_cast<std::chrono::microseconds>(updated - start).count() / 1000.0f;
+		frame.renderTime = std::chrono::duration_cast<std::chrono::microseconds>(rendered - updated).count() / 1000.0f;
+		frame.stalls = TextureData::getStallCount() - stallCount;
+		frame.stallTime = (TextureData::getStallTime() - stallTime) / 1000.0f;
+		frames.push_back(frame);
+
+		clock += frameTime;
+	}
+
+	printReport(path, frameTime, (unsigned int)next, frames);
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include "InputConfig.h"
+
+class Window;
+
+// Records the inputs InputManager sends to the Window into a timestamped log, and plays
+// such a log back with a fixed frame time instead of the real clock so that a session
+// (e.g. scrolling a long gamelist) can be repeated exactly and its frame timings compared.
+//
+// Log format, one event per line, times in ms since the recording started:
+//   <time> input <device> <type> <id> <value>
+//   <time> text <utf8 text>
+class InputRecorder
+{
+public:
+	static InputRecorder* getInstance();
+
+	bool startRecording(const std::string& path);
+	void stopRecording();
+	inline bool isRecording() const { return mFile.is_open(); }
+
+	void recordInput(Input input);
+	void recordText(const char* text);
+
+	// Feeds the log at path into window, advancing a virtual clock by frameTime ms
+	// every frame. Prints per-frame update/render timings and texture load stalls
+	// when done. Returns false if the log could not be read.
+	bool replay(const std::string& path, Window* window, int frameTime);
+
+private:
+	InputRecorder();
+
+	static InputRecorder* sInstance;
+
+	std::ofstream mFile;
+	unsigned int mStartTime;
+};
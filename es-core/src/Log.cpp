@@ -2,14 +2,171 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include "platform.h"
 
+// must be a power of two
+#define LOG_QUEUE_SIZE 1024
+#define LOG_MAX_FILE_SIZE (2 * 1024 * 1024)
+// how long the writer waits before writing out messages that nobody asked to be flushed
+#define LOG_WRITE_INTERVAL 250
+// longest flush() waits for the writer, in case a message it's waiting for is never finished
+#define LOG_FLUSH_TIMEOUT 1000
+
 LogLevel Log::reportingLevel = LogInfo;
 FILE* Log::file = NULL; //fopen(getLogPath().c_str(), "w");
 
-LogLevel Log::getReportingLevel()
+// Messages allowed per second for each level, 0 for no limit. Anything over is counted and dropped
+static const unsigned int sRateLimits[] = { 0, 500, 500, 2000 };
+
+// Bounded multi producer, single consumer queue. Each slot's sequence number says whose turn
+// it is: a producer may fill slot i when it equals the position being written, and the
+// writer may take it once it's one past that
+struct LogMessage
+{
+	std::atomic<size_t> sequence;
+	LogLevel level;
+	std::string text;
+};
+
+static LogMessage sQueue[LOG_QUEUE_SIZE];
+static std::atomic<size_t> sQueueHead(0);
+static size_t sQueueTail = 0; // only touched by the writer
+
+static std::atomic<unsigned int> sDropped(0);
+static std::atomic<unsigned int> sLevelCount[LogDebug + 1];
+static std::atomic<long long> sLevelSecond[LogDebug + 1];
+
+static std::thread* sWriter = NULL;
+static std::mutex sWriterMutex;
+static std::condition_variable sWriterEvent;
+static std::condition_variable sWrittenEvent;
+static size_t sWritten = 0; // queue position written out up to, guarded by sWriterMutex
+static std::atomic<bool> sWriterExit(false);
+static std::atomic<bool> sFlushRequested(false);
+static size_t sFileSize = 0;
+
+static bool push(LogLevel level, std::string&& text)
+{
+	size_t pos = sQueueHead.load(std::memory_order_relaxed);
+	LogMessage* msg;
+	while(true)
+	{
+		msg = &sQueue[pos & (LOG_QUEUE_SIZE - 1)];
+		const size_t seq = msg->sequence.load(std::memory_order_acquire);
+		if(seq == pos)
+		{
+			if(sQueueHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}else if(seq < pos)
+		{
+			// full, the writer hasn't got this far round yet
+			return false;
+		}else{
+			pos = sQueueHead.load(std::memory_order_relaxed);
+		}
+	}
+
+	msg->level = level;
+	msg->text = std::move(text);
+	msg->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+static bool pop(LogLevel& level, std::string& text)
+{
+	LogMessage* msg = &sQueue[sQueueTail & (LOG_QUEUE_SIZE - 1)];
+	if(msg->sequence.load(std::memory_order_acquire) != sQueueTail + 1)
+		return false;
+
+	level = msg->level;
+	text.swap(msg->text);
+	msg->text.clear();
+	msg->sequence.store(sQueueTail + LOG_QUEUE_SIZE, std::memory_order_release);
+	sQueueTail++;
+	return true;
+}
+
+static bool withinRateLimit(LogLevel level)
+{
+	const unsigned int limit = sRateLimits[level];
+	if(limit == 0)
+		return true;
+
+	// racing resets can let a few extra through, which doesn't matter
+	const long long second = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	if(sLevelSecond[level].exchange(second) != second)
+		sLevelCount[level] = 0;
+	return ++sLevelCount[level] <= limit;
+}
+
+static void rotate(FILE*& file)
 {
-	return reportingLevel;
+	fclose(file);
+	const std::string path = Log::getLogPath();
+	const std::string backup = path + ".bak";
+	remove(backup.c_str());
+	rename(path.c_str(), backup.c_str());
+	file = fopen(path.c_str(), "w");
+	sFileSize = 0;
+}
+
+static void write(FILE*& file, LogLevel level, const std::string& text)
+{
+	if(file == NULL)
+		return;
+
+	if(sFileSize + text.size() > LOG_MAX_FILE_SIZE)
+	{
+		rotate(file);
+		if(file == NULL)
+			return;
+	}
+	fputs(text.c_str(), file);
+	sFileSize += text.size();
+
+	//if it's an error, also print to console
+	//print all messages if using --debug
+	if(level == LogError || Log::getReportingLevel() >= LogDebug)
+		fputs(text.c_str(), stderr);
+}
+
+static void writeQueued(FILE*& file)
+{
+	LogLevel level;
+	std::string text;
+	while(pop(level, text))
+		write(file, level, text);
+
+	const unsigned int dropped = sDropped.exchange(0);
+	if(dropped)
+		write(file, LogWarning, "lvl1: \t" + std::to_string(dropped) + " log messages dropped\n");
+
+	if(file)
+		fflush(file);
+}
+
+static void writerProc(FILE** file)
+{
+	while(!sWriterExit)
+	{
+		{
+			std::unique_lock<std::mutex> lock(sWriterMutex);
+			sWriterEvent.wait_for(lock, std::chrono::milliseconds(LOG_WRITE_INTERVAL), [] { return sWriterExit || sFlushRequested; });
+		}
+		sFlushRequested = false;
+		writeQueued(*file);
+
+		{
+			std::unique_lock<std::mutex> lock(sWriterMutex);
+			sWritten = sQueueTail;
+		}
+		sWrittenEvent.notify_all();
+	}
 }
 
 std::string Log::getLogPath()
@@ -26,6 +183,15 @@ void Log::setReportingLevel(LogLevel level)
 void Log::open()
 {
 	file = fopen(getLogPath().c_str(), "w");
+	sFileSize = 0;
+
+	for(size_t i = 0; i < LOG_QUEUE_SIZE; i++)
+		sQueue[i].sequence = i;
+	sQueueHead = 0;
+	sQueueTail = 0;
+	sWritten = 0;
+	sWriterExit = false;
+	sWriter = new std::thread(&writerProc, &file);
 }
 
 std::ostringstream& Log::get(LogLevel level)
@@ -38,12 +204,39 @@ std::ostringstream& Log::get(LogLevel level)
 
 void Log::flush()
 {
-	fflush(getOutput());
+	if(sWriter == NULL)
+		return;
+
+	// everything queued so far, a message still being queued by another thread may hold that up a moment
+	const size_t target = sQueueHead.load();
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(LOG_FLUSH_TIMEOUT);
+
+	std::unique_lock<std::mutex> lock(sWriterMutex);
+	while(sWritten < target && !sWriterExit)
+	{
+		sFlushRequested = true;
+		sWriterEvent.notify_one();
+		if(sWrittenEvent.wait_until(lock, deadline) == std::cv_status::timeout)
+			break;
+	}
 }
 
 void Log::close()
 {
-	fclose(file);
+	if(sWriter != NULL)
+	{
+		sWriterExit = true;
+		sWriterEvent.notify_one();
+		sWriter->join();
+		delete sWriter;
+		sWriter = NULL;
+
+		// anything logged while the writer was finishing up
+		writeQueued(file);
+	}
+
+	if(file)
+		fclose(file);
 	file = NULL;
 }
 
@@ -56,7 +249,7 @@ Log::~Log()
 {
 	os << std::endl;
 
-	if(getOutput() == NULL)
+	if(sWriter == NULL)
 	{
 		// not open yet, print to stdout
 		std::cerr << "ERROR - tried to write to log file before it was open! The following won't be logged:\n";
@@ -64,10 +257,13 @@ Log::~Log()
 		return;
 	}
 
-	fprintf(getOutput(), "%s", os.str().c_str());
+	if(!withinRateLimit(messageLevel) || !push(messageLevel, os.str()))
+	{
+		sDropped++;
+		return;
+	}
 
-	//if it's an error, also print to console
-	//print all messages if using --debug
-	if(messageLevel == LogError || reportingLevel >= LogDebug)
-		fprintf(stderr, "%s", os.str().c_str());
+	// errors are written straight away in case we're about to crash
+	if(messageLevel == LogError)
+		flush();
 }
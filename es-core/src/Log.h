@@ -11,6 +11,36 @@ else Log().get(level)
 
 enum LogLevel { LogError, LogWarning, LogInfo, LogDebug };
 
+// A key=value field for log lines that are meant to be grepped or parsed, e.g.
+//   LOG(LogInfo) << "Scraped game" << Log::field("system", name) << Log::field("ms", time);
+// Strings are quoted, everything else is written as-is.
+template<typename T>
+struct LogField
+{
+	const char* key;
+	const T& value;
+};
+
+template<typename T>
+inline std::ostream& operator<<(std::ostream& os, const LogField<T>& field)
+{
+	return os << ' ' << field.key << '=' << field.value;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const LogField<std::string>& field)
+{
+	return os << ' ' << field.key << "=\"" << field.value << '"';
+}
+
+inline std::ostream& operator<<(std::ostream& os, const LogField<const char*>& field)
+{
+	return os << ' ' << field.key << "=\"" << field.value << '"';
+}
+
+// Messages are queued and written out by a background thread, so logging never waits for
+// the disk. If the queue is full, or a level logs more than its share per second, messages
+// are dropped and a count of them is written instead. The log file is rotated to
+// es_log.txt.bak once it gets too big.
 class Log
 {
 public:
@@ -18,13 +48,19 @@ public:
 	~Log();
 	std::ostringstream& get(LogLevel level = LogInfo);
 
-	static LogLevel getReportingLevel();
+	static inline LogLevel getReportingLevel() { return reportingLevel; }
 	static void setReportingLevel(LogLevel level);
 
 	static std::string getLogPath();
 
+	template<typename T>
+	static LogField<T> field(const char* key, const T& value) { LogField<T> f = { key, value }; return f; }
+	static LogField<const char*> field(const char* key, const char* value) { LogField<const char*> f = { key, value }; return f; }
+
+	// Have the writer thread write out everything queued so far, and wait until it has
 	static void flush();
 	static void open();
+	// Writes out everything still queued, then closes the file
 	static void close();
 protected:
 	std::ostringstream os;
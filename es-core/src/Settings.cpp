@@ -18,9 +18,10 @@ std::vector<const char*> settings_dont_save = boost::assign::list_of
 	("VSync")
 	("HideConsole")
 	("IgnoreGamelist")
+	("HttpCacheOffline")
 	("SplashScreen");
 
-Settings::Settings()
+Settings::Settings() : mNextCallbackId(0), mNotifying(0)
 {
 	setDefaults();
 	loadFile();
@@ -61,6 +62,11 @@ void Settings::setDefaults()
 	mBoolMap["HideConsole"] = true;
 	mBoolMap["QuickSystemSelect"] = true;
 	mBoolMap["SaveGamelistsOnExit"] = true;
+	mBoolMap["PreloadGameLists"] = false;
+	mBoolMap["LaunchTextureSnapshot"] = false;
+	mBoolMap["ScraperThumbnails"] = false;
+	mBoolMap["HttpCache"] = true;
+	mBoolMap["HttpCacheOffline"] = false;
 
 	mBoolMap["Debug"] = false;
 	mBoolMap["DebugGrid"] = false;
@@ -69,7 +75,15 @@ void Settings::setDefaults()
 	mIntMap["ScreenSaverTime"] = 5*60*1000; // 5 minutes
 	mIntMap["ScraperResizeWidth"] = 400;
 	mIntMap["ScraperResizeHeight"] = 0;
+	mIntMap["ScraperThumbnailWidth"] = 160;
+	mIntMap["ScraperMaxSearches"] = 4;
+	mIntMap["ScraperMaxDownloads"] = 4;
+	mIntMap["ScraperRequestsPerSecond"] = 5;
+	mIntMap["HttpCacheHours"] = 7 * 24;
+	mIntMap["HttpCacheMaxSize"] = 256; // MB
 	mIntMap["MaxVRAM"] = 100;
+	mIntMap["PrefetchRAM"] = 32;
+	mIntMap["LaunchTextureRAM"] = 64;
 
 	mStringMap["TransitionStyle"] = "fade";
 	mStringMap["ThemeSet"] = "";
@@ -138,8 +152,46 @@ void Settings::loadFile()
 		setString(node.attribute("name").as_string(), node.attribute("value").as_string());
 }
 
+int Settings::addChangedCallback(const std::string& name, const std::function<void()>& callback)
+{
+	ChangedCallback entry = { mNextCallbackId++, name, callback, false };
+	mChangedCallbacks.push_back(entry);
+	return entry.id;
+}
+
+void Settings::removeChangedCallback(int id)
+{
+	for(auto it = mChangedCallbacks.begin(); it != mChangedCallbacks.end(); it++)
+	{
+		if(it->id == id)
+		{
+			// a callback may remove itself or others, which mustn't pull the list out from under notifyChanged
+			if(mNotifying > 0)
+				it->removed = true;
+			else
+				mChangedCallbacks.erase(it);
+			return;
+		}
+	}
+}
+
+void Settings::notifyChanged(const std::string& name)
+{
+	mNotifying++;
+	for(auto it = mChangedCallbacks.begin(); it != mChangedCallbacks.end(); it++)
+	{
+		if(it->name == name && !it->removed)
+			it->callback();
+	}
+	mNotifying--;
+
+	if(mNotifying == 0)
+		mChangedCallbacks.remove_if([](const ChangedCallback& entry) { return entry.removed; });
+}
+
 //Print a warning message if the setting we're trying to get doesn't already exist in the map, then return the value in the map.
-#define SETTINGS_GETSET(type, mapName, getMethodName, setMethodName) type Settings::getMethodName(const std::string& name) \
+//Handles point straight at the value in the map, std::map never moves them.
+#define SETTINGS_GETSET(type, valueType, mapName, getMethodName, setMethodName, handleMethodName) type Settings::getMethodName(const std::string& name) \
 { \
 	if(mapName.find(name) == mapName.end()) \
 	{ \
@@ -149,10 +201,22 @@ void Settings::loadFile()
 } \
 void Settings::setMethodName(const std::string& name, type value) \
 { \
+	auto it = mapName.find(name); \
+	if(it != mapName.end() && it->second == value) \
+		return; \
 	mapName[name] = value; \
+	notifyChanged(name); \
+} \
+SettingHandle<valueType> Settings::handleMethodName(const std::string& name) \
+{ \
+	if(mapName.find(name) == mapName.end()) \
+	{ \
+		LOG(LogError) << "Tried to use unset setting " << name << "!"; \
+	} \
+	return SettingHandle<valueType>(&mapName[name]); \
 }
 
-SETTINGS_GETSET(bool, mBoolMap, getBool, setBool);
-SETTINGS_GETSET(int, mIntMap, getInt, setInt);
-SETTINGS_GETSET(float, mFloatMap, getFloat, setFloat);
-SETTINGS_GETSET(const std::string&, mStringMap, getString, setString);
+SETTINGS_GETSET(bool, bool, mBoolMap, getBool, setBool, getBoolHandle);
+SETTINGS_GETSET(int, int, mIntMap, getInt, setInt, getIntHandle);
+SETTINGS_GETSET(float, float, mFloatMap, getFloat, setFloat, getFloatHandle);
+SETTINGS_GETSET(const std::string&, std::string, mStringMap, getString, setString, getStringHandle);
@@ -1,6 +1,23 @@
 #pragma once
 #include <string>
 #include <map>
+#include <list>
+#include <functional>
+
+// A setting looked up once, for code that reads it all the time. Reading it is just a pointer
+// dereference, and it always sees the current value since it points at the stored one.
+template<typename T>
+class SettingHandle
+{
+public:
+	SettingHandle() : mValue(NULL) {}
+	explicit SettingHandle(const T* value) : mValue(value) {}
+
+	inline const T& get() const { return *mValue; }
+
+private:
+	const T* mValue;
+};
 
 //This is a singleton for storing settings.
 class Settings
@@ -22,14 +39,37 @@ public:
 	void setFloat(const std::string& name, float value);
 	void setString(const std::string& name, const std::string& value);
 
+	//Handles stay valid for as long as the program runs.
+	SettingHandle<bool> getBoolHandle(const std::string& name);
+	SettingHandle<int> getIntHandle(const std::string& name);
+	SettingHandle<float> getFloatHandle(const std::string& name);
+	SettingHandle<std::string> getStringHandle(const std::string& name);
+
+	//Call callback whenever the named setting is set to a different value. Returns an id for removeChangedCallback.
+	int addChangedCallback(const std::string& name, const std::function<void()>& callback);
+	void removeChangedCallback(int id);
+
 private:
 	static Settings* sInstance;
 
 	Settings();
 
-	//Clear everything and load default values.
+	//Clear everything and load default values. Only safe before any handles are given out.
 	void setDefaults();
 
+	void notifyChanged(const std::string& name);
+
+	struct ChangedCallback
+	{
+		int id;
+		std::string name;
+		std::function<void()> callback;
+		bool removed; // removed while notifying, erased once that's done
+	};
+	std::list<ChangedCallback> mChangedCallbacks;
+	int mNextCallbackId;
+	int mNotifying; // notifyChanged calls in progress, callbacks may change settings too
+
 	std::map<std::string, bool> mBoolMap;
 	std::map<std::string, int> mIntMap;
 	std::map<std::string, float> mFloatMap;
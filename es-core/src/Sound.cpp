@@ -23,13 +23,13 @@ std::shared_ptr<Sound> Sound::getFromTheme(const std::shared_ptr<ThemeData>& the
 	LOG(LogInfo) << " req sound [" << view << "." << element << "]";
 
 	const ThemeData::ThemeElement* elem = theme->getElement(view, element, "sound");
-	if(!elem || !elem->has("path"))
+	if(!elem || !elem->has(ThemeProperty::PATH))
 	{
 		LOG(LogInfo) << "   (missing)";
 		return get("");
 	}
 
-	return get(elem->get<std::string>("path"));
+	return get(elem->get<std::string>(ThemeProperty::PATH));
 }
 
 Sound::Sound(const std::string & path) : mSampleData(NULL), mSamplePos(0), mSampleLength(0), playing(false)
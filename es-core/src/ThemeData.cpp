@@ -5,92 +5,45 @@
 #include "resources/TextureResource.h"
 #include "Log.h"
 #include "Settings.h"
+#include "Util.h"
 #include "pugixml/pugixml.hpp"
 #include <boost/assign.hpp>
+#include <chrono>
+#include <iomanip>
 
 #include "components/ImageComponent.h"
 #include "components/TextComponent.h"
 
 
-// This is a work around for some ambiguity that is introduced in C++11 that boost::assign::map_list_of leave open.
-// We use makeMap(actualmap) to implicitly convert the boost::assign::map_list_of's return type to ElementMapType.
-// Problem exists with gcc 4.7 and Boost 1.51.  Works fine with MSVC2010 without this hack.
-typedef std::map<std::string, ThemeData::ElementPropertyType> ElementMapType;
-template<typename T>
-ElementMapType makeMap(const T& mapInit)
-{
-	ElementMapType m = mapInit;
-	return m;
-}
-
-std::map< std::string, ElementMapType > ThemeData::sElementMap = boost::assign::map_list_of
-	("image", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("size", NORMALIZED_PAIR)
-		("maxSize", NORMALIZED_PAIR)
-		("origin", NORMALIZED_PAIR)
-		("path", PATH)
-		("tile", BOOLEAN)
-		("color", COLOR)))
-	("text", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("size", NORMALIZED_PAIR)
-		("text", STRING)
-		("color", COLOR)
-		("fontPath", PATH)
-		("fontSize", FLOAT)
-		("alignment", STRING)
-		("forceUppercase", BOOLEAN)
-		("lineSpacing", FLOAT)))
-	("textlist", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("size", NORMALIZED_PAIR)
-		("selectorColor", COLOR)
-		("selectedColor", COLOR)
-		("primaryColor", COLOR)
-		("secondaryColor", COLOR)
-		("fontPath", PATH)
-		("fontSize", FLOAT)
-		("scrollSound", PATH)
-		("alignment", STRING)
-		("horizontalMargin", FLOAT)
-		("forceUppercase", BOOLEAN)
-		("lineSpacing", FLOAT)))
-	("container", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("size", NORMALIZED_PAIR)))
-	("ninepatch", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("size", NORMALIZED_PAIR)
-		("path", PATH)))
-	("datetime", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("size", NORMALIZED_PAIR)
-		("color", COLOR)
-		("fontPath", PATH)
-		("fontSize", FLOAT)
-		("forceUppercase", BOOLEAN)))
-	("rating", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("size", NORMALIZED_PAIR)
-		("filledPath", PATH)
-		("unfilledPath", PATH)))
-	("sound", makeMap(boost::assign::map_list_of
-		("path", PATH)))
-	("helpsystem", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("textColor", COLOR)
-		("iconColor", COLOR)
-		("fontPath", PATH)
-		("fontSize", FLOAT)))
-	("video", makeMap(boost::assign::map_list_of
-		("pos", NORMALIZED_PAIR)
-		("size", NORMALIZED_PAIR)
-		("origin", NORMALIZED_PAIR)
-		("default", PATH)
-		("delay", FLOAT)
-		("showSnapshotNoVideo", BOOLEAN)
-		("showSnapshotDelay", BOOLEAN)));
+// bit per property in props
+static unsigned int accepts(std::initializer_list<ThemeProperty::Id> props)
+{
+	unsigned int mask = 0;
+	for(auto it = props.begin(); it != props.end(); it++)
+		mask |= 1u << *it;
+	return mask;
+}
+
+std::map<std::string, unsigned int> ThemeData::sElementMap = boost::assign::map_list_of
+	("image", accepts({ ThemeProperty::POS, ThemeProperty::SIZE, ThemeProperty::MAX_SIZE, ThemeProperty::ORIGIN,
+		ThemeProperty::PATH, ThemeProperty::TILE, ThemeProperty::COLOR }))
+	("text", accepts({ ThemeProperty::POS, ThemeProperty::SIZE, ThemeProperty::TEXT, ThemeProperty::COLOR,
+		ThemeProperty::FONT_PATH, ThemeProperty::FONT_SIZE, ThemeProperty::ALIGNMENT, ThemeProperty::FORCE_UPPERCASE,
+		ThemeProperty::LINE_SPACING }))
+	("textlist", accepts({ ThemeProperty::POS, ThemeProperty::SIZE, ThemeProperty::SELECTOR_COLOR, ThemeProperty::SELECTED_COLOR,
+		ThemeProperty::PRIMARY_COLOR, ThemeProperty::SECONDARY_COLOR, ThemeProperty::FONT_PATH, ThemeProperty::FONT_SIZE,
+		ThemeProperty::SCROLL_SOUND, ThemeProperty::ALIGNMENT, ThemeProperty::HORIZONTAL_MARGIN, ThemeProperty::FORCE_UPPERCASE,
+		ThemeProperty::LINE_SPACING }))
+	("container", accepts({ ThemeProperty::POS, ThemeProperty::SIZE }))
+	("ninepatch", accepts({ ThemeProperty::POS, ThemeProperty::SIZE, ThemeProperty::PATH }))
+	("datetime", accepts({ ThemeProperty::POS, ThemeProperty::SIZE, ThemeProperty::COLOR, ThemeProperty::FONT_PATH,
+		ThemeProperty::FONT_SIZE, ThemeProperty::FORCE_UPPERCASE }))
+	("rating", accepts({ ThemeProperty::POS, ThemeProperty::SIZE, ThemeProperty::FILLED_PATH, ThemeProperty::UNFILLED_PATH }))
+	("sound", accepts({ ThemeProperty::PATH }))
+	("helpsystem", accepts({ ThemeProperty::POS, ThemeProperty::TEXT_COLOR, ThemeProperty::ICON_COLOR, ThemeProperty::FONT_PATH,
+		ThemeProperty::FONT_SIZE }))
+	("video", accepts({ ThemeProperty::POS, ThemeProperty::SIZE, ThemeProperty::ORIGIN, ThemeProperty::DEFAULT,
+		ThemeProperty::DELAY, ThemeProperty::SHOW_SNAPSHOT_NO_VIDEO, ThemeProperty::SHOW_SNAPSHOT_DELAY }));
 
 namespace fs = boost::filesystem;
 
@@ -144,6 +97,152 @@ std::string resolvePath(const char* in, const fs::path& relative)
 
 
 
+std::map< std::string, std::shared_ptr<const ThemeData::ParsedFile> > ThemeData::sFileCache;
+std::map<std::string, unsigned int> ThemeData::sViewIds;
+std::unordered_map<std::string, unsigned int> ThemeData::sElementIds;
+
+namespace ThemeProperty
+{
+	// in Id order
+	static const char* sNames[COUNT] = {
+#define THEME_PROPERTY_NAME(id, name, type) name,
+		THEME_PROPERTIES(THEME_PROPERTY_NAME)
+#undef THEME_PROPERTY_NAME
+	};
+
+	const char* getName(Id id)
+	{
+		return sNames[id];
+	}
+
+	Id fromName(const std::string& name)
+	{
+		static const std::unordered_map<std::string, Id> ids = []
+		{
+			std::unordered_map<std::string, Id> map;
+			for(unsigned int i = 0; i < COUNT; i++)
+				map[sNames[i]] = (Id)i;
+			return map;
+		}();
+
+		auto it = ids.find(name);
+		return it != ids.end() ? it->second : COUNT;
+	}
+
+	// which of ThemeElement's arrays a property is kept in, by id and by type
+	static constexpr unsigned int storageOf(Id id)
+	{
+		return id < FIRST_STRING ? 0 : id < FIRST_COLOR ? 1 : id < FIRST_FLOAT ? 2 : id < FIRST_BOOL ? 3 : 4;
+	}
+
+	static constexpr unsigned int storageOf(ThemeData::ElementPropertyType type)
+	{
+		return type == ThemeData::NORMALIZED_PAIR ? 0 : (type == ThemeData::PATH || type == ThemeData::STRING) ? 1 :
+			type == ThemeData::COLOR ? 2 : type == ThemeData::FLOAT ? 3 : 4;
+	}
+
+	// the FIRST_ ids have to match the types in THEME_PROPERTIES
+#define THEME_PROPERTY_CHECK(id, name, type) \
+	static_assert(storageOf(id) == storageOf(ThemeData::type), "theme property " #id " is out of its type's range");
+	THEME_PROPERTIES(THEME_PROPERTY_CHECK)
+#undef THEME_PROPERTY_CHECK
+}
+
+ThemeData::ElementPropertyType ThemeData::getPropertyType(ThemeProperty::Id prop)
+{
+	static const ElementPropertyType types[ThemeProperty::COUNT] = {
+#define THEME_PROPERTY_TYPE(id, name, type) type,
+		THEME_PROPERTIES(THEME_PROPERTY_TYPE)
+#undef THEME_PROPERTY_TYPE
+	};
+
+	return types[prop];
+}
+
+void ThemeData::ThemeElement::checkType(ThemeProperty::Id prop, ThemeProperty::Id first, ThemeProperty::Id end)
+{
+	if(prop < first || prop >= end)
+	{
+		ThemeException error;
+		if(prop >= ThemeProperty::COUNT)
+			throw error << "Unknown theme property";
+		throw error << "Wrong value type for theme property \"" << ThemeProperty::getName(prop) << "\"";
+	}
+}
+
+void ThemeData::ThemeElement::set(ThemeProperty::Id prop, const Eigen::Vector2f& value)
+{
+	checkType(prop, ThemeProperty::FIRST_PAIR, ThemeProperty::FIRST_STRING);
+	mPairs[prop - ThemeProperty::FIRST_PAIR] = value;
+	mSet |= 1u << prop;
+}
+
+void ThemeData::ThemeElement::set(ThemeProperty::Id prop, const std::string& value)
+{
+	checkType(prop, ThemeProperty::FIRST_STRING, ThemeProperty::FIRST_COLOR);
+	mStrings[prop - ThemeProperty::FIRST_STRING] = value;
+	mSet |= 1u << prop;
+}
+
+void ThemeData::ThemeElement::set(ThemeProperty::Id prop, unsigned int value)
+{
+	checkType(prop, ThemeProperty::FIRST_COLOR, ThemeProperty::FIRST_FLOAT);
+	mColors[prop - ThemeProperty::FIRST_COLOR] = value;
+	mSet |= 1u << prop;
+}
+
+void ThemeData::ThemeElement::set(ThemeProperty::Id prop, float value)
+{
+	checkType(prop, ThemeProperty::FIRST_FLOAT, ThemeProperty::FIRST_BOOL);
+	mFloats[prop - ThemeProperty::FIRST_FLOAT] = value;
+	mSet |= 1u << prop;
+}
+
+void ThemeData::ThemeElement::set(ThemeProperty::Id prop, bool value)
+{
+	checkType(prop, ThemeProperty::FIRST_BOOL, ThemeProperty::COUNT);
+	mBools[prop - ThemeProperty::FIRST_BOOL] = value;
+	mSet |= 1u << prop;
+}
+
+void ThemeData::ThemeElement::merge(const ThemeElement& other)
+{
+	for(unsigned int i = 0; i < ThemeProperty::COUNT; i++)
+	{
+		const ThemeProperty::Id prop = (ThemeProperty::Id)i;
+		if(!other.has(prop))
+			continue;
+
+		if(prop < ThemeProperty::FIRST_STRING)
+			set(prop, other.get<Eigen::Vector2f>(prop));
+		else if(prop < ThemeProperty::FIRST_COLOR)
+			set(prop, other.get<std::string>(prop));
+		else if(prop < ThemeProperty::FIRST_FLOAT)
+			set(prop, other.get<unsigned int>(prop));
+		else if(prop < ThemeProperty::FIRST_BOOL)
+			set(prop, other.get<float>(prop));
+		else
+			set(prop, other.get<bool>(prop));
+	}
+}
+
+// 0 for embedded resources, that's as unchanging as it gets
+static std::time_t getModified(const std::string& path)
+{
+	boost::system::error_code ec;
+	std::time_t modified = fs::last_write_time(path, ec);
+	return ec ? 0 : modified;
+}
+
+// copy on write, elements can be shared with cached files
+static ThemeData::ThemeElement& makeWritable(std::shared_ptr<ThemeData::ThemeElement>& element)
+{
+	if(element.use_count() != 1)
+		element = std::make_shared<ThemeData::ThemeElement>(*element);
+
+	return *element;
+}
+
 ThemeData::ThemeData()
 {
 	mVersion = 0;
@@ -160,10 +259,46 @@ void ThemeData::loadFile(const std::string& path)
 		throw error << "File does not exist!";
 
 	mVersion = 0;
-	mViews.clear();
+	mFile.reset();
+
+	std::shared_ptr<const ParsedFile> file = getFile(path, error);
+
+	// only the theme itself needs a version, not what it includes
+	mVersion = file->version;
+	if(mVersion == -404)
+		throw error << "<formatVersion> tag missing!\n   It's either out of date or you need to add <formatVersion>" << CURRENT_THEME_FORMAT_VERSION << "</formatVersion> inside your <theme> tag.";
+
+	if(mVersion < MINIMUM_THEME_FORMAT_VERSION)
+		throw error << "Theme uses format version " << mVersion << ". Minimum supported version is " << MINIMUM_THEME_FORMAT_VERSION << ".";
+
+	mFile = file;
+}
+
+std::shared_ptr<const ThemeData::ParsedFile> ThemeData::getFile(const std::string& path, ThemeException error)
+{
+	// a cached file is current if neither it nor anything it includes has been modified since,
+	// a stat per file instead of reading and parsing them all again
+	auto cached = sFileCache.find(path);
+	if(cached != sFileCache.end())
+	{
+		const std::vector< std::pair<std::string, std::time_t> >& files = cached->second->files;
+		auto it = files.begin();
+		while(it != files.end() && getModified(it->first) == it->second)
+			it++;
+
+		if(it == files.end())
+			return cached->second;
+	}
+
+	if(!ResourceManager::getInstance()->fileExists(path))
+		return NULL;
+
+	std::shared_ptr<ParsedFile> file = std::make_shared<ParsedFile>();
+	file->files.push_back(std::make_pair(path, getModified(path)));
 
 	pugi::xml_document doc;
-	pugi::xml_parse_result res = doc.load_file(path.c_str());
+	const ResourceData data = ResourceManager::getInstance()->getFileData(path);
+	pugi::xml_parse_result res = doc.load_buffer(data.ptr.get(), data.length);
 	if(!res)
 		throw error << "XML parsing error: \n    " << res.description();
 
@@ -171,52 +306,90 @@ void ThemeData::loadFile(const std::string& path)
 	if(!root)
 		throw error << "Missing <theme> tag!";
 
-	// parse version
-	mVersion = root.child("formatVersion").text().as_float(-404);
-	if(mVersion == -404)
-		throw error << "<formatVersion> tag missing!\n   It's either out of date or you need to add <formatVersion>" << CURRENT_THEME_FORMAT_VERSION << "</formatVersion> inside your <theme> tag.";
+	file->version = root.child("formatVersion").text().as_float(-404);
 
-	if(mVersion < MINIMUM_THEME_FORMAT_VERSION)
-		throw error << "Theme uses format version " << mVersion << ". Minimum supported version is " << MINIMUM_THEME_FORMAT_VERSION << ".";
+	parseIncludes(root, *file);
+	parseViews(root, file->views);
+	compile(*file);
 
-	parseIncludes(root);
-	parseViews(root);
+	sFileCache[path] = file;
+	return file;
 }
 
-
-void ThemeData::parseIncludes(const pugi::xml_node& root)
+void ThemeData::parseIncludes(const pugi::xml_node& root, ParsedFile& file)
 {
 	ThemeException error;
 	error.setFiles(mPaths);
 
 	for(pugi::xml_node node = root.child("include"); node; node = node.next_sibling("include"))
 	{
+		// canonical, so "./../common.xml" from every system is the same cached file
 		const char* relPath = node.text().get();
-		std::string path = resolvePath(relPath, mPaths.back());
-		if(!ResourceManager::getInstance()->fileExists(path))
-			throw error << "Included file \"" << relPath << "\" not found! (resolved to \"" << path << "\")";
+		std::string path = getCanonicalPath(resolvePath(relPath, mPaths.back()));
 
-		error << "    from included file \"" << relPath << "\":\n    ";
+		ThemeException includeError = error;
+		includeError << "    from included file \"" << relPath << "\":\n    ";
 
 		mPaths.push_back(path);
+		std::shared_ptr<const ParsedFile> include = getFile(path, includeError);
+		mPaths.pop_back();
 
-		pugi::xml_document includeDoc;
-		pugi::xml_parse_result result = includeDoc.load_file(path.c_str());
-		if(!result)
-			throw error << "Error parsing file: \n    " << result.description();
+		if(!include)
+			throw error << "Included file \"" << relPath << "\" not found! (resolved to \"" << path << "\")";
 
-		pugi::xml_node root = includeDoc.child("theme");
-		if(!root)
-			throw error << "Missing <theme> tag!";
+		file.files.insert(file.files.end(), include->files.begin(), include->files.end());
+		mergeViews(include->views, file.views);
+	}
+}
 
-		parseIncludes(root);
-		parseViews(root);
+// Same result as parsing the included file's views on top of views, without parsing it again.
+void ThemeData::mergeViews(const std::map<std::string, ThemeView>& from, std::map<std::string, ThemeView>& into)
+{
+	for(auto viewIt = from.begin(); viewIt != from.end(); viewIt++)
+	{
+		ThemeView& view = into[viewIt->first];
+		for(auto keyIt = viewIt->second.orderedKeys.begin(); keyIt != viewIt->second.orderedKeys.end(); keyIt++)
+		{
+			const ThemeElement& element = *viewIt->second.elements.at(*keyIt);
+			std::shared_ptr<ThemeElement>& target = view.elements[*keyIt];
+			if(!target)
+			{
+				target = viewIt->second.elements.at(*keyIt);
+				view.orderedKeys.push_back(*keyIt);
+				continue;
+			}
 
-		mPaths.pop_back();
+			ThemeElement& merged = makeWritable(target);
+			merged.type = element.type;
+			merged.extra = element.extra;
+			merged.merge(element);
+		}
 	}
 }
 
-void ThemeData::parseViews(const pugi::xml_node& root)
+// Numbers every view and element and lays the elements out as [view][element] tables, the names
+// only have to be looked up once per getElement instead of once per map level and string compare.
+void ThemeData::compile(ParsedFile& file)
+{
+	for(auto viewIt = file.views.begin(); viewIt != file.views.end(); viewIt++)
+	{
+		const unsigned int viewId = sViewIds.insert(std::make_pair(viewIt->first, (unsigned int)sViewIds.size())).first->second;
+		if(viewId >= file.elementTable.size())
+			file.elementTable.resize(viewId + 1);
+
+		std::vector<const ThemeElement*>& elements = file.elementTable[viewId];
+		for(auto elemIt = viewIt->second.elements.begin(); elemIt != viewIt->second.elements.end(); elemIt++)
+		{
+			const unsigned int elementId = sElementIds.insert(std::make_pair(elemIt->first, (unsigned int)sElementIds.size())).first->second;
+			if(elementId >= elements.size())
+				elements.resize(elementId + 1, NULL);
+
+			elements[elementId] = elemIt->second.get();
+		}
+	}
+}
+
+void ThemeData::parseViews(const pugi::xml_node& root, std::map<std::string, ThemeView>& views)
 {
 	ThemeException error;
 	error.setFiles(mPaths);
@@ -238,7 +411,7 @@ void ThemeData::parseViews(const pugi::xml_node& root)
 			prevOff = nameAttr.find_first_not_of(delim, off);
 			off = nameAttr.find_first_of(delim, prevOff);
 			
-			ThemeView& view = mViews.insert(std::pair<std::string, ThemeView>(viewKey, ThemeView())).first->second;
+			ThemeView& view = views.insert(std::pair<std::string, ThemeView>(viewKey, ThemeView())).first->second;
 			parseView(node, view);
 		}
 	}
@@ -267,18 +440,21 @@ void ThemeData::parseView(const pugi::xml_node& root, ThemeView& view)
 			std::string elemKey = nameAttr.substr(prevOff, off - prevOff);
 			prevOff = nameAttr.find_first_not_of(delim, off);
 			off = nameAttr.find_first_of(delim, prevOff);
-			
-			parseElement(node, elemTypeIt->second, 
-				view.elements.insert(std::pair<std::string, ThemeElement>(elemKey, ThemeElement())).first->second);
 
-			if(std::find(view.orderedKeys.begin(), view.orderedKeys.end(), elemKey) == view.orderedKeys.end())
+			std::shared_ptr<ThemeElement>& element = view.elements[elemKey];
+			if(!element)
+			{
+				element = std::make_shared<ThemeElement>();
 				view.orderedKeys.push_back(elemKey);
+			}
+
+			parseElement(node, elemTypeIt->second, makeWritable(element));
 		}
 	}
 }
 
 
-void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::string, ElementPropertyType>& typeMap, ThemeElement& element)
+void ThemeData::parseElement(const pugi::xml_node& root, unsigned int properties, ThemeElement& element)
 {
 	ThemeException error;
 	error.setFiles(mPaths);
@@ -288,11 +464,11 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 	
 	for(pugi::xml_node node = root.first_child(); node; node = node.next_sibling())
 	{
-		auto typeIt = typeMap.find(node.name());
-		if(typeIt == typeMap.end())
+		const ThemeProperty::Id prop = ThemeProperty::fromName(node.name());
+		if(prop == ThemeProperty::COUNT || !(properties & (1u << prop)))
 			throw error << "Unknown property type \"" << node.name() << "\" (for element of type " << root.name() << ").";
 
-		switch(typeIt->second)
+		switch(getPropertyType(prop))
 		{
 		case NORMALIZED_PAIR:
 		{
@@ -307,11 +483,11 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 
 			Eigen::Vector2f val(atof(first.c_str()), atof(second.c_str()));
 
-			element.properties[node.name()] = val;
+			element.set(prop, val);
 			break;
 		}
 		case STRING:
-			element.properties[node.name()] = std::string(node.text().as_string());
+			element.set(prop, std::string(node.text().as_string()));
 			break;
 		case PATH:
 		{
@@ -325,17 +501,17 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 					ss << "(which resolved to \"" << path << "\") ";
 				LOG(LogWarning) << ss.str();
 			}
-			element.properties[node.name()] = path;
+			element.set(prop, path);
 			break;
 		}
 		case COLOR:
-			element.properties[node.name()] = getHexColor(node.text().as_string());
+			element.set(prop, getHexColor(node.text().as_string()));
 			break;
 		case FLOAT:
-			element.properties[node.name()] = node.text().as_float();
+			element.set(prop, node.text().as_float());
 			break;
 		case BOOLEAN:
-			element.properties[node.name()] = node.text().as_bool();
+			element.set(prop, node.text().as_bool());
 			break;
 		default:
 			throw error << "Unknown ElementPropertyType for \"" << root.attribute("name").as_string() << "\", property " << node.name();
@@ -346,21 +522,28 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 
 const ThemeData::ThemeElement* ThemeData::getElement(const std::string& view, const std::string& element, const std::string& expectedType) const
 {
-	auto viewIt = mViews.find(view);
-	if(viewIt == mViews.end())
+	if(!mFile)
+		return NULL; // nothing loaded
+
+	// names no theme ever used can't be in this one either
+	auto viewIt = sViewIds.find(view);
+	if(viewIt == sViewIds.end() || viewIt->second >= mFile->elementTable.size())
 		return NULL; // not found
 
-	auto elemIt = viewIt->second.elements.find(element);
-	if(elemIt == viewIt->second.elements.end()) return NULL;
+	auto elemIt = sElementIds.find(element);
+	const std::vector<const ThemeElement*>& elements = mFile->elementTable[viewIt->second];
+	if(elemIt == sElementIds.end() || elemIt->second >= elements.size() || !elements[elemIt->second])
+		return NULL;
 
-	if(elemIt->second.type != expectedType && !expectedType.empty())
+	const ThemeElement* elem = elements[elemIt->second];
+	if(elem->type != expectedType && !expectedType.empty())
 	{
 		LOG(LogWarning) << " requested mismatched theme type for [" << view << "." << element << "] - expected \"" 
-			<< expectedType << "\", got \"" << elemIt->second.type << "\"";
+			<< expectedType << "\", got \"" << elem->type << "\"";
 		return NULL;
 	}
 
-	return &elemIt->second;
+	return elem;
 }
 
 const std::shared_ptr<ThemeData>& ThemeData::getDefault()
@@ -391,13 +574,16 @@ std::vector<GuiComponent*> ThemeData::makeExtras(const std::shared_ptr<ThemeData
 {
 	std::vector<GuiComponent*> comps;
 
-	auto viewIt = theme->mViews.find(view);
-	if(viewIt == theme->mViews.end())
+	if(!theme->mFile)
+		return comps;
+
+	auto viewIt = theme->mFile->views.find(view);
+	if(viewIt == theme->mFile->views.end())
 		return comps;
 	
 	for(auto it = viewIt->second.orderedKeys.begin(); it != viewIt->second.orderedKeys.end(); it++)
 	{
-		ThemeElement& elem = viewIt->second.elements.at(*it);
+		const ThemeElement& elem = *viewIt->second.elements.at(*it);
 		if(elem.extra)
 		{
 			GuiComponent* comp = NULL;
@@ -482,3 +668,82 @@ fs::path ThemeData::getThemeFromCurrentSet(const std::string& system)
 
 	return set->second.getThemePath(system);
 }
+
+void ThemeData::clearCache()
+{
+	sFileCache.clear();
+}
+
+void ThemeData::benchmark()
+{
+	auto themeSets = getThemeSets();
+	if(themeSets.empty())
+	{
+		std::cout << "No theme sets found.\n";
+		return;
+	}
+
+	auto set = themeSets.find(Settings::getInstance()->getString("ThemeSet"));
+	if(set == themeSets.end())
+		set = themeSets.begin();
+
+	// every system the set has a theme for
+	std::vector<std::string> paths;
+	boost::system::error_code ec;
+	for(fs::directory_iterator it(set->second.path, ec), end; !ec && it != end; it.increment(ec))
+	{
+		const fs::path path = it->path() / "theme.xml";
+		if(fs::is_regular_file(path))
+			paths.push_back(path.generic_string());
+	}
+
+	typedef std::chrono::high_resolution_clock Clock;
+	static const int ROUNDS = 5;
+
+	// best of a few rounds, the first one also pays for the disk cache
+	auto time = [&paths](bool clearEach, bool clearFirst) -> float
+	{
+		float best = 0;
+		for(int round = 0; round < ROUNDS; round++)
+		{
+			if(clearFirst)
+				sFileCache.clear();
+
+			auto start = Clock::now();
+			for(auto it = paths.begin(); it != paths.end(); it++)
+			{
+				if(clearEach)
+					sFileCache.clear();
+
+				ThemeData theme;
+				try
+				{
+					theme.loadFile(*it);
+				} catch(ThemeException& e)
+				{
+					LOG(LogError) << e.what();
+				}
+			}
+
+			const float ms = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0f;
+			if(round == 0 || ms < best)
+				best = ms;
+		}
+		return best;
+	};
+
+	// clearing the cache before every system is what loading cost before, every include parsed again each time
+	const float unshared = time(true, true);
+	const float cold = time(false, true);
+	const float warm = time(false, false);
+
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	ss << "Loading " << paths.size() << " system themes from \"" << set->first << "\" (best of " << ROUNDS << "):\n";
+	ss << "  every file parsed per system    " << std::setw(8) << unshared << "ms\n";
+	ss << "  shared file cache, first load   " << std::setw(8) << cold << "ms\n";
+	ss << "  shared file cache, reload       " << std::setw(8) << warm << "ms\n";
+
+	std::cout << ss.str();
+	LOG(LogInfo) << ss.str();
+}
@@ -4,10 +4,11 @@
 #include <sstream>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <deque>
 #include <string>
+#include <ctime>
 #include <boost/filesystem.hpp>
-#include <boost/variant.hpp>
 #include <Eigen/Dense>
 #include "pugixml/pugixml.hpp"
 #include "GuiComponent.h"
@@ -43,6 +44,65 @@ namespace ThemeFlags
 	};
 }
 
+// Every property an element can have: its id, the name used in theme files and its value type.
+// Grouped by storage type, in the order of the FIRST_ ids below, which ThemeData.cpp checks.
+#define THEME_PROPERTIES(X) \
+	X(POS, "pos", NORMALIZED_PAIR) \
+	X(SIZE, "size", NORMALIZED_PAIR) \
+	X(MAX_SIZE, "maxSize", NORMALIZED_PAIR) \
+	X(ORIGIN, "origin", NORMALIZED_PAIR) \
+	X(PATH, "path", PATH) \
+	X(TEXT, "text", STRING) \
+	X(FONT_PATH, "fontPath", PATH) \
+	X(ALIGNMENT, "alignment", STRING) \
+	X(SCROLL_SOUND, "scrollSound", PATH) \
+	X(FILLED_PATH, "filledPath", PATH) \
+	X(UNFILLED_PATH, "unfilledPath", PATH) \
+	X(DEFAULT, "default", PATH) \
+	X(COLOR, "color", COLOR) \
+	X(SELECTOR_COLOR, "selectorColor", COLOR) \
+	X(SELECTED_COLOR, "selectedColor", COLOR) \
+	X(PRIMARY_COLOR, "primaryColor", COLOR) \
+	X(SECONDARY_COLOR, "secondaryColor", COLOR) \
+	X(TEXT_COLOR, "textColor", COLOR) \
+	X(ICON_COLOR, "iconColor", COLOR) \
+	X(FONT_SIZE, "fontSize", FLOAT) \
+	X(LINE_SPACING, "lineSpacing", FLOAT) \
+	X(HORIZONTAL_MARGIN, "horizontalMargin", FLOAT) \
+	X(DELAY, "delay", FLOAT) \
+	X(TILE, "tile", BOOLEAN) \
+	X(FORCE_UPPERCASE, "forceUppercase", BOOLEAN) \
+	X(SHOW_SNAPSHOT_NO_VIDEO, "showSnapshotNoVideo", BOOLEAN) \
+	X(SHOW_SNAPSHOT_DELAY, "showSnapshotDelay", BOOLEAN)
+
+// Parsed elements keep each storage type in an array indexed by (id - first id of that type),
+// so a lookup is a bit test and an index.
+namespace ThemeProperty
+{
+	enum Id : unsigned int
+	{
+#define THEME_PROPERTY_ID(id, name, type) id,
+		THEME_PROPERTIES(THEME_PROPERTY_ID)
+#undef THEME_PROPERTY_ID
+
+		COUNT,
+
+		FIRST_PAIR = POS,
+		FIRST_STRING = PATH,
+		FIRST_COLOR = COLOR,
+		FIRST_FLOAT = FONT_SIZE,
+		FIRST_BOOL = TILE
+	};
+
+	// ThemeElement has a bit per property
+	static_assert(COUNT <= 32, "too many theme properties for ThemeElement's bit mask");
+
+	// the name used in theme files ("maxSize")
+	const char* getName(Id id);
+	// COUNT if name isn't a property
+	Id fromName(const std::string& name);
+}
+
 class ThemeException : public std::exception
 {
 public:
@@ -99,25 +159,80 @@ public:
 	class ThemeElement
 	{
 	public:
+		ThemeElement() : extra(false), mSet(0) {}
+
 		bool extra;
 		std::string type;
 
-		std::map< std::string, boost::variant<Eigen::Vector2f, std::string, unsigned int, float, bool> > properties;
+		inline bool has(ThemeProperty::Id prop) const { return (mSet & (1u << prop)) != 0; }
 
+		// T has to match the type of prop, Eigen::Vector2f, std::string, unsigned int (colors), float or bool,
+		// throws ThemeException if it doesn't
 		template<typename T>
-		T get(const std::string& prop) const { return boost::get<T>(properties.at(prop)); }
+		const T& get(ThemeProperty::Id prop) const;
+
+		// by name, for when the property isn't known at compile time
+		inline bool has(const std::string& prop) const { ThemeProperty::Id id = ThemeProperty::fromName(prop); return id != ThemeProperty::COUNT && has(id); }
 
-		inline bool has(const std::string& prop) const { return (properties.find(prop) != properties.end()); }
+		// throws ThemeException if prop isn't a property or T doesn't match its type
+		template<typename T>
+		const T& get(const std::string& prop) const
+		{
+			const ThemeProperty::Id id = ThemeProperty::fromName(prop);
+			if(id == ThemeProperty::COUNT)
+			{
+				ThemeException error;
+				throw error << "Unknown theme property \"" << prop << "\"";
+			}
+			return get<T>(id);
+		}
+
+		// throw ThemeException if value doesn't match the type of prop
+		void set(ThemeProperty::Id prop, const Eigen::Vector2f& value);
+		void set(ThemeProperty::Id prop, const std::string& value);
+		void set(ThemeProperty::Id prop, unsigned int value);
+		void set(ThemeProperty::Id prop, float value);
+		void set(ThemeProperty::Id prop, bool value);
+
+		// copies every property other has set over this one's
+		void merge(const ThemeElement& other);
+
+	private:
+		// throws ThemeException unless first <= prop < end
+		static void checkType(ThemeProperty::Id prop, ThemeProperty::Id first, ThemeProperty::Id end);
+
+		unsigned int mSet; // bit per ThemeProperty::Id
+
+		Eigen::Vector2f mPairs[ThemeProperty::FIRST_STRING - ThemeProperty::FIRST_PAIR];
+		std::string mStrings[ThemeProperty::FIRST_COLOR - ThemeProperty::FIRST_STRING];
+		unsigned int mColors[ThemeProperty::FIRST_FLOAT - ThemeProperty::FIRST_COLOR];
+		float mFloats[ThemeProperty::FIRST_BOOL - ThemeProperty::FIRST_FLOAT];
+		bool mBools[ThemeProperty::COUNT - ThemeProperty::FIRST_BOOL];
+
+		friend class ThemeData;
 	};
 
 private:
 	class ThemeView
 	{
 	public:
-		std::map<std::string, ThemeElement> elements;
+		// shared with the files they were merged from, copied before they're changed
+		std::map< std::string, std::shared_ptr<ThemeElement> > elements;
 		std::vector<std::string> orderedKeys;
 	};
 
+	// A theme file with everything it includes merged in. Each file is only parsed once and shared
+	// by every system that uses it, until it or one of its includes is modified.
+	struct ParsedFile
+	{
+		float version;
+		std::map<std::string, ThemeView> views;
+		std::vector< std::pair<std::string, std::time_t> > files; // itself and its includes, with modification times
+
+		// views compiled for getElement, [view id][element id] with ids from sViewIds and sElementIds
+		std::vector< std::vector<const ThemeElement*> > elementTable;
+	};
+
 public:
 
 	ThemeData();
@@ -135,6 +250,9 @@ public:
 		BOOLEAN
 	};
 
+	// from THEME_PROPERTIES
+	static ElementPropertyType getPropertyType(ThemeProperty::Id prop);
+
 	// If expectedType is an empty string, will do no type checking.
 	const ThemeElement* getElement(const std::string& view, const std::string& element, const std::string& expectedType) const;
 
@@ -145,16 +263,68 @@ public:
 	static std::map<std::string, ThemeSet> getThemeSets();
 	static boost::filesystem::path getThemeFromCurrentSet(const std::string& system);
 
+	// Forget every parsed file, for when the theme set changes and the old set's files won't be loaded again.
+	static void clearCache();
+
+	// times loading every system theme of the current set with and without the shared file cache and prints the results
+	static void benchmark();
+
 private:
-	static std::map< std::string, std::map<std::string, ElementPropertyType> > sElementMap;
+	static std::map<std::string, unsigned int> sElementMap; // the properties each element type accepts, bit per ThemeProperty::Id
+	static std::map< std::string, std::shared_ptr<const ParsedFile> > sFileCache; // by path
 
 	std::deque<boost::filesystem::path> mPaths;
 	float mVersion;
 
-	void parseIncludes(const pugi::xml_node& themeRoot);
-	void parseViews(const pugi::xml_node& themeRoot);
+	// the cached file if it's still current, otherwise parses it. NULL if path doesn't exist.
+	// error is what any exception thrown for the file itself starts with.
+	std::shared_ptr<const ParsedFile> getFile(const std::string& path, ThemeException error);
+	void parseIncludes(const pugi::xml_node& themeRoot, ParsedFile& file);
+	void parseViews(const pugi::xml_node& themeRoot, std::map<std::string, ThemeView>& views);
 	void parseView(const pugi::xml_node& viewNode, ThemeView& view);
-	void parseElement(const pugi::xml_node& elementNode, const std::map<std::string, ElementPropertyType>& typeMap, ThemeElement& element);
+	void parseElement(const pugi::xml_node& elementNode, unsigned int properties, ThemeElement& element);
+
+	static void mergeViews(const std::map<std::string, ThemeView>& from, std::map<std::string, ThemeView>& into);
+	static void compile(ParsedFile& file);
+
+	// every view and element name seen in any theme, numbered in the order they were first parsed
+	static std::map<std::string, unsigned int> sViewIds;
+	static std::unordered_map<std::string, unsigned int> sElementIds;
 
-	std::map<std::string, ThemeView> mViews;
+	std::shared_ptr<const ParsedFile> mFile;
 };
+
+template<>
+inline const Eigen::Vector2f& ThemeData::ThemeElement::get<Eigen::Vector2f>(ThemeProperty::Id prop) const
+{
+	checkType(prop, ThemeProperty::FIRST_PAIR, ThemeProperty::FIRST_STRING);
+	return mPairs[prop - ThemeProperty::FIRST_PAIR];
+}
+
+template<>
+inline const std::string& ThemeData::ThemeElement::get<std::string>(ThemeProperty::Id prop) const
+{
+	checkType(prop, ThemeProperty::FIRST_STRING, ThemeProperty::FIRST_COLOR);
+	return mStrings[prop - ThemeProperty::FIRST_STRING];
+}
+
+template<>
+inline const unsigned int& ThemeData::ThemeElement::get<unsigned int>(ThemeProperty::Id prop) const
+{
+	checkType(prop, ThemeProperty::FIRST_COLOR, ThemeProperty::FIRST_FLOAT);
+	return mColors[prop - ThemeProperty::FIRST_COLOR];
+}
+
+template<>
+inline const float& ThemeData::ThemeElement::get<float>(ThemeProperty::Id prop) const
+{
+	checkType(prop, ThemeProperty::FIRST_FLOAT, ThemeProperty::FIRST_BOOL);
+	return mFloats[prop - ThemeProperty::FIRST_FLOAT];
+}
+
+template<>
+inline const bool& ThemeData::ThemeElement::get<bool>(ThemeProperty::Id prop) const
+{
+	checkType(prop, ThemeProperty::FIRST_BOOL, ThemeProperty::COUNT);
+	return mBools[prop - ThemeProperty::FIRST_BOOL];
+}
@@ -0,0 +1,96 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+ThreadPool* ThreadPool::getInstance()
+{
+	// the loader and UI threads both get here, a function static is only ever created once.
+	// hardware_concurrency() may not know and return 0
+	static ThreadPool* instance = new ThreadPool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+	return instance;
+}
+
+ThreadPool::ThreadPool(size_t threadCount) : mExit(false)
+{
+	for(size_t i = 0; i < threadCount; i++)
+		mThreads.push_back(new std::thread(&ThreadPool::threadProc, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mQueue.clear();
+		mExit = true;
+	}
+	mEvent.notify_all();
+
+	for(auto it = mThreads.begin(); it != mThreads.end(); it++)
+	{
+		(*it)->join();
+		delete *it;
+	}
+}
+
+void ThreadPool::queueWorkItem(std::function<void()> work)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mQueue.push_back(work);
+	}
+	mEvent.notify_one();
+}
+
+void ThreadPool::run(const std::vector<std::function<void()> >& jobs)
+{
+	if(jobs.empty())
+		return;
+
+	std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+	batch->jobs = &jobs;
+	batch->count = jobs.size();
+	batch->next = 0;
+	batch->remaining = jobs.size();
+
+	// one helper per worker that can be of use, each runs jobs until the batch is used up
+	const size_t helpers = std::min(jobs.size() - 1, mThreads.size());
+	for(size_t i = 0; i < helpers; i++)
+		queueWorkItem([batch] { runBatch(*batch); });
+
+	// do a share of the work here rather than just waiting for it
+	runBatch(*batch);
+
+	std::unique_lock<std::mutex> lock(batch->mutex);
+	batch->done.wait(lock, [&batch] { return batch->remaining == 0; });
+}
+
+void ThreadPool::runBatch(Batch& batch)
+{
+	// jobs is only looked at after claiming one, run() doesn't return before that job is done
+	size_t i;
+	while((i = batch.next++) < batch.count)
+	{
+		(*batch.jobs)[i]();
+
+		std::unique_lock<std::mutex> lock(batch.mutex);
+		if(--batch.remaining == 0)
+			batch.done.notify_all();
+	}
+}
+
+void ThreadPool::threadProc()
+{
+	while(true)
+	{
+		std::function<void()> work;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mEvent.wait(lock, [this] { return mExit || !mQueue.empty(); });
+			if(mExit)
+				return;
+			work = mQueue.front();
+			mQueue.pop_front();
+		}
+		work();
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// A fixed set of worker threads for splitting CPU heavy work (rasterizing, hashing, sorting)
+// into independent pieces. Jobs must not wait on other jobs queued to the same pool.
+class ThreadPool
+{
+public:
+	// Shared pool with one worker per core, less the calling thread that helps out in run().
+	// There's always at least one so queued jobs get run on a single core too
+	static ThreadPool* getInstance();
+
+	ThreadPool(size_t threadCount);
+	~ThreadPool();
+
+	// Queue a job to be run on one of the workers at some point
+	void queueWorkItem(std::function<void()> work);
+
+	// Run all jobs, spread over the workers and the calling thread. Returns once every job has finished.
+	// The calling thread only helps with these jobs, never with anything else queued to the pool
+	void run(const std::vector<std::function<void()> >& jobs);
+
+	inline size_t getThreadCount() const { return mThreads.size(); }
+
+private:
+	// The jobs of one run() call. Shared with the work items queued for it, which may only get
+	// to run after run() has returned, by then finding nothing left to claim. jobs is gone by
+	// then, so it's only looked at after claiming one of the count
+	struct Batch
+	{
+		const std::vector<std::function<void()> >* jobs;
+		size_t count;
+		std::atomic<size_t> next;
+		size_t remaining;
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+
+	void threadProc();
+	// Claim and run jobs of batch until there are none left
+	static void runBatch(Batch& batch);
+
+	std::vector<std::thread*>				mThreads;
+	std::list<std::function<void()> >		mQueue;
+	std::mutex								mMutex;
+	std::condition_variable					mEvent;
+	bool									mExit;
+};
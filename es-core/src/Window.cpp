@@ -8,9 +8,12 @@
 #include <iomanip>
 #include "components/HelpComponent.h"
 #include "components/ImageComponent.h"
+#include "resources/TextureResource.h"
+#include "HttpReq.h"
+#include "animations/AnimationManager.h"
 
 Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mAverageDeltaTime(10), 
-	mAllowSleep(true), mSleeping(false), mTimeSinceLastInput(0)
+	mAllowSleep(true), mSleeping(false), mTimeSinceLastInput(0), mDrawFramerate(Settings::getInstance()->getBoolHandle("DrawFramerate"))
 {
 	mHelp = new HelpComponent(this);
 	mBackgroundOverlay = new ImageComponent(this);
@@ -70,6 +73,8 @@ bool Window::init(unsigned int width, unsigned int height)
 	InputManager::getInstance()->init();
 
 	ResourceManager::getInstance()->reloadAll();
+	// back from a game, put the images that were kept back in VRAM before the first frame
+	TextureResource::restoreKept();
 
 	//keep a reference to the default fonts, so they don't keep getting destroyed/recreated
 	if(mDefaultFonts.empty())
@@ -151,7 +156,7 @@ void Window::update(int deltaTime)
 	{
 		mAverageDeltaTime = mFrameTimeElapsed / mFrameCountElapsed;
 		
-		if(Settings::getInstance()->getBool("DrawFramerate"))
+		if(mDrawFramerate.get())
 		{
 			std::stringstream ss;
 			
@@ -175,8 +180,16 @@ void Window::update(int deltaTime)
 
 	mTimeSinceLastInput += deltaTime;
 
+	// finished downloads are handed back here, so their callbacks can touch the UI
+	HttpReq::dispatchCompletions();
+
+	TextureResource::collectPrefetched();
+
 	if(peekGui())
 		peekGui()->update(deltaTime);
+
+	// the animations of whatever was just updated
+	AnimationManager::getInstance()->update(deltaTime);
 }
 
 void Window::render()
@@ -202,7 +215,7 @@ void Window::render()
 	if(!mRenderedHelpPrompts)
 		mHelp->render(transform);
 
-	if(Settings::getInstance()->getBool("DrawFramerate") && mFrameDataText)
+	if(mDrawFramerate.get() && mFrameDataText)
 	{
 		Renderer::setMatrix(Eigen::Affine3f::Identity());
 		mDefaultFonts.at(1)->renderTextCache(mFrameDataText.get());
@@ -4,6 +4,7 @@
 #include <vector>
 #include "resources/Font.h"
 #include "InputManager.h"
+#include "Settings.h"
 
 class HelpComponent;
 class ImageComponent;
@@ -64,5 +65,7 @@ private:
 	bool mSleeping;
 	unsigned int mTimeSinceLastInput;
 
+	SettingHandle<bool> mDrawFramerate;
+
 	bool mRenderedHelpPrompts;
 };
@@ -0,0 +1,204 @@
+#include "animations/AnimationManager.h"
+#include "GuiComponent.h"
+#include <algorithm>
+#include <assert.h>
+
+// enough for everything the UI plays at once, so nothing grows during normal use
+#define ANIMATION_POOL_RESERVE 64
+
+AnimationManager* AnimationManager::sInstance = NULL;
+
+AnimationManager* AnimationManager::getInstance()
+{
+	if(!sInstance)
+		sInstance = new AnimationManager();
+
+	return sInstance;
+}
+
+AnimationManager::AnimationManager() : mFrame(0)
+{
+	mControllers.items.reserve(ANIMATION_POOL_RESERVE);
+	mControllers.free.reserve(ANIMATION_POOL_RESERVE);
+	mAnimations.items.reserve(ANIMATION_POOL_RESERVE);
+	mAnimations.free.reserve(ANIMATION_POOL_RESERVE);
+	mOpacityTweens.items.reserve(ANIMATION_POOL_RESERVE);
+	mOpacityTweens.free.reserve(ANIMATION_POOL_RESERVE);
+	mPositionTweens.items.reserve(ANIMATION_POOL_RESERVE);
+	mPositionTweens.free.reserve(ANIMATION_POOL_RESERVE);
+	mCameraTweens.items.reserve(ANIMATION_POOL_RESERVE);
+	mCameraTweens.free.reserve(ANIMATION_POOL_RESERVE);
+}
+
+template<typename T>
+unsigned int AnimationManager::Pool<T>::add(const T& item)
+{
+	if(free.empty())
+	{
+		items.push_back(item);
+		return (unsigned int)items.size() - 1;
+	}
+
+	const unsigned int index = free.back();
+	free.pop_back();
+	items[index] = item;
+	return index;
+}
+
+int AnimationManager::start(GuiComponent* owner, unsigned char slot, Animation* anim, int delay, const std::function<void()>& finishedCallback, bool reverse)
+{
+	return add(owner, slot, TWEEN_ANIMATION, mAnimations.add(anim), anim->getDuration(), delay, finishedCallback, reverse);
+}
+
+int AnimationManager::start(GuiComponent* owner, unsigned char slot, const OpacityTween& tween, int delay, const std::function<void()>& finishedCallback, bool reverse)
+{
+	return add(owner, slot, TWEEN_OPACITY, mOpacityTweens.add(tween), tween.duration, delay, finishedCallback, reverse);
+}
+
+int AnimationManager::start(GuiComponent* owner, unsigned char slot, const PositionTween& tween, int delay, const std::function<void()>& finishedCallback, bool reverse)
+{
+	return add(owner, slot, TWEEN_POSITION, mPositionTweens.add(tween), tween.duration, delay, finishedCallback, reverse);
+}
+
+int AnimationManager::start(GuiComponent* owner, unsigned char slot, const CameraTween& tween, int delay, const std::function<void()>& finishedCallback, bool reverse)
+{
+	return add(owner, slot, TWEEN_CAMERA, mCameraTweens.add(tween), tween.duration, delay, finishedCallback, reverse);
+}
+
+int AnimationManager::add(GuiComponent* owner, unsigned char slot, TweenType type, unsigned int tween, int duration, int delay, const std::function<void()>& finishedCallback, bool reverse)
+{
+	Controller controller;
+	controller.owner = owner;
+	controller.slot = slot;
+	controller.type = type;
+	controller.active = true;
+	controller.reverse = reverse;
+	controller.time = -delay;
+	controller.duration = duration;
+	controller.tween = tween;
+	controller.frame = mFrame;
+	controller.finishedCallback = finishedCallback;
+
+	return (int)mControllers.add(controller);
+}
+
+void AnimationManager::apply(const Controller& controller, float t)
+{
+	switch(controller.type)
+	{
+	case TWEEN_ANIMATION:
+		mAnimations.items[controller.tween]->apply(t);
+		break;
+	case TWEEN_OPACITY:
+		{
+			const OpacityTween& tween = mOpacityTweens.items[controller.tween];
+			tween.target->setOpacity((unsigned char)(lerp<float>(tween.from, tween.to, t) * 255));
+		}
+		break;
+	case TWEEN_POSITION:
+		{
+			const PositionTween& tween = mPositionTweens.items[controller.tween];
+			tween.target->setPosition(lerp<Eigen::Vector3f>(tween.from, tween.to, t));
+		}
+		break;
+	case TWEEN_CAMERA:
+		{
+			// cubic ease out
+			const CameraTween& tween = mCameraTweens.items[controller.tween];
+			t -= 1;
+			tween.camera->translation() = -lerp<Eigen::Vector3f>(tween.from, tween.to, t*t*t + 1);
+		}
+		break;
+	}
+}
+
+bool AnimationManager::advance(int handle, int deltaTime)
+{
+	Controller& controller = mControllers.items.at(handle);
+	assert(controller.active);
+
+	controller.time += deltaTime;
+
+	if(controller.time < 0) // are we still in delay?
+		return false;
+
+	float t = controller.duration > 0 ? (float)controller.time / controller.duration : 1.0f;
+
+	if(t > 1.0f)
+		t = 1.0f;
+	else if(t < 0.0f)
+		t = 0.0f;
+
+	apply(controller, controller.reverse ? 1.0f - t : t);
+
+	if(t == 1.0f)
+	{
+		release(handle, true);
+		return true;
+	}
+
+	return false;
+}
+
+void AnimationManager::finish(int handle)
+{
+	const Controller& controller = mControllers.items.at(handle);
+	const bool done = advance(handle, std::max(controller.duration - controller.time, 0));
+	assert(done);
+}
+
+void AnimationManager::stop(int handle, bool callFinished)
+{
+	release(handle, callFinished);
+}
+
+void AnimationManager::release(int handle, bool callFinished)
+{
+	Controller& controller = mControllers.items.at(handle);
+	assert(controller.active);
+
+	// the slot may already hold the animation that replaced this one
+	if(controller.owner->mAnimations[controller.slot] == handle)
+		controller.owner->mAnimations[controller.slot] = -1;
+
+	switch(controller.type)
+	{
+	case TWEEN_ANIMATION:
+		delete mAnimations.items[controller.tween];
+		mAnimations.remove(controller.tween);
+		break;
+	case TWEEN_OPACITY:
+		mOpacityTweens.remove(controller.tween);
+		break;
+	case TWEEN_POSITION:
+		mPositionTweens.remove(controller.tween);
+		break;
+	case TWEEN_CAMERA:
+		mCameraTweens.remove(controller.tween);
+		break;
+	}
+
+	std::function<void()> finishedCallback;
+	finishedCallback.swap(controller.finishedCallback);
+	controller.active = false;
+	mControllers.remove(handle);
+
+	// last, the callback is free to start animations that reuse this entry
+	if(callFinished && finishedCallback)
+		finishedCallback();
+}
+
+void AnimationManager::update(int deltaTime)
+{
+	// components updated this frame were marked with it, moving on now means
+	// anything started by a callback during this pass waits for the next frame
+	const unsigned int frame = mFrame++;
+
+	const unsigned int count = (unsigned int)mControllers.items.size();
+	for(unsigned int i = 0; i < count; i++)
+	{
+		const Controller& controller = mControllers.items[i];
+		if(controller.active && controller.frame != mFrame && controller.owner->mUpdateFrame == frame)
+			advance(i, deltaTime);
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "animations/Animation.h"
+
+class GuiComponent;
+
+// Tweens for the common cases, applied without a virtual call or a std::function and kept
+// in arrays of their own type instead of being allocated one by one like an Animation.
+
+// fades target's opacity, from and to are 0..1
+struct OpacityTween
+{
+	GuiComponent* target;
+	float from;
+	float to;
+	int duration;
+};
+
+// moves target in a straight line
+struct PositionTween
+{
+	GuiComponent* target;
+	Eigen::Vector3f from;
+	Eigen::Vector3f to;
+	int duration;
+};
+
+// moves camera from looking at "from" to looking at "to", cubic ease out
+struct CameraTween
+{
+	Eigen::Affine3f* camera;
+	Eigen::Vector3f from;
+	Eigen::Vector3f to;
+	int duration;
+};
+
+// Owns every playing animation. Controllers live in one array and are reused once finished, and everything
+// is advanced in a single pass per frame by Window::update rather than by each component's update.
+// Only the animations of components that were updated that frame (GuiComponent::updateSelf) are advanced,
+// so anything not being updated, like the views under a menu, has its animations paused until it is again.
+// GuiComponent::setAnimation and friends are the interface, components hold a handle per slot.
+class AnimationManager
+{
+public:
+	static AnimationManager* getInstance();
+
+	// A handle is an index into the controller array, valid until the animation finishes or is stopped.
+	// Takes ownership of anim (deleted when the animation is released).
+	int start(GuiComponent* owner, unsigned char slot, Animation* anim, int delay, const std::function<void()>& finishedCallback, bool reverse);
+	int start(GuiComponent* owner, unsigned char slot, const OpacityTween& tween, int delay, const std::function<void()>& finishedCallback, bool reverse);
+	int start(GuiComponent* owner, unsigned char slot, const PositionTween& tween, int delay, const std::function<void()>& finishedCallback, bool reverse);
+	int start(GuiComponent* owner, unsigned char slot, const CameraTween& tween, int delay, const std::function<void()>& finishedCallback, bool reverse);
+
+	// Returns true if the animation finished (it's released and its finished callback has been called).
+	bool advance(int handle, int deltaTime);
+	// Skips to the end.
+	void finish(int handle);
+	// Releases the animation where it is, with or without calling its finished callback.
+	void stop(int handle, bool callFinished);
+
+	inline bool isReversed(int handle) const { return mControllers.items.at(handle).reverse; }
+	inline int getTime(int handle) const { return mControllers.items.at(handle).time; }
+
+	// Advances the animations of every component updated this frame, once per frame after the components.
+	void update(int deltaTime);
+
+	// the frame components are being updated in, see GuiComponent::updateSelf
+	inline unsigned int getFrame() const { return mFrame; }
+
+private:
+	AnimationManager();
+
+	enum TweenType : unsigned char
+	{
+		TWEEN_ANIMATION,
+		TWEEN_OPACITY,
+		TWEEN_POSITION,
+		TWEEN_CAMERA
+	};
+
+	struct Controller
+	{
+		GuiComponent* owner;
+		unsigned char slot;
+		TweenType type;
+		bool active;
+		bool reverse;
+		int time; // starts at -delay
+		int duration;
+		unsigned int tween; // index in the array for type
+		unsigned int frame; // mFrame when started, one started during update() waits for the next
+		std::function<void()> finishedCallback;
+	};
+
+	// entries are reused through the free list, so indices stay valid while in use
+	template<typename T>
+	struct Pool
+	{
+		std::vector<T> items;
+		std::vector<unsigned int> free;
+
+		unsigned int add(const T& item);
+		inline void remove(unsigned int index) { free.push_back(index); }
+	};
+
+	int add(GuiComponent* owner, unsigned char slot, TweenType type, unsigned int tween, int duration, int delay, const std::function<void()>& finishedCallback, bool reverse);
+	void apply(const Controller& controller, float t);
+	void release(int handle, bool callFinished);
+
+	static AnimationManager* sInstance;
+
+	Pool<Controller> mControllers;
+	Pool<Animation*> mAnimations;
+	Pool<OpacityTween> mOpacityTweens;
+	Pool<PositionTween> mPositionTweens;
+	Pool<CameraTween> mCameraTweens;
+
+	unsigned int mFrame;
+};
@@ -28,7 +28,7 @@ void ButtonComponent::setPressedFunc(std::function<void()> f)
 
 bool ButtonComponent::input(InputConfig* config, Input input)
 {
-	if(config->isMappedTo("a", input) && input.value != 0)
+	if(config->isMappedTo(ACTION_A, input) && input.value != 0)
 	{
 		if(mPressedFunc && mEnabled)
 			mPressedFunc();
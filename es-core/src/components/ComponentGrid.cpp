@@ -233,19 +233,19 @@ bool ComponentGrid::input(InputConfig* config, Input input)
 	if(!input.value)
 		return false;
 
-	if(config->isMappedTo("down", input))
+	if(config->isMappedTo(ACTION_DOWN, input))
 	{
 		return moveCursor(Eigen::Vector2i(0, 1));
 	}
-	if(config->isMappedTo("up", input))
+	if(config->isMappedTo(ACTION_UP, input))
 	{
 		return moveCursor(Eigen::Vector2i(0, -1));
 	}
-	if(config->isMappedTo("left", input))
+	if(config->isMappedTo(ACTION_LEFT, input))
 	{
 		return moveCursor(Eigen::Vector2i(-1, 0));
 	}
-	if(config->isMappedTo("right", input))
+	if(config->isMappedTo(ACTION_RIGHT, input))
 	{
 		return moveCursor(Eigen::Vector2i(1, 0));
 	}
@@ -75,16 +75,16 @@ bool ComponentList::input(InputConfig* config, Input input)
 	}
 
 	// input handler didn't consume the input - try to scroll
-	if(config->isMappedTo("up", input))
+	if(config->isMappedTo(ACTION_UP, input))
 	{
 		return listInput(input.value != 0 ? -1 : 0);
-	}else if(config->isMappedTo("down", input))
+	}else if(config->isMappedTo(ACTION_DOWN, input))
 	{
 		return listInput(input.value != 0 ? 1 : 0);
-	}else if(config->isMappedTo("leftbottom", input))
+	}else if(config->isMappedTo(ACTION_LEFTBOTTOM, input))
 	{
 		return listInput(input.value != 0 ? -7 : 0);
-	}else if(config->isMappedTo("rightbottom", input)){
+	}else if(config->isMappedTo(ACTION_RIGHTBOTTOM, input)){
 		return listInput(input.value != 0 ? 7 : 0);
 	}
 
@@ -22,7 +22,7 @@ bool DateTimeComponent::input(InputConfig* config, Input input)
 	if(input.value == 0)
 		return false;
 
-	if(config->isMappedTo("a", input))
+	if(config->isMappedTo(ACTION_A, input))
 	{
 		if(mDisplayMode != DISP_RELATIVE_TO_NOW) //don't allow editing for relative times
 			mEditing = !mEditing;
@@ -45,7 +45,7 @@ bool DateTimeComponent::input(InputConfig* config, Input input)
 
 	if(mEditing)
 	{
-		if(config->isMappedTo("b", input))
+		if(config->isMappedTo(ACTION_B, input))
 		{
 			mEditing = false;
 			mTime = mTimeBeforeEdit;
@@ -54,9 +54,9 @@ bool DateTimeComponent::input(InputConfig* config, Input input)
 		}
 
 		int incDir = 0;
-		if(config->isMappedTo("up", input) || config->isMappedTo("leftbottom", input))
+		if(config->isMappedTo(ACTION_UP, input) || config->isMappedTo(ACTION_LEFTBOTTOM, input))
 			incDir = 1;
-		else if(config->isMappedTo("down", input) || config->isMappedTo("rightbottom", input))
+		else if(config->isMappedTo(ACTION_DOWN, input) || config->isMappedTo(ACTION_RIGHTBOTTOM, input))
 			incDir = -1;
 
 		if(incDir != 0)
@@ -99,7 +99,7 @@ bool DateTimeComponent::input(InputConfig* config, Input input)
 			return true;
 		}
 
-		if(config->isMappedTo("right", input))
+		if(config->isMappedTo(ACTION_RIGHT, input))
 		{
 			mEditIndex++;
 			if(mEditIndex >= (int)mCursorBoxes.size())
@@ -107,7 +107,7 @@ bool DateTimeComponent::input(InputConfig* config, Input input)
 			return true;
 		}
 		
-		if(config->isMappedTo("left", input))
+		if(config->isMappedTo(ACTION_LEFT, input))
 		{
 			mEditIndex--;
 			if(mEditIndex < 0)
@@ -324,17 +324,17 @@ void DateTimeComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, cons
 	// setSize(), which will call updateTextCache(), which will reset mSize if 
 	// mAutoSize == true, ignoring the theme's value.
 	if(properties & ThemeFlags::SIZE)
-		mAutoSize = !elem->has("size");
+		mAutoSize = !elem->has(ThemeProperty::SIZE);
 
 	GuiComponent::applyTheme(theme, view, element, properties);
 
 	using namespace ThemeFlags;
 
-	if(properties & COLOR && elem->has("color"))
-		setColor(elem->get<unsigned int>("color"));
+	if(properties & COLOR && elem->has(ThemeProperty::COLOR))
+		setColor(elem->get<unsigned int>(ThemeProperty::COLOR));
 
-	if(properties & FORCE_UPPERCASE && elem->has("forceUppercase"))
-		setUppercase(elem->get<bool>("forceUppercase"));
+	if(properties & FORCE_UPPERCASE && elem->has(ThemeProperty::FORCE_UPPERCASE))
+		setUppercase(elem->get<bool>(ThemeProperty::FORCE_UPPERCASE));
 
 	setFont(Font::getFromTheme(elem, properties, mFont));
 }
@@ -114,6 +114,36 @@ public:
 		onCursorChanged(CURSOR_STOPPED);
 	}
 
+	// Returns up to count entries that are likely to be selected next, most likely first, so
+	// their resources can be loaded early. While scrolling this looks ahead in the scroll
+	// direction, further the faster we're going; when stopped it returns both neighbours.
+	std::vector<UserData> getUpcoming(int count) const
+	{
+		std::vector<UserData> upcoming;
+		if(size() < 2)
+			return upcoming;
+
+		if(mScrollVelocity == 0)
+		{
+			for(int i = 1; (int)upcoming.size() < count && i <= size() / 2; i++)
+			{
+				upcoming.push_back(mEntries.at(wrapIndex(mCursor + i)).object);
+				if((int)upcoming.size() < count && 2 * i != size())
+					upcoming.push_back(mEntries.at(wrapIndex(mCursor - i)).object);
+			}
+			return upcoming;
+		}
+
+		// nothing is shown while scrolling quickly, so skip ahead to about where the user
+		// will have stopped by the time they let go
+		const int leadTime = 250;
+		const int lead = mScrollTier > 0 ? leadTime / mTierList.tiers[mScrollTier].scrollDelay : 0;
+		for(int i = 0; i < count && i < size() - 1; i++)
+			upcoming.push_back(mEntries.at(wrapIndex(mCursor + mScrollVelocity * (lead + i + 1))).object);
+
+		return upcoming;
+	}
+
 	inline const std::string& getSelectedName()
 	{
 		assert(size() > 0);
@@ -300,6 +330,12 @@ protected:
 		onCursorChanged((mScrollTier > 0) ? CURSOR_SCROLLING : CURSOR_STOPPED);
 	}
 
+	int wrapIndex(int index) const
+	{
+		index %= size();
+		return index < 0 ? index + size() : index;
+	}
+
 	virtual void onCursorChanged(const CursorState& state) {}
 	virtual void onScroll(int amt) {}
 };
@@ -336,32 +336,32 @@ void ImageComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const s
 
 	Eigen::Vector2f scale = getParent() ? getParent()->getSize() : Eigen::Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 	
-	if(properties & POSITION && elem->has("pos"))
+	if(properties & POSITION && elem->has(ThemeProperty::POS))
 	{
-		Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>("pos").cwiseProduct(scale);
+		Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>(ThemeProperty::POS).cwiseProduct(scale);
 		setPosition(Eigen::Vector3f(denormalized.x(), denormalized.y(), 0));
 	}
 
 	if(properties & ThemeFlags::SIZE)
 	{
-		if(elem->has("size"))
-			setResize(elem->get<Eigen::Vector2f>("size").cwiseProduct(scale));
-		else if(elem->has("maxSize"))
-			setMaxSize(elem->get<Eigen::Vector2f>("maxSize").cwiseProduct(scale));
+		if(elem->has(ThemeProperty::SIZE))
+			setResize(elem->get<Eigen::Vector2f>(ThemeProperty::SIZE).cwiseProduct(scale));
+		else if(elem->has(ThemeProperty::MAX_SIZE))
+			setMaxSize(elem->get<Eigen::Vector2f>(ThemeProperty::MAX_SIZE).cwiseProduct(scale));
 	}
 
 	// position + size also implies origin
-	if((properties & ORIGIN || (properties & POSITION && properties & ThemeFlags::SIZE)) && elem->has("origin"))
-		setOrigin(elem->get<Eigen::Vector2f>("origin"));
+	if((properties & ORIGIN || (properties & POSITION && properties & ThemeFlags::SIZE)) && elem->has(ThemeProperty::ORIGIN))
+		setOrigin(elem->get<Eigen::Vector2f>(ThemeProperty::ORIGIN));
 
-	if(properties & PATH && elem->has("path"))
+	if(properties & PATH && elem->has(ThemeProperty::PATH))
 	{
-		bool tile = (elem->has("tile") && elem->get<bool>("tile"));
-		setImage(elem->get<std::string>("path"), tile);
+		bool tile = (elem->has(ThemeProperty::TILE) && elem->get<bool>(ThemeProperty::TILE));
+		setImage(elem->get<std::string>(ThemeProperty::PATH), tile);
 	}
 
-	if(properties & COLOR && elem->has("color"))
-		setColorShift(elem->get<unsigned int>("color"));
+	if(properties & COLOR && elem->has(ThemeProperty::COLOR))
+		setColorShift(elem->get<unsigned int>(ThemeProperty::COLOR));
 }
 
 std::vector<HelpPrompt> ImageComponent::getHelpPrompts()
@@ -116,13 +116,13 @@ bool ImageGridComponent<T>::input(InputConfig* config, Input input)
 	if(input.value != 0)
 	{
 		Eigen::Vector2i dir = Eigen::Vector2i::Zero();
-		if(config->isMappedTo("up", input))
+		if(config->isMappedTo(ACTION_UP, input))
 			dir[1] = -1;
-		else if(config->isMappedTo("down", input))
+		else if(config->isMappedTo(ACTION_DOWN, input))
 			dir[1] = 1;
-		else if(config->isMappedTo("left", input))
+		else if(config->isMappedTo(ACTION_LEFT, input))
 			dir[0] = -1;
-		else if(config->isMappedTo("right", input))
+		else if(config->isMappedTo(ACTION_RIGHT, input))
 			dir[0] = 1;
 
 		if(dir != Eigen::Vector2i::Zero())
@@ -131,7 +131,7 @@ bool ImageGridComponent<T>::input(InputConfig* config, Input input)
 			return true;
 		}
 	}else{
-		if(config->isMappedTo("up", input) || config->isMappedTo("down", input) || config->isMappedTo("left", input) || config->isMappedTo("right", input))
+		if(config->isMappedTo(ACTION_UP, input) || config->isMappedTo(ACTION_DOWN, input) || config->isMappedTo(ACTION_LEFT, input) || config->isMappedTo(ACTION_RIGHT, input))
 		{
 			stopScrolling();
 		}
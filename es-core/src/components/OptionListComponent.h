@@ -120,7 +120,7 @@ private:
 
 		bool input(InputConfig* config, Input input) override
 		{
-			if(config->isMappedTo("b", input) && input.value != 0)
+			if(config->isMappedTo(ACTION_B, input) && input.value != 0)
 			{
 				delete this;
 				return true;
@@ -184,14 +184,14 @@ public:
 	{
 		if(input.value != 0)
 		{
-			if(config->isMappedTo("a", input))
+			if(config->isMappedTo(ACTION_A, input))
 			{
 				open();
 				return true;
 			}
 			if(!mMultiSelect)
 			{
-				if(config->isMappedTo("left", input))
+				if(config->isMappedTo(ACTION_LEFT, input))
 				{
 					// move selection to previous
 					unsigned int i = getSelectedId();
@@ -204,7 +204,7 @@ public:
 					onSelectedChanged();
 					return true;
 
-				}else if(config->isMappedTo("right", input))
+				}else if(config->isMappedTo(ACTION_RIGHT, input))
 				{
 					// move selection to next
 					unsigned int i = getSelectedId();
@@ -24,7 +24,7 @@ SliderComponent::SliderComponent(Window* window, float min, float max, float inc
 
 bool SliderComponent::input(InputConfig* config, Input input)
 {
-	if(config->isMappedTo("left", input))
+	if(config->isMappedTo(ACTION_LEFT, input))
 	{
 		if(input.value)
 			setValue(mValue - mSingleIncrement);
@@ -33,7 +33,7 @@ bool SliderComponent::input(InputConfig* config, Input input)
 		mMoveAccumulator = -MOVE_REPEAT_DELAY;
 		return true;
 	}
-	if(config->isMappedTo("right", input))
+	if(config->isMappedTo(ACTION_RIGHT, input))
 	{
 		if(input.value)
 			setValue(mValue + mSingleIncrement);
@@ -17,7 +17,7 @@ void SwitchComponent::onSizeChanged()
 
 bool SwitchComponent::input(InputConfig* config, Input input)
 {
-	if(config->isMappedTo("a", input) && input.value)
+	if(config->isMappedTo(ACTION_A, input) && input.value)
 	{
 		mState = !mState;
 		onStateChanged();
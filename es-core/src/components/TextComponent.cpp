@@ -216,12 +216,12 @@ void TextComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const st
 	if(!elem)
 		return;
 
-	if(properties & COLOR && elem->has("color"))
-		setColor(elem->get<unsigned int>("color"));
+	if(properties & COLOR && elem->has(ThemeProperty::COLOR))
+		setColor(elem->get<unsigned int>(ThemeProperty::COLOR));
 
-	if(properties & ALIGNMENT && elem->has("alignment"))
+	if(properties & ALIGNMENT && elem->has(ThemeProperty::ALIGNMENT))
 	{
-		std::string str = elem->get<std::string>("alignment");
+		std::string str = elem->get<std::string>(ThemeProperty::ALIGNMENT);
 		if(str == "left")
 			setAlignment(ALIGN_LEFT);
 		else if(str == "center")
@@ -232,14 +232,14 @@ void TextComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const st
 			LOG(LogError) << "Unknown text alignment string: " << str;
 	}
 
-	if(properties & TEXT && elem->has("text"))
-		setText(elem->get<std::string>("text"));
+	if(properties & TEXT && elem->has(ThemeProperty::TEXT))
+		setText(elem->get<std::string>(ThemeProperty::TEXT));
 
-	if(properties & FORCE_UPPERCASE && elem->has("forceUppercase"))
-		setUppercase(elem->get<bool>("forceUppercase"));
+	if(properties & FORCE_UPPERCASE && elem->has(ThemeProperty::FORCE_UPPERCASE))
+		setUppercase(elem->get<bool>(ThemeProperty::FORCE_UPPERCASE));
 
-	if(properties & LINE_SPACING && elem->has("lineSpacing"))
-		setLineSpacing(elem->get<float>("lineSpacing"));
+	if(properties & LINE_SPACING && elem->has(ThemeProperty::LINE_SPACING))
+		setLineSpacing(elem->get<float>(ThemeProperty::LINE_SPACING));
 
 	setFont(Font::getFromTheme(elem, properties, mFont));
 }
@@ -93,13 +93,13 @@ bool TextEditComponent::input(InputConfig* config, Input input)
 {
 	if(input.value == 0)
 	{
-		if(config->isMappedTo("left", input) || config->isMappedTo("right", input))
+		if(config->isMappedTo(ACTION_LEFT, input) || config->isMappedTo(ACTION_RIGHT, input))
 			mCursorRepeatDir = 0;
 
 		return false;
 	}
 
-	if(config->isMappedTo("a", input) && mFocused && !mEditing)
+	if(config->isMappedTo(ACTION_A, input) && mFocused && !mEditing)
 	{
 		startEditing();
 		return true;
@@ -119,21 +119,21 @@ bool TextEditComponent::input(InputConfig* config, Input input)
 			return true;
 		}
 
-		if((config->getDeviceId() == DEVICE_KEYBOARD && input.id == SDLK_ESCAPE) || (config->getDeviceId() != DEVICE_KEYBOARD && config->isMappedTo("b", input)))
+		if((config->getDeviceId() == DEVICE_KEYBOARD && input.id == SDLK_ESCAPE) || (config->getDeviceId() != DEVICE_KEYBOARD && config->isMappedTo(ACTION_B, input)))
 		{
 			stopEditing();
 			return true;
 		}
 
-		if(config->isMappedTo("up", input))
+		if(config->isMappedTo(ACTION_UP, input))
 		{
 			// TODO
-		}else if(config->isMappedTo("down", input))
+		}else if(config->isMappedTo(ACTION_DOWN, input))
 		{
 			// TODO
-		}else if(config->isMappedTo("left", input) || config->isMappedTo("right", input))
+		}else if(config->isMappedTo(ACTION_LEFT, input) || config->isMappedTo(ACTION_RIGHT, input))
 		{
-			mCursorRepeatDir = config->isMappedTo("left", input) ? -1 : 1;
+			mCursorRepeatDir = config->isMappedTo(ACTION_LEFT, input) ? -1 : 1;
 			mCursorRepeatTimer = -(CURSOR_REPEAT_START_DELAY - CURSOR_REPEAT_SPEED);
 			moveCursor(mCursorRepeatDir);
 		}
@@ -30,11 +30,12 @@ public:
 
 	void setCursor(size_t pos);
 
+	void startEditing();
+	void stopEditing();
+
 	virtual std::vector<HelpPrompt> getHelpPrompts() override;
 
 private:
-	void startEditing();
-	void stopEditing();
 
 	void onTextChanged();
 	void onCursorChanged();
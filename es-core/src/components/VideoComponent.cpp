@@ -239,32 +239,32 @@ void VideoComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const s
 
 	Eigen::Vector2f scale = getParent() ? getParent()->getSize() : Eigen::Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 
-	if ((properties & POSITION) && elem->has("pos"))
+	if ((properties & POSITION) && elem->has(ThemeProperty::POS))
 	{
-		Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>("pos").cwiseProduct(scale);
+		Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>(ThemeProperty::POS).cwiseProduct(scale);
 		setPosition(Eigen::Vector3f(denormalized.x(), denormalized.y(), 0));
 	}
 
-	if ((properties & ThemeFlags::SIZE) && elem->has("size"))
+	if ((properties & ThemeFlags::SIZE) && elem->has(ThemeProperty::SIZE))
 	{
-		setSize(elem->get<Eigen::Vector2f>("size").cwiseProduct(scale));
+		setSize(elem->get<Eigen::Vector2f>(ThemeProperty::SIZE).cwiseProduct(scale));
 	}
 
 	// position + size also implies origin
-	if (((properties & ORIGIN) || ((properties & POSITION) && (properties & ThemeFlags::SIZE))) && elem->has("origin"))
-		setOrigin(elem->get<Eigen::Vector2f>("origin"));
+	if (((properties & ORIGIN) || ((properties & POSITION) && (properties & ThemeFlags::SIZE))) && elem->has(ThemeProperty::ORIGIN))
+		setOrigin(elem->get<Eigen::Vector2f>(ThemeProperty::ORIGIN));
 
-	if(elem->has("default"))
-		mConfig.defaultVideoPath = elem->get<std::string>("default");
+	if(elem->has(ThemeProperty::DEFAULT))
+		mConfig.defaultVideoPath = elem->get<std::string>(ThemeProperty::DEFAULT);
 
-	if((properties & ThemeFlags::DELAY) && elem->has("delay"))
-		mConfig.startDelay = (unsigned)(elem->get<float>("delay") * 1000.0f);
+	if((properties & ThemeFlags::DELAY) && elem->has(ThemeProperty::DELAY))
+		mConfig.startDelay = (unsigned)(elem->get<float>(ThemeProperty::DELAY) * 1000.0f);
 
-	if (elem->has("showSnapshotNoVideo"))
-		mConfig.showSnapshotNoVideo = elem->get<bool>("showSnapshotNoVideo");
+	if (elem->has(ThemeProperty::SHOW_SNAPSHOT_NO_VIDEO))
+		mConfig.showSnapshotNoVideo = elem->get<bool>(ThemeProperty::SHOW_SNAPSHOT_NO_VIDEO);
 
-	if (elem->has("showSnapshotDelay"))
-		mConfig.showSnapshotDelay = elem->get<bool>("showSnapshotDelay");
+	if (elem->has(ThemeProperty::SHOW_SNAPSHOT_DELAY))
+		mConfig.showSnapshotDelay = elem->get<bool>(ThemeProperty::SHOW_SNAPSHOT_DELAY);
 
 	// Update the embeded static image
 	mStaticImage.setPosition(getPosition());
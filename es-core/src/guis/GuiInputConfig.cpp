@@ -201,7 +201,7 @@ GuiInputConfig::GuiInputConfig(Window* window, InputConfig* target, bool reconfi
 			// if we're not configuring, start configuring when A is pressed
 			if(!mConfiguringRow)
 			{
-				if(config->isMappedTo("a", input) && input.value)
+				if(config->isMappedTo(ACTION_A, input) && input.value)
 				{
 					mList->stopScrolling();
 					mConfiguringRow = true;
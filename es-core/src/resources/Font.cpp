@@ -414,7 +414,8 @@ FT_Face Font::getFaceForChar(UnicodeChar id)
 			// i == 0 -> mPath
 			// otherwise, take from fallbackFonts
 			const std::string& path = (i == 0 ? mPath : fallbackFonts.at(i - 1));
-			ResourceData data = ResourceManager::getInstance()->getFileData(path);
+			// kept for the face's whole life, so never a mapping the file could be truncated under
+			ResourceData data = ResourceManager::getInstance()->getFileData(path, true);
 			mFaceCache[i] = std::unique_ptr<FontFace>(new FontFace(std::move(data), mSize));
 			fit = mFaceCache.find(i);
 		}
@@ -524,6 +525,16 @@ void Font::rebuildTextures()
 }
 
 void Font::renderTextCache(TextCache* cache)
+{
+	drawTextCache(cache, false, 0);
+}
+
+void Font::renderTextCache(TextCache* cache, unsigned int color)
+{
+	drawTextCache(cache, true, color);
+}
+
+void Font::drawTextCache(TextCache* cache, bool useColor, unsigned int color)
 {
 	if(cache == NULL)
 	{
@@ -531,6 +542,10 @@ void Font::renderTextCache(TextCache* cache)
 		return;
 	}
 
+	// a single colour is set once per draw instead of being read from the per-vertex array
+	if(useColor)
+		glColor4ub((color >> 24) & 0xFF, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
+
 	for(auto it = cache->vertexLists.begin(); it != cache->vertexLists.end(); it++)
 	{
 		assert(*it->textureIdPtr != 0);
@@ -544,21 +559,27 @@ void Font::renderTextCache(TextCache* cache)
 
 		glEnableClientState(GL_VERTEX_ARRAY);
 		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-		glEnableClientState(GL_COLOR_ARRAY);
+		if(!useColor)
+			glEnableClientState(GL_COLOR_ARRAY);
 
 		glVertexPointer(2, GL_FLOAT, sizeof(TextCache::Vertex), it->verts[0].pos.data());
 		glTexCoordPointer(2, GL_FLOAT, sizeof(TextCache::Vertex), it->verts[0].tex.data());
-		glColorPointer(4, GL_UNSIGNED_BYTE, 0, it->colors.data());
+		if(!useColor)
+			glColorPointer(4, GL_UNSIGNED_BYTE, 0, it->colors.data());
 
 		glDrawArrays(GL_TRIANGLES, 0, it->verts.size());
 
 		glDisableClientState(GL_VERTEX_ARRAY);
 		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-		glDisableClientState(GL_COLOR_ARRAY);
+		if(!useColor)
+			glDisableClientState(GL_COLOR_ARRAY);
 
 		glDisable(GL_TEXTURE_2D);
 		glDisable(GL_BLEND);
 	}
+
+	if(useColor)
+		glColor4ub(255, 255, 255, 255);
 }
 
 Eigen::Vector2f Font::sizeText(std::string text, float lineSpacing)
@@ -839,10 +860,10 @@ std::shared_ptr<Font> Font::getFromTheme(const ThemeData::ThemeElement* elem, un
 	std::string path = (orig ? orig->mPath : getDefaultPath());
 
 	float sh = (float)Renderer::getScreenHeight();
-	if(properties & FONT_SIZE && elem->has("fontSize")) 
-		size = (int)(sh * elem->get<float>("fontSize"));
-	if(properties & FONT_PATH && elem->has("fontPath"))
-		path = elem->get<std::string>("fontPath");
+	if(properties & FONT_SIZE && elem->has(ThemeProperty::FONT_SIZE)) 
+		size = (int)(sh * elem->get<float>(ThemeProperty::FONT_SIZE));
+	if(properties & FONT_PATH && elem->has(ThemeProperty::FONT_PATH))
+		path = elem->get<std::string>(ThemeProperty::FONT_PATH);
 
 	return get(size, path);
 }
@@ -42,6 +42,7 @@ public:
 	TextCache* buildTextCache(const std::string& text, float offsetX, float offsetY, unsigned int color);
 	TextCache* buildTextCache(const std::string& text, Eigen::Vector2f offset, unsigned int color, float xLen, Alignment alignment = ALIGN_LEFT, float lineSpacing = 1.5f);
 	void renderTextCache(TextCache* cache);
+	void renderTextCache(TextCache* cache, unsigned int color); // ignores the colours stored in the cache and draws everything in color
 	
 	std::string wrapText(std::string text, float xLen); // Inserts newlines into text to make it wrap properly.
 	Eigen::Vector2f sizeWrappedText(std::string text, float xLen, float lineSpacing = 1.5f); // Returns the expected size of a string after wrapping is applied.
@@ -134,6 +135,8 @@ private:
 
 	float getNewlineStartOffset(const std::string& text, const unsigned int& charStart, const float& xLen, const Alignment& alignment);
 
+	void drawTextCache(TextCache* cache, bool useColor, unsigned int color);
+
 	friend TextCache;
 };
 
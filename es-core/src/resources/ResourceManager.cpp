@@ -3,9 +3,18 @@
 #include "../data/Resources.h"
 #include <fstream>
 #include <boost/filesystem.hpp>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace fs = boost::filesystem;
 
+// files at least this big are memory mapped instead of read, unless the data is kept
+#define MAP_MIN_SIZE (1024 * 1024)
+
 auto array_deleter = [](unsigned char* p) { delete[] p; };
 auto nop_deleter = [](unsigned char* p) { };
 
@@ -23,7 +32,7 @@ std::shared_ptr<ResourceManager>& ResourceManager::getInstance()
 	return sInstance;
 }
 
-const ResourceData ResourceManager::getFileData(const std::string& path) const
+const ResourceData ResourceManager::getFileData(const std::string& path, bool keep) const
 {
 	//check if its embedded
 	
@@ -45,12 +54,119 @@ const ResourceData ResourceManager::getFileData(const std::string& path) const
 		ResourceData data = {NULL, 0};
 		return data;
 	}else{
-		ResourceData data = loadFile(path);
+		ResourceData data = shareFile(path, keep);
+		if(data.ptr)
+			return data;
+		return loadFile(path);
+	}
+}
+
+const ResourceData ResourceManager::getFileHeader(const std::string& path, size_t length) const
+{
+	//embedded files are already in memory, so there's nothing to save
+	if(res2hMap.find(path) != res2hMap.end())
+		return getFileData(path);
+
+	if(!fs::exists(path))
+	{
+		ResourceData data = {NULL, 0};
 		return data;
 	}
+
+	ResourceData data = shareFile(path, false, length);
+	if(data.ptr)
+		return data;
+	return loadFile(path, length);
+}
+
+ResourceData ResourceManager::shareFile(const std::string& path, bool keep, size_t needed) const
+{
+#ifdef WIN32
+	ResourceData none = {NULL, 0};
+	return none;
+#else
+	ResourceData none = {NULL, 0};
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		return none;
+
+	struct stat info;
+	if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+	{
+		// mmap can't do empty files, let loadFile deal with them
+		close(fd);
+		return none;
+	}
+
+	const size_t length = (size_t)info.st_size;
+	std::unique_lock<std::mutex> lock(mSharedFilesMutex);
+
+	// an edited file is read again, anything still using the old contents keeps them
+	auto it = mSharedFiles.find(path);
+	if(it != mSharedFiles.end() && it->second.modified == info.st_mtime && it->second.length == length && !(keep && it->second.mapped))
+	{
+		std::shared_ptr<unsigned char> ptr = it->second.ptr.lock();
+		if(ptr)
+		{
+			close(fd);
+			ResourceData data = {ptr, length};
+			return data;
+		}
+	}
+
+	std::shared_ptr<unsigned char> ptr;
+	const bool map = !keep && length >= MAP_MIN_SIZE;
+	if(map)
+	{
+		void* mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mapped != MAP_FAILED)
+			ptr = std::shared_ptr<unsigned char>((unsigned char*)mapped, [length](unsigned char* p) { munmap(p, length); });
+		else
+			LOG(LogWarning) << "Could not map \"" << path << "\", reading it instead";
+	}
+	else if(needed < length)
+	{
+		// only the start is wanted, not worth reading all of it
+		close(fd);
+		return none;
+	}
+	else
+	{
+		std::shared_ptr<unsigned char> buffer(new unsigned char[length], array_deleter);
+		size_t done = 0;
+		while(done < length)
+		{
+			ssize_t count = read(fd, buffer.get() + done, length - done);
+			if(count <= 0)
+				break;
+			done += (size_t)count;
+		}
+		if(done == length)
+			ptr = buffer;
+	}
+	close(fd);
+
+	if(!ptr)
+		return none;
+
+	// forget contents nobody uses any more so the map stays small
+	for(auto entry = mSharedFiles.begin(); entry != mSharedFiles.end(); )
+	{
+		if(entry->second.ptr.expired())
+			entry = mSharedFiles.erase(entry);
+		else
+			entry++;
+	}
+	SharedFile entry = {info.st_mtime, length, map, ptr};
+	mSharedFiles[path] = entry;
+
+	ResourceData data = {ptr, length};
+	return data;
+#endif
 }
 
-ResourceData ResourceManager::loadFile(const std::string& path) const
+ResourceData ResourceManager::loadFile(const std::string& path, size_t maxLength) const
 {
 	std::ifstream stream(path, std::ios::binary);
 
@@ -58,6 +174,9 @@ ResourceData ResourceManager::loadFile(const std::string& path) const
 	size_t size = (size_t)stream.tellg();
 	stream.seekg(0, stream.beg);
 
+	if(size > maxLength)
+		size = maxLength;
+
 	//supply custom deleter to properly free array
 	std::shared_ptr<unsigned char> data(new unsigned char[size], array_deleter);
 	stream.read((char*)data.get(), size);
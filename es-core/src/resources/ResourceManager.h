@@ -4,11 +4,16 @@
 #include <memory>
 #include <map>
 #include <list>
+#include <string>
+#include <mutex>
+#include <ctime>
 
 //The ResourceManager exists to...
 //Allow loading resources embedded into the executable like an actual file.
 //Allow embedded resources to be optionally remapped to actual files for further customization.
 
+// File contents. For files on disk this is usually shared by everything that asked for the
+// same file, and big ones may be a read-only memory mapping, so it must not be modified.
 struct ResourceData
 {
 	const std::shared_ptr<unsigned char> ptr;
@@ -34,7 +39,13 @@ public:
 	void unloadAll();
 	void reloadAll();
 
-	const ResourceData getFileData(const std::string& path) const;
+	// Big files are memory mapped unless keep is set. A mapping must only be held while the data is
+	// read, as reading it after the file was truncated in place (an editor or sync tool rewriting it)
+	// crashes with SIGBUS, so anything holding on to the data (a font face) has to set keep
+	const ResourceData getFileData(const std::string& path, bool keep = false) const;
+	// Like getFileData, but only needs the first length bytes of files on disk. Mapped or
+	// already shared files are returned whole
+	const ResourceData getFileHeader(const std::string& path, size_t length) const;
 	bool fileExists(const std::string& path) const;
 
 private:
@@ -42,7 +53,21 @@ private:
 
 	static std::shared_ptr<ResourceManager> sInstance;
 
-	ResourceData loadFile(const std::string& path) const;
+	ResourceData loadFile(const std::string& path, size_t maxLength = (size_t)-1) const;
+	// The whole file, reusing its contents if still in use, mapped if it's big and not kept. Returns
+	// an empty ResourceData if the file can't be read, or if it's only read for the first needed bytes
+	ResourceData shareFile(const std::string& path, bool keep, size_t needed = (size_t)-1) const;
+
+	struct SharedFile
+	{
+		std::time_t modified;
+		size_t length;
+		bool mapped;
+		std::weak_ptr<unsigned char> ptr;
+	};
+	// Contents by path. The contents themselves go when the last ResourceData using them does
+	mutable std::map<std::string, SharedFile> mSharedFiles;
+	mutable std::mutex mSharedFilesMutex;
 
 	std::list< std::weak_ptr<IReloadable> > mReloadables;
 };
@@ -4,11 +4,134 @@
 #include "ImageIO.h"
 #include "string.h"
 #include "Util.h"
+#include "ThreadPool.h"
+#include "../data/Resources.h"
 #include "nanosvg/nanosvg.h"
 #include "nanosvg/nanosvgrast.h"
 #include <vector>
+#include <map>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <boost/filesystem.hpp>
 
 #define DPI 96
+// Bands thinner than this aren't worth a thread, each one has to flatten every shape again
+#define SVG_BAND_MIN_ROWS 64
+#define SVG_BENCHMARK_RUNS 3
+
+std::atomic<unsigned int> TextureData::sStallCount(0);
+std::atomic<unsigned int> TextureData::sStallTime(0);
+
+static thread_local bool sIsLoaderThread = false;
+
+// Probed image sizes by path. The modification time is kept so edited files get probed again
+struct ImageSizeCacheEntry
+{
+	std::time_t modified;
+	float width;
+	float height;
+};
+static std::map<std::string, ImageSizeCacheEntry> sImageSizeCache;
+static std::mutex sImageSizeCacheMutex;
+
+static std::time_t getModifiedTime(const std::string& path)
+{
+	// embedded resources don't exist on disk and never change
+	boost::system::error_code ec;
+	std::time_t modified = boost::filesystem::last_write_time(path, ec);
+	return ec ? 0 : modified;
+}
+
+// Parsed SVG documents by path, shared by every texture rasterizing the same file at
+// different sizes. Only weak references are kept so a document goes once nothing uses it
+struct SVGImageCacheEntry
+{
+	std::time_t modified;
+	std::weak_ptr<NSVGimage> image;
+};
+static std::map<std::string, SVGImageCacheEntry> sSVGImageCache;
+static std::mutex sSVGImageCacheMutex;
+
+static std::shared_ptr<NSVGimage> parseSVG(const unsigned char* fileData, size_t length)
+{
+	// nsvgParse excepts a modifiable, null-terminated string
+	char* copy = (char*)malloc(length + 1);
+	assert(copy != NULL);
+	memcpy(copy, fileData, length);
+	copy[length] = '\0';
+
+	NSVGimage* svgImage = nsvgParse(copy, "px", DPI);
+	free(copy);
+	if (!svgImage)
+		return nullptr;
+	return std::shared_ptr<NSVGimage>(svgImage, nsvgDelete);
+}
+
+static size_t getSVGBandCount(size_t height)
+{
+	size_t bands = std::min(ThreadPool::getInstance()->getThreadCount() + 1, height / SVG_BAND_MIN_ROWS);
+	return std::max(bands, (size_t)1);
+}
+
+// Rasterize svgImage into dataRGBA in horizontal bands spread over the thread pool. Each band
+// is written bottom up (a negative stride) so the result is already in OpenGL row order
+static void rasterizeSVG(NSVGimage* svgImage, float scale, unsigned char* dataRGBA, size_t width, size_t height, size_t bands)
+{
+	std::vector<std::function<void()> > jobs;
+	for (size_t band = 0; band < bands; ++band)
+	{
+		const size_t top = height * band / bands;
+		const size_t rows = (height * (band + 1) / bands) - top;
+		jobs.push_back([svgImage, scale, dataRGBA, width, height, top, rows] {
+			NSVGrasterizer* rast = nsvgCreateRasterizer();
+			unsigned char* dst = dataRGBA + (height - 1 - top) * width * 4;
+			nsvgRasterize(rast, svgImage, 0, -(float)top, scale, dst, (int)width, (int)rows, -(int)(width * 4));
+			nsvgDeleteRasterizer(rast);
+		});
+	}
+	ThreadPool::getInstance()->run(jobs);
+}
+
+static std::shared_ptr<NSVGimage> getSVGImage(const std::string& path)
+{
+	const std::time_t modified = getModifiedTime(path);
+	{
+		std::unique_lock<std::mutex> lock(sSVGImageCacheMutex);
+		auto it = sSVGImageCache.find(path);
+		if (it != sSVGImageCache.end() && it->second.modified == modified)
+		{
+			std::shared_ptr<NSVGimage> svgImage = it->second.image.lock();
+			if (svgImage)
+				return svgImage;
+		}
+	}
+
+	// Parse outside the lock, two threads racing on the same file just means one wasted parse
+	const ResourceData& data = ResourceManager::getInstance()->getFileData(path);
+	if (!data.ptr)
+		return nullptr;
+	std::shared_ptr<NSVGimage> svgImage = parseSVG((const unsigned char*)data.ptr.get(), data.length);
+	if (!svgImage)
+		return nullptr;
+
+	std::unique_lock<std::mutex> lock(sSVGImageCacheMutex);
+	for (auto it = sSVGImageCache.begin(); it != sSVGImageCache.end(); )
+	{
+		if (it->second.image.expired())
+			it = sSVGImageCache.erase(it);
+		else
+			++it;
+	}
+	SVGImageCacheEntry entry = { modified, svgImage };
+	sSVGImageCache[path] = entry;
+	return svgImage;
+}
+
+void TextureData::setLoaderThread()
+{
+	sIsLoaderThread = true;
+}
 
 TextureData::TextureData(bool tile) : mTile(tile), mTextureID(0), mDataRGBA(nullptr), mScalable(false),
 									  mWidth(0), mHeight(0), mSourceWidth(0.0f), mSourceHeight(0.0f)
@@ -27,6 +150,8 @@ void TextureData::initFromPath(const std::string& path)
 	mPath = path;
 	// Only textures with paths are reloadable
 	mReloadable = true;
+	// Known up front so the rasterization size can be set before anything is loaded
+	mScalable = (mPath.size() >= 4) && (mPath.substr(mPath.size() - 4, std::string::npos) == ".svg");
 }
 
 bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length)
@@ -38,20 +163,26 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 			return true;
 	}
 
-	// nsvgParse excepts a modifiable, null-terminated string
-	char* copy = (char*)malloc(length + 1);
-	assert(copy != NULL);
-	memcpy(copy, fileData, length);
-	copy[length] = '\0';
-
-	NSVGimage* svgImage = nsvgParse(copy, "px", DPI);
-	free(copy);
+	std::shared_ptr<NSVGimage> svgImage = parseSVG(fileData, length);
 	if (!svgImage)
 	{
 		LOG(LogError) << "Error parsing SVG image.";
 		return false;
 	}
 
+	return initSVG(svgImage);
+}
+
+bool TextureData::initSVG(std::shared_ptr<NSVGimage> svgImage)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mDataRGBA)
+			return true;
+		mSVGImage = svgImage;
+	}
+	mScalable = true;
+
 	// We want to rasterise this texture at a specific resolution. If the source size
 	// variables are set then use them otherwise set them from the parsed file
 	if ((mSourceWidth == 0.0f) && (mSourceHeight == 0.0f))
@@ -75,11 +206,7 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 
 	unsigned char* dataRGBA = new unsigned char[mWidth * mHeight * 4];
 
-	NSVGrasterizer* rast = nsvgCreateRasterizer();
-	nsvgRasterize(rast, svgImage, 0, 0, mHeight / svgImage->height, dataRGBA, mWidth, mHeight, mWidth * 4);
-	nsvgDeleteRasterizer(rast);
-
-	ImageIO::flipPixelsVert(dataRGBA, mWidth, mHeight);
+	rasterizeSVG(svgImage.get(), mHeight / svgImage->height, dataRGBA, mWidth, mHeight, getSVGBandCount(mHeight));
 
 	std::unique_lock<std::mutex> lock(mMutex);
 	mDataRGBA = dataRGBA;
@@ -87,6 +214,18 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 	return true;
 }
 
+void TextureData::shareSVGImage(TextureData* source)
+{
+	std::shared_ptr<NSVGimage> svgImage;
+	{
+		std::unique_lock<std::mutex> lock(source->mMutex);
+		svgImage = source->mSVGImage;
+	}
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!mSVGImage)
+		mSVGImage = svgImage;
+}
+
 bool TextureData::initImageFromMemory(const unsigned char* fileData, size_t length)
 {
 	size_t width, height;
@@ -130,24 +269,129 @@ bool TextureData::initFromRGBA(const unsigned char* dataRGBA, size_t width, size
 bool TextureData::load()
 {
 	bool retval = false;
+	auto start = std::chrono::high_resolution_clock::now();
 
 	// Need to load. See if there is a file
 	if (!mPath.empty())
 	{
-		std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
-		const ResourceData& data = rm->getFileData(mPath);
-		// is it an SVG?
-		if (mPath.substr(mPath.size() - 4, std::string::npos) == ".svg")
+		if (mScalable)
 		{
-			mScalable = true;
-			retval = initSVGFromMemory((const unsigned char*)data.ptr.get(), data.length);
+			// Reuse the document parsed by an earlier load, probeSize() or another texture of the same file
+			std::shared_ptr<NSVGimage> svgImage;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				svgImage = mSVGImage;
+			}
+			if (!svgImage)
+				svgImage = getSVGImage(mPath);
+			if (svgImage)
+				retval = initSVG(svgImage);
+			else
+				LOG(LogError) << "Error parsing SVG image \"" << mPath << "\"";
 		}
 		else
+		{
+			std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
+			const ResourceData& data = rm->getFileData(mPath);
 			retval = initImageFromMemory((const unsigned char*)data.ptr.get(), data.length);
+		}
+
+		if (!sIsLoaderThread)
+		{
+			sStallCount++;
+			sStallTime += (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+		}
 	}
 	return retval;
 }
 
+bool TextureData::probeSize()
+{
+	if (mPath.empty())
+		return false;
+
+	const std::time_t modified = getModifiedTime(mPath);
+	float width = 0.0f;
+	float height = 0.0f;
+	{
+		std::unique_lock<std::mutex> lock(sImageSizeCacheMutex);
+		auto it = sImageSizeCache.find(mPath);
+		if (it != sImageSizeCache.end() && it->second.modified == modified)
+		{
+			width = it->second.width;
+			height = it->second.height;
+		}
+	}
+
+	const bool svg = (mPath.substr(mPath.size() - 4, std::string::npos) == ".svg");
+	if (width == 0.0f || height == 0.0f)
+	{
+		if (svg)
+		{
+			// The whole document has to be parsed, but that's cheap next to rasterizing it
+			// and the loader gets to reuse it
+			std::shared_ptr<NSVGimage> svgImage = getSVGImage(mPath);
+			if (!svgImage)
+				return false;
+
+			width = svgImage->width;
+			height = svgImage->height;
+			std::unique_lock<std::mutex> lock(mMutex);
+			mSVGImage = svgImage;
+		}
+		else
+		{
+			// Most headers are tiny but JPEG frame headers can come after large EXIF blocks
+			size_t w = 0;
+			size_t h = 0;
+			for (size_t length = 4096; length <= 256 * 1024; length *= 4)
+			{
+				const ResourceData& data = ResourceManager::getInstance()->getFileHeader(mPath, length);
+				if (!data.ptr)
+					return false;
+
+				if (ImageIO::getImageSize(data.ptr.get(), data.length, w, h) || data.length < length)
+					break;
+			}
+			width = (float)w;
+			height = (float)h;
+		}
+
+		if (width == 0.0f || height == 0.0f)
+			return false;
+
+		std::unique_lock<std::mutex> lock(sImageSizeCacheMutex);
+		ImageSizeCacheEntry entry = { modified, width, height };
+		sImageSizeCache[mPath] = entry;
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (svg)
+	{
+		// Same as initSVG - an explicit size from rasterizeAt() takes priority
+		mScalable = true;
+		if ((mSourceWidth == 0.0f) && (mSourceHeight == 0.0f))
+		{
+			mSourceWidth = width;
+			mSourceHeight = height;
+		}
+		mWidth = (size_t)round(mSourceWidth);
+		mHeight = (size_t)round(mSourceHeight);
+		if (mWidth == 0)
+			mWidth = (size_t)round((mHeight / height) * width);
+		else if (mHeight == 0)
+			mHeight = (size_t)round((mWidth / width) * height);
+	}
+	else
+	{
+		mSourceWidth = width;
+		mSourceHeight = height;
+		mWidth = (size_t)width;
+		mHeight = (size_t)height;
+	}
+	return true;
+}
+
 bool TextureData::isLoaded()
 {
 	std::unique_lock<std::mutex> lock(mMutex);
@@ -246,6 +490,12 @@ void TextureData::setSourceSize(float width, float height)
 			mSourceHeight = height;
 			releaseVRAM();
 			releaseRAM();
+			// With both dimensions given the raster size is known without loading anything
+			if ((width > 0.0f) && (height > 0.0f))
+			{
+				mWidth = (size_t)round(width);
+				mHeight = (size_t)round(height);
+			}
 		}
 	}
 }
@@ -257,3 +507,90 @@ size_t TextureData::getVRAMUsage()
 	else
 		return 0;
 }
+
+size_t TextureData::getRAMUsage()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	return (mDataRGBA != nullptr) ? mWidth * mHeight * 4 : 0;
+}
+
+bool TextureData::writeRGBA(std::ostream& out)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (mDataRGBA == nullptr)
+		return false;
+
+	const unsigned int size[2] = { (unsigned int)mWidth, (unsigned int)mHeight };
+	out.write((const char*)size, sizeof(size));
+	out.write((const char*)mDataRGBA, mWidth * mHeight * 4);
+	return out.good();
+}
+
+bool TextureData::readRGBA(std::istream& in)
+{
+	unsigned int size[2];
+	if (!in.read((char*)size, sizeof(size)))
+		return false;
+
+	std::vector<unsigned char> dataRGBA((size_t)size[0] * size[1] * 4);
+	if (!in.read((char*)dataRGBA.data(), dataRGBA.size()))
+		return false;
+
+	return initFromRGBA(dataRGBA.data(), size[0], size[1]);
+}
+
+void TextureData::benchmarkSVG()
+{
+	static const size_t heights[] = { 480, 720, 1080, 2160 };
+
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	ss << "SVG rasterization, best of " << SVG_BENCHMARK_RUNS << " runs, " << (ThreadPool::getInstance()->getThreadCount() + 1) << " threads:\n";
+
+	for (size_t i = 0; i < res2hNrOfFiles; ++i)
+	{
+		const std::string path = res2hFiles[i].relativeFileName;
+		if (path.size() < 4 || path.substr(path.size() - 4, std::string::npos) != ".svg")
+			continue;
+
+		std::shared_ptr<NSVGimage> svgImage = parseSVG(res2hFiles[i].data, res2hFiles[i].size);
+		if (!svgImage || svgImage->width <= 0 || svgImage->height <= 0)
+			continue;
+
+		for (auto h = std::begin(heights); h != std::end(heights); ++h)
+		{
+			const size_t height = *h;
+			const size_t width = (size_t)round((height / svgImage->height) * svgImage->width);
+			const float scale = height / svgImage->height;
+			std::vector<unsigned char> dataRGBA(width * height * 4);
+
+			// The old way, one pass over the whole image then flipping it for OpenGL
+			float single = 0;
+			float banded = 0;
+			for (int run = 0; run < SVG_BENCHMARK_RUNS; ++run)
+			{
+				auto start = std::chrono::high_resolution_clock::now();
+				NSVGrasterizer* rast = nsvgCreateRasterizer();
+				nsvgRasterize(rast, svgImage.get(), 0, 0, scale, dataRGBA.data(), (int)width, (int)height, (int)width * 4);
+				nsvgDeleteRasterizer(rast);
+				ImageIO::flipPixelsVert(dataRGBA.data(), width, height);
+				auto middle = std::chrono::high_resolution_clock::now();
+				rasterizeSVG(svgImage.get(), scale, dataRGBA.data(), width, height, getSVGBandCount(height));
+				auto end = std::chrono::high_resolution_clock::now();
+
+				float singleTime = std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count() / 1000.0f;
+				float bandedTime = std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count() / 1000.0f;
+				if (run == 0 || singleTime < single)
+					single = singleTime;
+				if (run == 0 || bandedTime < banded)
+					banded = bandedTime;
+			}
+
+			ss << "  " << path << " " << width << "x" << height << ": single " << single << "ms, banded " << banded << "ms ("
+				<< getSVGBandCount(height) << " bands)\n";
+		}
+	}
+
+	std::cout << ss.str();
+	LOG(LogInfo) << ss.str();
+}
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <string>
+#include <iosfwd>
 #include <memory>
 #include "platform.h"
 #include <mutex>
+#include <atomic>
 #include GLHEADER
 
 class TextureResource;
+struct NSVGimage;
 
 class TextureData
 {
@@ -25,6 +28,11 @@ public:
 	// Read the data into memory if necessary
 	bool load();
 
+	// Fill in the image dimensions from the file header without decoding it, so the
+	// decode itself can be left to the background loader. Returns false if the size
+	// couldn't be determined this way and a full load is needed
+	bool probeSize();
+
 	bool isLoaded();
 
 	// Upload the texture to VRAM if necessary and bind. Returns true if bound ok or
@@ -39,6 +47,13 @@ public:
 
 	// Get the amount of VRAM currenty used by this texture
 	size_t getVRAMUsage();
+	// Get the amount of RAM used by the decoded pixels
+	size_t getRAMUsage();
+
+	// Write the decoded pixels to out, returning false if they aren't in RAM or couldn't be written
+	bool writeRGBA(std::ostream& out);
+	// Read pixels written by writeRGBA
+	bool readRGBA(std::istream& in);
 
 	size_t width();
 	size_t height();
@@ -47,8 +62,28 @@ public:
 	void setSourceSize(float width, float height);
 
 	bool tiled() { return mTile; }
+	bool isScalable() { return mScalable; }
+	// Use the SVG document another texture of the same file has already parsed, if any
+	void shareSVGImage(TextureData* source);
+	const std::string& getPath() const { return mPath; }
+
+	// Marks the calling thread as the background texture loader. Loads that happen on
+	// any other thread had to be waited for and are counted as stalls
+	static void setLoaderThread();
+	static unsigned int getStallCount() { return sStallCount; }
+	static unsigned int getStallTime() { return sStallTime; } // microseconds
+
+	// Time rasterizing the built in SVGs at a few screen heights, single threaded and
+	// banded, and print the results
+	static void benchmarkSVG();
 
 private:
+	// Rasterize an already parsed SVG document at the source size
+	bool initSVG(std::shared_ptr<NSVGimage> svgImage);
+
+	static std::atomic<unsigned int>	sStallCount;
+	static std::atomic<unsigned int>	sStallTime;
+
 	std::mutex		mMutex;
 	bool			mTile;
 	std::string		mPath;
@@ -60,4 +95,5 @@ private:
 	float			mSourceHeight;
 	bool			mScalable;
 	bool			mReloadable;
+	std::shared_ptr<NSVGimage>	mSVGImage;
 };
@@ -1,6 +1,17 @@
 #include "resources/TextureDataManager.h"
 #include "resources/TextureResource.h"
 #include "Settings.h"
+#include "Log.h"
+#include "Util.h"
+#include <algorithm>
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+// Prefetches still waiting for the loader are counted as this big until something has loaded
+// to go by, after that as the average of what has
+#define PREFETCH_DEFAULT_ESTIMATE (512 * 512 * 4)
+// No more than this many prefetches wait for the loader at once, however small they're expected to be
+#define MAX_PREFETCH_QUEUED 16
 
 TextureDataManager::TextureDataManager()
 {
@@ -22,23 +33,60 @@ TextureDataManager::~TextureDataManager()
 	delete mLoader;
 }
 
-std::shared_ptr<TextureData> TextureDataManager::add(const TextureResource* key, bool tiled)
+std::shared_ptr<TextureData> TextureDataManager::add(const TextureResource* key, bool tiled, const std::string& path)
 {
 	remove(key);
-	std::shared_ptr<TextureData> data(new TextureData(tiled));
-	mTextures.push_front(data);
-	mTextureLookup[key] = mTextures.begin();
+
+	// Take over the data if this texture was prefetched, otherwise it'll be loaded from scratch
+	std::shared_ptr<TextureData> data;
+	auto prefetched = mPrefetchLookup.find(PrefetchKeyType(path, tiled));
+	if (prefetched != mPrefetchLookup.end())
+	{
+		data = (*prefetched).second->second;
+		mLoader->remove(data);
+		mPrefetched.erase((*prefetched).second);
+		mPrefetchLookup.erase(prefetched);
+	}
+	else
+	{
+		data = std::shared_ptr<TextureData>(new TextureData(tiled));
+		data->initFromPath(path);
+	}
+
+	addUser(key, data);
 	return data;
 }
 
+void TextureDataManager::addUser(const TextureResource* key, std::shared_ptr<TextureData> data)
+{
+	auto entry = mDataLookup.find(data.get());
+	if (entry != mDataLookup.end())
+	{
+		// Already in the list for another texture, just move it to the top
+		++(*entry).second.second;
+		mTextures.splice(mTextures.begin(), mTextures, (*entry).second.first);
+	}
+	else
+	{
+		mTextures.push_front(data);
+		mDataLookup[data.get()] = std::make_pair(mTextures.begin(), 1);
+	}
+	mTextureLookup[key] = mTextures.begin();
+}
+
 void TextureDataManager::remove(const TextureResource* key)
 {
 	// Find the entry in the list
 	auto it = mTextureLookup.find(key);
 	if (it != mTextureLookup.end())
 	{
-		// Remove the list entry
-		mTextures.erase((*it).second);
+		// Remove the list entry once no other texture shares it
+		auto entry = mDataLookup.find((*it).second->get());
+		if (--(*entry).second.second == 0)
+		{
+			mDataLookup.erase(entry);
+			mTextures.erase((*it).second);
+		}
 		// And the lookup
 		mTextureLookup.erase(it);
 	}
@@ -53,12 +101,8 @@ std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key)
 	if (it != mTextureLookup.end())
 	{
 		tex = *(*it).second;
-		// Remove the list entry
-		mTextures.erase((*it).second);
-		// Put it at the top
-		mTextures.push_front(tex);
-		// Store it back in the lookup
-		mTextureLookup[key] = mTextures.begin();
+		// Put it at the top. The entry may be shared so it's moved rather than recreated
+		mTextures.splice(mTextures.begin(), mTextures, (*it).second);
 
 		// Make sure it's loaded or queued for loading
 		load(tex);
@@ -66,6 +110,14 @@ std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key)
 	return tex;
 }
 
+std::shared_ptr<TextureData> TextureDataManager::find(const TextureResource* key) const
+{
+	auto it = mTextureLookup.find(key);
+	if (it != mTextureLookup.end())
+		return *(*it).second;
+	return nullptr;
+}
+
 bool TextureDataManager::bind(const TextureResource* key)
 {
 	std::shared_ptr<TextureData> tex = get(key);
@@ -105,7 +157,8 @@ void TextureDataManager::load(std::shared_ptr<TextureData> tex, bool block)
 		return;
 	// Not loaded. Make sure there is room
 	size_t size = TextureResource::getTotalMemUsage();
-	size_t max_texture = (size_t)Settings::getInstance()->getInt("MaxVRAM") * 1024 * 1024;
+	static const SettingHandle<int> maxVRAM = Settings::getInstance()->getIntHandle("MaxVRAM");
+	size_t max_texture = (size_t)maxVRAM.get() * 1024 * 1024;
 
 	size_t in = size;
 
@@ -127,7 +180,307 @@ void TextureDataManager::load(std::shared_ptr<TextureData> tex, bool block)
 		tex->load();
 }
 
-TextureLoader::TextureLoader() : mExit(false)
+std::shared_ptr<TextureData> TextureDataManager::rasterizeAt(const TextureResource* key, float width, float height)
+{
+	auto it = mTextureLookup.find(key);
+	if (it == mTextureLookup.end())
+		return nullptr;
+
+	std::shared_ptr<TextureData> current = *(*it).second;
+	if (!current->isScalable())
+	{
+		current->setSourceSize(width, height);
+		return current;
+	}
+
+	SVGRasterKeyType rasterKey(current->getPath(), (int)round(width), (int)round(height), current->tiled());
+	std::shared_ptr<TextureData> data;
+	auto raster = mSVGRasters.find(rasterKey);
+	if (raster != mSVGRasters.end())
+		data = (*raster).second.lock();
+	if (data == current)
+		return current;
+
+	if (data == nullptr)
+	{
+		// First texture wanting this size. Rasters nobody uses any more are forgotten at the same time
+		for (auto r = mSVGRasters.begin(); r != mSVGRasters.end(); )
+		{
+			if ((*r).second.expired())
+				r = mSVGRasters.erase(r);
+			else
+				++r;
+		}
+		data = std::shared_ptr<TextureData>(new TextureData(current->tiled()));
+		data->initFromPath(current->getPath());
+		data->shareSVGImage(current.get());
+		data->setSourceSize(width, height);
+		mSVGRasters[rasterKey] = data;
+	}
+
+	// Leave the old raster alone as other textures may still be showing it
+	remove(key);
+	addUser(key, data);
+	return data;
+}
+
+void TextureDataManager::keepRAM(size_t maxBytes, const std::string& snapshotPath, const std::vector<std::shared_ptr<TextureData> >& unmanaged)
+{
+	mKept.clear();
+	mSnapshotPath.clear();
+
+	// Whatever is still queued waits for restoreRAM(), it would only be decoded while the game runs
+	mLoader->setPaused(true);
+
+	std::ofstream snapshot;
+	if (!snapshotPath.empty())
+	{
+		snapshot.open(snapshotPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (snapshot.is_open())
+			mSnapshotPath = snapshotPath;
+		else
+			LOG(LogWarning) << "Could not create texture snapshot \"" << snapshotPath << "\", keeping textures in RAM";
+	}
+
+	// Everything holding decoded pixels competes for the budget. Textures not managed here are
+	// permanent parts of the UI so they go first, then the managed ones most recently used first,
+	// and prefetches last as nothing is showing those yet
+	std::vector<std::pair<std::shared_ptr<TextureData>, bool> > candidates;
+	for (auto tex : unmanaged)
+		candidates.push_back(std::make_pair(tex, false));
+	for (auto tex : mTextures)
+		candidates.push_back(std::make_pair(tex, false));
+	for (auto entry : mPrefetched)
+		candidates.push_back(std::make_pair(entry.second, true));
+
+	size_t size = 0;
+	size_t snapshotted = 0;
+	for (auto candidate : candidates)
+	{
+		std::shared_ptr<TextureData>& tex = candidate.first;
+		const size_t ram = tex->getRAMUsage();
+		if (ram == 0)
+		{
+			// Nothing to keep, and don't let the loader fill RAM behind the game's back
+			mLoader->remove(tex);
+			if (candidate.second)
+				removePrefetched(tex);
+			continue;
+		}
+		if (size + ram > maxBytes)
+		{
+			tex->releaseRAM();
+			if (candidate.second)
+				removePrefetched(tex);
+			continue;
+		}
+		size += ram;
+
+		bool inSnapshot = false;
+		if (snapshot.is_open())
+		{
+			if (tex->writeRGBA(snapshot))
+			{
+				inSnapshot = true;
+				snapshotted += ram;
+				tex->releaseRAM();
+			}
+			else
+			{
+				// Probably out of space. What's been written so far is still good
+				LOG(LogWarning) << "Texture snapshot \"" << snapshotPath << "\" is full, keeping the rest in RAM";
+				snapshot.close();
+			}
+		}
+		mKept.push_back(std::make_pair(std::weak_ptr<TextureData>(tex), inSnapshot));
+	}
+
+	LOG(LogInfo) << "Keeping textures for after the launch" << Log::field("count", mKept.size()) << Log::field("kb", size / 1024)
+		<< Log::field("snapshot", mSnapshotPath) << Log::field("snapshot_kb", snapshotted / 1024);
+}
+
+void TextureDataManager::restoreRAM()
+{
+	mLoader->setPaused(false);
+
+	if (mKept.empty())
+		return;
+
+	std::ifstream snapshot;
+	if (!mSnapshotPath.empty())
+		snapshot.open(mSnapshotPath.c_str(), std::ios::in | std::ios::binary);
+
+	size_t restored = 0;
+	for (auto kept : mKept)
+	{
+		std::shared_ptr<TextureData> tex = kept.first.lock();
+		if (kept.second)
+		{
+			// The entries have to be read in order even if the texture has gone since
+			if (!snapshot.is_open())
+				continue;
+			TextureData scratch(false);
+			TextureData* target = tex ? tex.get() : &scratch;
+			if (!target->readRGBA(snapshot))
+			{
+				// Anything left will be loaded from disk again when it's used
+				LOG(LogWarning) << "Texture snapshot \"" << mSnapshotPath << "\" is incomplete";
+				snapshot.close();
+				continue;
+			}
+		}
+		if (tex && tex->uploadAndBind())
+			++restored;
+	}
+
+	if (!mSnapshotPath.empty())
+	{
+		snapshot.close();
+		boost::system::error_code ec;
+		boost::filesystem::remove(mSnapshotPath, ec);
+	}
+
+	LOG(LogInfo) << "Restored textures kept over the launch" << Log::field("restored", restored) << Log::field("kept", mKept.size());
+	mKept.clear();
+	mSnapshotPath.clear();
+}
+
+void TextureDataManager::prefetch(const std::vector<std::string>& paths, bool tiled)
+{
+	collectPrefetched();
+
+	// Whatever hasn't loaded yet and isn't wanted any more would only be decoded to be thrown away
+	for (auto it = mPrefetched.begin(); it != mPrefetched.end(); )
+	{
+		if (it->first.second == tiled && !it->second->isLoaded() &&
+			std::find(paths.begin(), paths.end(), it->first.first) == paths.end())
+		{
+			mLoader->remove(it->second);
+			mPrefetchLookup.erase(it->first);
+			it = mPrefetched.erase(it);
+		}
+		else
+			++it;
+	}
+
+	// Backwards, so the most likely ends up at the front of the list and of the loader's queue
+	for (auto path = paths.rbegin(); path != paths.rend(); ++path)
+	{
+		PrefetchKeyType key(*path, tiled);
+		auto it = mPrefetchLookup.find(key);
+		if (it != mPrefetchLookup.end())
+		{
+			// Already prefetched, just mark it as the most recently wanted
+			mPrefetched.splice(mPrefetched.begin(), mPrefetched, (*it).second);
+			continue;
+		}
+
+		std::shared_ptr<TextureData> data(new TextureData(tiled));
+		data->initFromPath(*path);
+		mPrefetched.push_front(std::make_pair(key, data));
+		mPrefetchLookup[key] = mPrefetched.begin();
+		mLoader->prefetch(data);
+	}
+
+	trimPrefetched();
+}
+
+void TextureDataManager::collectPrefetched()
+{
+	std::vector<std::pair<std::weak_ptr<TextureData>, std::string> > done;
+	mLoader->takePrefetched(done);
+	if (done.empty())
+		return;
+
+	for (auto finished : done)
+	{
+		std::shared_ptr<TextureData> data = finished.first.lock();
+		if (data == nullptr)
+			continue;
+		auto it = mPrefetched.begin();
+		while (it != mPrefetched.end() && it->second != data)
+			++it;
+		if (it == mPrefetched.end())
+			continue;
+
+		// Keyed by the path as asked for until now. A texture is added with its canonical path
+		const PrefetchKeyType key(finished.second, it->first.second);
+		if (key.first == it->first.first)
+			continue;
+		mPrefetchLookup.erase(it->first);
+		if (key.first.empty() || mPrefetchLookup.find(key) != mPrefetchLookup.end())
+		{
+			// No such file, or the same one under another name
+			mPrefetched.erase(it);
+			continue;
+		}
+		it->first = key;
+		mPrefetchLookup[key] = it;
+	}
+
+	trimPrefetched();
+}
+
+void TextureDataManager::removePrefetched(const std::shared_ptr<TextureData>& data)
+{
+	for (auto it = mPrefetched.begin(); it != mPrefetched.end(); ++it)
+	{
+		if (it->second == data)
+		{
+			mPrefetchLookup.erase(it->first);
+			mPrefetched.erase(it);
+			return;
+		}
+	}
+}
+
+void TextureDataManager::trimPrefetched()
+{
+	static const SettingHandle<int> prefetchRAM = Settings::getInstance()->getIntHandle("PrefetchRAM");
+	size_t max_prefetch = (size_t)prefetchRAM.get() * 1024 * 1024;
+
+	size_t loadedSize = 0;
+	size_t loadedCount = 0;
+	for (auto entry : mPrefetched)
+	{
+		const size_t size = entry.second->getVRAMUsage();
+		if (size != 0)
+		{
+			loadedSize += size;
+			++loadedCount;
+		}
+	}
+	const size_t estimate = loadedCount != 0 ? loadedSize / loadedCount : PREFETCH_DEFAULT_ESTIMATE;
+
+	// Drop the least recently wanted textures until everything, loaded or on its way, fits in the budget
+	size_t size = 0;
+	size_t queued = 0;
+	for (auto it = mPrefetched.begin(); it != mPrefetched.end(); )
+	{
+		size_t entrySize = it->second->getVRAMUsage();
+		const bool pending = entrySize == 0;
+		if (pending)
+		{
+			entrySize = estimate;
+			++queued;
+		}
+		size += entrySize;
+		if (size <= max_prefetch && queued <= MAX_PREFETCH_QUEUED)
+		{
+			++it;
+			continue;
+		}
+		mLoader->remove(it->second);
+		mPrefetchLookup.erase(it->first);
+		it = mPrefetched.erase(it);
+		// A smaller one further down may still fit
+		size -= entrySize;
+		if (pending)
+			--queued;
+	}
+}
+
+TextureLoader::TextureLoader() : mExit(false), mPaused(false)
 {
 	mThread = new std::thread(&TextureLoader::threadProc, this);
 }
@@ -135,8 +488,14 @@ TextureLoader::TextureLoader() : mExit(false)
 TextureLoader::~TextureLoader()
 {
 	// Just abort any waiting texture
-	mTextureDataQ.clear();
-	mTextureDataLookup.clear();
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mTextureDataQ.clear();
+		mTextureDataLookup.clear();
+		mPrefetchQ.clear();
+		mPrefetchLookup.clear();
+		mPrefetchDone.clear();
+	}
 
 	// Exit the thread
 	mExit = true;
@@ -147,38 +506,79 @@ TextureLoader::~TextureLoader()
 
 void TextureLoader::threadProc()
 {
+	TextureData::setLoaderThread();
 	while (!mExit)
 	{
 		std::shared_ptr<TextureData> textureData;
+		bool prefetched = false;
 		{
 			// Wait for an event to say there is something in the queue
 			std::unique_lock<std::mutex> lock(mMutex);
-			mEvent.wait(lock);
-			if (!mTextureDataQ.empty())
-			{
-				textureData = mTextureDataQ.front();
-				mTextureDataQ.pop_front();
-				mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
-			}
+			if ((mTextureDataQ.empty() && mPrefetchQ.empty()) || mPaused)
+				mEvent.wait(lock);
+			textureData = popNext(prefetched);
 		}
 		// Queue has been released here but we might have a texture to process
 		while (textureData)
 		{
-			textureData->load();
+			if (prefetched)
+			{
+				// Prefetched paths come straight from the gamelist and may not exist
+				std::string path;
+				if (ResourceManager::getInstance()->fileExists(textureData->getPath()))
+				{
+					path = getCanonicalPath(textureData->getPath());
+					textureData->load();
+				}
+				std::unique_lock<std::mutex> lock(mMutex);
+				mPrefetchDone.push_back(std::make_pair(std::weak_ptr<TextureData>(textureData), path));
+			}
+			else
+			{
+				textureData->load();
+			}
 
 			// See if there is another item in the queue
 			textureData = nullptr;
 			std::unique_lock<std::mutex> lock(mMutex);
-			if (!mTextureDataQ.empty())
-			{
-				textureData = mTextureDataQ.front();
-				mTextureDataQ.pop_front();
-				mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
-			}
+			textureData = popNext(prefetched);
 		}
 	}
 }
 
+std::shared_ptr<TextureData> TextureLoader::popNext(bool& prefetched)
+{
+	// Must be called with mMutex held. Requested textures always go before prefetched ones
+	std::shared_ptr<TextureData> textureData;
+	prefetched = false;
+	if (mPaused)
+		return textureData;
+	if (!mTextureDataQ.empty())
+	{
+		textureData = mTextureDataQ.front();
+		mTextureDataQ.pop_front();
+		mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
+	}
+	else if (!mPrefetchQ.empty())
+	{
+		textureData = mPrefetchQ.front();
+		mPrefetchQ.pop_front();
+		mPrefetchLookup.erase(mPrefetchLookup.find(textureData.get()));
+		prefetched = true;
+	}
+	return textureData;
+}
+
+void TextureLoader::setPaused(bool paused)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mPaused = paused;
+	}
+	if (!paused)
+		mEvent.notify_one();
+}
+
 void TextureLoader::load(std::shared_ptr<TextureData> textureData)
 {
 	// Make sure it's not already loaded
@@ -192,6 +592,13 @@ void TextureLoader::load(std::shared_ptr<TextureData> textureData)
 			mTextureDataQ.erase((*td).second);
 			mTextureDataLookup.erase(td);
 		}
+		// Or from the prefetch queue, as it's now actually wanted
+		td = mPrefetchLookup.find(textureData.get());
+		if (td != mPrefetchLookup.end())
+		{
+			mPrefetchQ.erase((*td).second);
+			mPrefetchLookup.erase(td);
+		}
 
 		// Put it on the start of the queue as we want the newly requested textures to load first
 		mTextureDataQ.push_front(textureData);
@@ -200,6 +607,22 @@ void TextureLoader::load(std::shared_ptr<TextureData> textureData)
 	}
 }
 
+void TextureLoader::prefetch(std::shared_ptr<TextureData> textureData)
+{
+	if (!textureData->isLoaded())
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mPrefetchLookup.find(textureData.get()) != mPrefetchLookup.end() ||
+			mTextureDataLookup.find(textureData.get()) != mTextureDataLookup.end())
+			return;
+
+		// Newest predictions are the most likely to be needed so they go first
+		mPrefetchQ.push_front(textureData);
+		mPrefetchLookup[textureData.get()] = mPrefetchQ.begin();
+		mEvent.notify_one();
+	}
+}
+
 void TextureLoader::remove(std::shared_ptr<TextureData> textureData)
 {
 	// Just remove it from the queue so we don't attempt to load it
@@ -210,6 +633,18 @@ void TextureLoader::remove(std::shared_ptr<TextureData> textureData)
 		mTextureDataQ.erase((*td).second);
 		mTextureDataLookup.erase(td);
 	}
+	td = mPrefetchLookup.find(textureData.get());
+	if (td != mPrefetchLookup.end())
+	{
+		mPrefetchQ.erase((*td).second);
+		mPrefetchLookup.erase(td);
+	}
+}
+
+void TextureLoader::takePrefetched(std::vector<std::pair<std::weak_ptr<TextureData>, std::string> >& done)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	done.swap(mPrefetchDone);
 }
 
 size_t TextureLoader::getQueueSize()
@@ -9,6 +9,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <tuple>
+#include <vector>
 
 class TextureResource;
 
@@ -19,21 +21,34 @@ public:
 	~TextureLoader();
 
 	void load(std::shared_ptr<TextureData> textureData);
+	// Queue a texture at low priority. It is only loaded once the normal queue is empty
+	void prefetch(std::shared_ptr<TextureData> textureData);
 	void remove(std::shared_ptr<TextureData> textureData);
+	// Hands over the prefetches finished since the last call, each with the canonical path of
+	// its file (empty if there's no such file)
+	void takePrefetched(std::vector<std::pair<std::weak_ptr<TextureData>, std::string> >& done);
 
 	size_t getQueueSize();
 
+	// While paused nothing more is loaded, the queues are kept for when it's resumed
+	void setPaused(bool paused);
+
 private:
 	void processQueue();
 	void threadProc();
+	std::shared_ptr<TextureData> popNext(bool& prefetched);
 
 	std::list<std::shared_ptr<TextureData> > 										mTextureDataQ;
 	std::map<TextureData*, std::list<std::shared_ptr<TextureData> >::iterator > 	mTextureDataLookup;
+	std::list<std::shared_ptr<TextureData> > 										mPrefetchQ;
+	std::map<TextureData*, std::list<std::shared_ptr<TextureData> >::iterator > 	mPrefetchLookup;
+	std::vector<std::pair<std::weak_ptr<TextureData>, std::string> >				mPrefetchDone;
 
 	std::thread*				mThread;
 	std::mutex					mMutex;
 	std::condition_variable		mEvent;
 	bool 						mExit;
+	bool						mPaused;
 };
 
 //
@@ -50,13 +65,24 @@ private:
 // to releaseRAM() which frees the memory buffer if the texture can be reloaded from
 // disk if needed again
 //
+// Textures can also be prefetched by path before anything asks for them. These are
+// loaded in the background at low priority and kept, up to the PrefetchRAM setting,
+// until a texture with the same path is added, which then takes over the loaded data.
+// Prefetches that haven't loaded yet count against the budget at an estimated size,
+// and are dropped as soon as they're no longer among the paths wanted. The loader
+// thread checks the file exists, so asking for a prefetch never touches the disk.
+//
+// SVGs are rasterized at whatever size they are displayed at. Textures showing the same
+// SVG at the same (whole pixel) size share one texture data object, and so one raster,
+// which is kept for as long as any of them still uses it.
+//
 class TextureDataManager
 {
 public:
 	TextureDataManager();
 	~TextureDataManager();
 
-	std::shared_ptr<TextureData> add(const TextureResource* key, bool tiled);
+	std::shared_ptr<TextureData> add(const TextureResource* key, bool tiled, const std::string& path);
 
 	// The texturedata being removed may be loading in a different thread. However it will
 	// be referenced by a smart point so we only need to remove it from our array and it
@@ -64,6 +90,8 @@ public:
 	void remove(const TextureResource* key);
 
 	std::shared_ptr<TextureData> get(const TextureResource* key);
+	// The texture data of key as it is, without loading it or counting it as used
+	std::shared_ptr<TextureData> find(const TextureResource* key) const;
 	bool bind(const TextureResource* key);
 
 	// Get the total size of all textures managed by this object, loaded and unloaded in bytes
@@ -75,11 +103,48 @@ public:
 	size_t  getQueueSize();
 	// Load a texture, freeing resources as necessary to make space
 	void load(std::shared_ptr<TextureData> tex, bool block = false);
+	// Start loading these textures in the background in case they are needed soon, most
+	// likely first. Earlier prefetches not in paths stop loading, loaded ones are kept
+	void prefetch(const std::vector<std::string>& paths, bool tiled);
+	// Account for prefetches the loader has finished since the last call. Called every frame
+	void collectPrefetched();
+	// Set the size a scalable texture is rasterized at. The texture switches to the shared
+	// raster of that size (nothing is rasterized here, that's left to the loader) and the
+	// texture data now in use is returned
+	std::shared_ptr<TextureData> rasterizeAt(const TextureResource* key, float width, float height);
+
+	// About to lose the GL context for a while (launching a game). Keep the decoded pixels of
+	// the most recently used textures, up to maxBytes, and free the rest. unmanaged are the
+	// textures not loaded through this class, which count against maxBytes first, prefetched
+	// ones count last. If snapshotPath isn't empty the kept pixels are moved out to that file
+	// until restoreRAM(). The loader is paused until then too, so nothing is decoded during the launch
+	void keepRAM(size_t maxBytes, const std::string& snapshotPath, const std::vector<std::shared_ptr<TextureData> >& unmanaged);
+	// Bring back a snapshot taken by keepRAM(), upload everything kept to VRAM in one go and resume the loader
+	void restoreRAM();
 
 private:
+	typedef std::list<std::shared_ptr<TextureData> > TextureListType;
+
+	void trimPrefetched();
+	void removePrefetched(const std::shared_ptr<TextureData>& data);
+	// Point key at data, sharing the list entry with any other texture already using it
+	void addUser(const TextureResource* key, std::shared_ptr<TextureData> data);
+
+	typedef std::pair<std::string, bool> PrefetchKeyType;
+	std::list<std::pair<PrefetchKeyType, std::shared_ptr<TextureData> > >								mPrefetched;
+	std::map<PrefetchKeyType, std::list<std::pair<PrefetchKeyType, std::shared_ptr<TextureData> > >::iterator >	mPrefetchLookup;
+
+	TextureListType																			mTextures;
+	std::map<const TextureResource*, TextureListType::iterator > 							mTextureLookup;
+	// Entry in mTextures for each texture data and the number of textures using it
+	std::map<const TextureData*, std::pair<TextureListType::iterator, int> >				mDataLookup;
+
+	typedef std::tuple<std::string, int, int, bool> SVGRasterKeyType;
+	std::map<SVGRasterKeyType, std::weak_ptr<TextureData> >									mSVGRasters;
 
-	std::list<std::shared_ptr<TextureData> >												mTextures;
-	std::map<const TextureResource*, std::list<std::shared_ptr<TextureData> >::iterator > 	mTextureLookup;
+	// Textures kept by keepRAM(), and whether their pixels are in the snapshot
+	std::vector<std::pair<std::weak_ptr<TextureData>, bool> >								mKept;
+	std::string																				mSnapshotPath;
 	std::shared_ptr<TextureData>															mBlank;
 	TextureLoader*																			mLoader;
 };
@@ -6,10 +6,13 @@
 #include "Renderer.h"
 #include "Util.h"
 #include "Settings.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
 
 TextureDataManager		TextureResource::sTextureDataManager;
 std::map< TextureResource::TextureKeyType, std::weak_ptr<TextureResource> > TextureResource::sTextureMap;
 std::set<TextureResource*> 	TextureResource::sAllTextures;
+bool						TextureResource::sKeepRAM = false;
 
 TextureResource::TextureResource(const std::string& path, bool tile, bool dynamic) : mTextureData(nullptr), mForceLoad(false)
 {
@@ -21,10 +24,11 @@ TextureResource::TextureResource(const std::string& path, bool tile, bool dynami
 		std::shared_ptr<TextureData> data;
 		if (dynamic)
 		{
-			data = sTextureDataManager.add(this, tile);
-			data->initFromPath(path);
-			// Force the texture manager to load it using a blocking load
-			sTextureDataManager.load(data, true);
+			data = sTextureDataManager.add(this, tile, path);
+			// We only need the size for now, the pixels get decoded by the loader when the
+			// texture is first used. Fall back to a blocking load for formats we can't probe
+			if (!data->isLoaded() && !data->probeSize())
+				sTextureDataManager.load(data, true);
 		}
 		else
 		{
@@ -149,17 +153,56 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 	return tex;
 }
 
+void TextureResource::prefetch(const std::vector<std::string>& paths, bool tile)
+{
+	static const SettingHandle<int> prefetchRAM = Settings::getInstance()->getIntHandle("PrefetchRAM");
+	if(prefetchRAM.get() <= 0)
+		return;
+
+	// This runs on every cursor move so nothing here touches the disk, the loader checks the files exist
+	std::vector<std::string> wanted;
+	for(auto it = paths.begin(); it != paths.end(); it++)
+	{
+		const std::string& path = *it;
+
+		// SVGs are rasterized at whatever size they end up displayed at, so there's nothing useful to load early
+		if(path.size() < 4 || path.substr(path.size() - 4, std::string::npos) == ".svg")
+			continue;
+
+		// already in use
+		auto foundTexture = sTextureMap.find(TextureKeyType(path, tile));
+		if(foundTexture != sTextureMap.end() && !foundTexture->second.expired())
+			continue;
+
+		if(std::find(wanted.begin(), wanted.end(), path) == wanted.end())
+			wanted.push_back(path);
+	}
+
+	sTextureDataManager.prefetch(wanted, tile);
+}
+
+void TextureResource::collectPrefetched()
+{
+	sTextureDataManager.collectPrefetched();
+}
+
 // For scalable source images in textures we want to set the resolution to rasterize at
 void TextureResource::rasterizeAt(size_t width, size_t height)
 {
 	std::shared_ptr<TextureData> data;
 	if (mTextureData != nullptr)
+	{
 		data = mTextureData;
+		data->setSourceSize((float)width, (float)height);
+	}
 	else
-		data = sTextureDataManager.get(this);
+	{
+		data = sTextureDataManager.rasterizeAt(this, (float)width, (float)height);
+	}
 	mSourceSize << (float)width, (float)height;
-	data->setSourceSize((float)width, (float)height);
-	if (mForceLoad || (mTextureData != nullptr))
+	// Managed textures get rasterized by the loader when they're first drawn. Only force
+	// loaded ones (like the splash screen) have to be ready straight away
+	if (data && (mForceLoad || (mTextureData != nullptr)) && !data->isLoaded())
 		data->load();
 }
 
@@ -203,23 +246,70 @@ size_t TextureResource::getTotalTextureSize()
 	return total;
 }
 
+void TextureResource::keepForLaunch(size_t maxBytes, bool snapshot)
+{
+	std::string snapshotPath;
+	if (snapshot)
+	{
+		// /dev/shm is tmpfs on pretty much every Linux, elsewhere the temp directory is the best guess
+		boost::system::error_code ec;
+		boost::filesystem::path dir("/dev/shm");
+		if (!boost::filesystem::is_directory(dir, ec))
+			dir = boost::filesystem::temp_directory_path(ec);
+		if (!ec)
+			snapshotPath = (dir / "emulationstation-textures.bin").generic_string();
+	}
+
+	std::vector<std::shared_ptr<TextureData> > unmanaged;
+	for (auto tex : sAllTextures)
+	{
+		if (tex->mTextureData != nullptr)
+			unmanaged.push_back(tex->mTextureData);
+	}
+
+	sKeepRAM = true;
+	sTextureDataManager.keepRAM(maxBytes, snapshotPath, unmanaged);
+}
+
+void TextureResource::restoreKept()
+{
+	if (!sKeepRAM)
+		return;
+
+	sKeepRAM = false;
+	sTextureDataManager.restoreRAM();
+
+	// Unmanaged textures that didn't fit weren't reloaded with the rest, see reload()
+	for (auto tex : sAllTextures)
+	{
+		if (tex->mTextureData != nullptr && !tex->mTextureData->isLoaded())
+			tex->mTextureData->load();
+	}
+}
+
 void TextureResource::unload(std::shared_ptr<ResourceManager>& rm)
 {
-	// Release the texture's resources
+	// Release the texture's resources. Managed data is only looked up, get() would queue it to be
+	// loaded again, and when launching a game that means decoding everything keepRAM() just freed
 	std::shared_ptr<TextureData> data;
 	if (mTextureData == nullptr)
-		data = sTextureDataManager.get(this);
+		data = sTextureDataManager.find(this);
 	else
 		data = mTextureData;
+	if (data == nullptr)
+		return;
 
 	data->releaseVRAM();
-	data->releaseRAM();
+	// Launching a game, the manager already freed what shouldn't be kept, managed or not
+	if (!sKeepRAM)
+		data->releaseRAM();
 }
 
 void TextureResource::reload(std::shared_ptr<ResourceManager>& rm)
 {
 	// For dynamically loaded textures the texture manager will load them on demand.
-	// For manually loaded textures we have to reload them here
-	if (mTextureData)
+	// For manually loaded textures we have to reload them here, unless back from a launch
+	// where restoreKept() brings back the kept ones and then loads the rest
+	if (mTextureData && !sKeepRAM)
 		mTextureData->load();
 }
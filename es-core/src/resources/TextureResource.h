@@ -17,6 +17,11 @@ class TextureResource : public IReloadable
 {
 public:
 	static std::shared_ptr<TextureResource> get(const std::string& path, bool tile = false, bool forceLoad = false, bool dynamic = true);
+	// Loads the images at paths (most likely to be needed first) in the background so a later get() for
+	// them doesn't have to wait. Replaces the previous call's paths, those still waiting aren't loaded
+	static void prefetch(const std::vector<std::string>& paths, bool tile = false);
+	// Keeps prefetching within its budget as loads finish. Called once a frame
+	static void collectPrefetched();
 	void initFromPixels(const unsigned char* dataRGBA, size_t width, size_t height);
 	virtual void initFromMemory(const char* file, size_t length);
 
@@ -35,6 +40,14 @@ public:
 	static size_t getTotalMemUsage(); // returns an approximation of total VRAM used by textures (in bytes)
 	static size_t getTotalTextureSize(); // returns the number of bytes that would be used if all textures were in memory
 
+	// Call before the renderer goes away to launch a game. The next unload only frees VRAM, keeping up to
+	// maxBytes of decoded images (most recently used first) to upload straight away afterwards. With
+	// snapshot set they're parked in a tmpfs file instead, so the game gets the memory back meanwhile.
+	// Nothing is loaded until restoreKept(), maxBytes may be 0 just for that
+	static void keepForLaunch(size_t maxBytes, bool snapshot);
+	// Upload whatever keepForLaunch() kept. Does nothing if it wasn't called
+	static void restoreKept();
+
 protected:
 	TextureResource(const std::string& path, bool tile, bool dynamic);
 	virtual void unload(std::shared_ptr<ResourceManager>& rm);
@@ -55,4 +68,5 @@ private:
 	typedef std::pair<std::string, bool> TextureKeyType;
 	static std::map< TextureKeyType, std::weak_ptr<TextureResource> > sTextureMap; // map of textures, used to prevent duplicate textures
 	static std::set<TextureResource*> 	sAllTextures;	// Set of all textures, used for memory management
+	static bool							sKeepRAM;		// Set between keepForLaunch() and restoreKept()
 };